@@ -0,0 +1,281 @@
+#pragma once
+
+#include "reflect.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+// Memberwise arithmetic on records of numbers, e.g. tsmp::arith::add(a, b) adds every field of b to the field of a.
+// Fields are arithmetic types or nested records of them. Records whose fields all have the same type and no padding,
+// like struct { float x, y, z, w; }, are processed as one flat array of that type by the span overloads, which the
+// compiler turns into packed SIMD loops. Other records are processed field by field.
+
+namespace tsmp {
+
+namespace detail {
+
+template<class T>
+concept arith_record =
+    reflect<T>::reflectable && !Arithmetic<T> && std::tuple_size_v<decltype(reflect<T>::fields())> > 0;
+
+template<class T>
+struct arith_leaves;
+
+template<class T>
+    requires Arithmetic<T>
+struct arith_leaves<T>
+{
+    static constexpr std::size_t count = 1;
+    using scalar = T;
+    static constexpr bool homogeneous = true;
+};
+
+template<class Fields>
+struct arith_field_leaves;
+
+template<class First, class... Rest>
+struct arith_field_leaves<std::tuple<First, Rest...>>
+{
+    using scalar = typename arith_leaves<typename First::value_type>::scalar;
+    static constexpr std::size_t count =
+        (arith_leaves<typename First::value_type>::count + ... + arith_leaves<typename Rest::value_type>::count);
+    static constexpr bool homogeneous =
+        (arith_leaves<typename First::value_type>::homogeneous && ... &&
+         (arith_leaves<typename Rest::value_type>::homogeneous &&
+          std::is_same_v<typename arith_leaves<typename Rest::value_type>::scalar, scalar>));
+};
+
+// number of arithmetic fields of a record and whether they all have the same type
+template<arith_record T>
+struct arith_leaves<T> : arith_field_leaves<decltype(reflect<T>::fields())>
+{};
+
+// records that have the layout of an array of scalars
+template<class T>
+inline constexpr bool arith_flat = arith_record<T> && arith_leaves<T>::homogeneous && std::is_trivially_copyable_v<T> &&
+                                   sizeof(T) == arith_leaves<T>::count * sizeof(typename arith_leaves<T>::scalar);
+
+template<class T, class Op>
+constexpr void arith_memberwise(T& target, const T& source, Op& op)
+{
+    if constexpr (Arithmetic<T>) {
+        op(target, source);
+    } else {
+        static_assert(arith_record<T>, "Memberwise arithmetic needs arithmetic fields or nested records of them.");
+        std::apply([&](const auto&... decls) { (arith_memberwise(target.*decls.ptr, source.*decls.ptr, op), ...); },
+                   reflect<T>::fields());
+    }
+}
+
+template<class T, class Op>
+constexpr void arith_memberwise(T& target, Op& op)
+{
+    if constexpr (Arithmetic<T>) {
+        op(target);
+    } else {
+        static_assert(arith_record<T>, "Memberwise arithmetic needs arithmetic fields or nested records of them.");
+        std::apply([&](const auto&... decls) { (arith_memberwise(target.*decls.ptr, op), ...); }, reflect<T>::fields());
+    }
+}
+
+// multiplies in the field type for floating point fields, so that float records stay float
+template<Arithmetic V, Arithmetic S>
+[[nodiscard]] constexpr V arith_multiply(V value, S factor) noexcept
+{
+    if constexpr (std::floating_point<V>) {
+        return value * static_cast<V>(factor);
+    } else {
+        return static_cast<V>(value * factor);
+    }
+}
+
+struct arith_add_op
+{
+    template<class V>
+    constexpr void operator()(V& target, const V& source) const noexcept
+    {
+        target = static_cast<V>(target + source);
+    }
+};
+
+struct arith_sub_op
+{
+    template<class V>
+    constexpr void operator()(V& target, const V& source) const noexcept
+    {
+        target = static_cast<V>(target - source);
+    }
+};
+
+template<class S>
+struct arith_scale_op
+{
+    S factor;
+
+    template<class V>
+    constexpr void operator()(V& target) const noexcept
+    {
+        target = arith_multiply(target, factor);
+    }
+};
+
+template<class S>
+struct arith_fma_op
+{
+    S factor;
+
+    template<class V>
+    constexpr void operator()(V& target, const V& source) const noexcept
+    {
+        target = static_cast<V>(target + arith_multiply(source, factor));
+    }
+};
+
+template<class T>
+[[nodiscard]] auto* arith_scalars(std::span<T> values) noexcept
+{
+    using scalar = std::conditional_t<std::is_const_v<T>,
+                                      const typename arith_leaves<std::remove_const_t<T>>::scalar,
+                                      typename arith_leaves<std::remove_const_t<T>>::scalar>;
+    return reinterpret_cast<scalar*>(values.data());
+}
+
+template<class T, class Op>
+void arith_binary(std::span<T> targets, std::span<const T> sources, Op op)
+{
+    if (targets.size() != sources.size()) {
+        throw std::out_of_range("Memberwise arithmetic needs spans of the same size.");
+    }
+    if constexpr (arith_flat<T>) {
+        auto* target = arith_scalars(targets);
+        const auto* source = arith_scalars(sources);
+        const auto size = targets.size() * arith_leaves<T>::count;
+        for (std::size_t i = 0; i < size; ++i) {
+            op(target[i], source[i]);
+        }
+    } else {
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            arith_memberwise(targets[i], sources[i], op);
+        }
+    }
+}
+
+}
+
+namespace arith {
+
+template<class T>
+[[nodiscard]] constexpr T add(T lhs, const T& rhs)
+{
+    detail::arith_add_op op;
+    detail::arith_memberwise(lhs, rhs, op);
+    return lhs;
+}
+
+template<class T>
+[[nodiscard]] constexpr T sub(T lhs, const T& rhs)
+{
+    detail::arith_sub_op op;
+    detail::arith_memberwise(lhs, rhs, op);
+    return lhs;
+}
+
+template<class T, Arithmetic S>
+[[nodiscard]] constexpr T scale(T value, S factor)
+{
+    detail::arith_scale_op<S> op{factor};
+    detail::arith_memberwise(value, op);
+    return value;
+}
+
+// lhs + rhs * factor
+template<class T, Arithmetic S>
+[[nodiscard]] constexpr T fma(T lhs, const T& rhs, S factor)
+{
+    detail::arith_fma_op<S> op{factor};
+    detail::arith_memberwise(lhs, rhs, op);
+    return lhs;
+}
+
+// from + (to - from) * t
+template<class T, Arithmetic S>
+[[nodiscard]] constexpr T lerp(const T& from, const T& to, S t)
+{
+    return fma(from, sub(to, from), t);
+}
+
+// targets[i] += sources[i]
+template<class T>
+void add(std::span<T> targets, std::span<const T> sources)
+{
+    detail::arith_binary(targets, sources, detail::arith_add_op{});
+}
+
+// targets[i] -= sources[i]
+template<class T>
+void sub(std::span<T> targets, std::span<const T> sources)
+{
+    detail::arith_binary(targets, sources, detail::arith_sub_op{});
+}
+
+// targets[i] += sources[i] * factor
+template<class T, Arithmetic S>
+void fma(std::span<T> targets, std::span<const T> sources, S factor)
+{
+    detail::arith_binary(targets, sources, detail::arith_fma_op<S>{factor});
+}
+
+// values[i] *= factor
+template<class T, Arithmetic S>
+void scale(std::span<T> values, S factor)
+{
+    detail::arith_scale_op<S> op{factor};
+    if constexpr (detail::arith_flat<T>) {
+        auto* scalars = detail::arith_scalars(values);
+        const auto size = values.size() * detail::arith_leaves<T>::count;
+        for (std::size_t i = 0; i < size; ++i) {
+            op(scalars[i]);
+        }
+    } else {
+        for (auto& value : values) {
+            detail::arith_memberwise(value, op);
+        }
+    }
+}
+
+// Memberwise sum of all values.
+template<class T>
+[[nodiscard]] T accumulate(std::span<const T> values)
+{
+    if constexpr (detail::arith_flat<T>) {
+        // one accumulator per field, so the additions of a record map to the lanes of one vector register
+        constexpr auto width = detail::arith_leaves<T>::count;
+        std::array<typename detail::arith_leaves<T>::scalar, width> sums{};
+        const auto* scalars = detail::arith_scalars(values);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            for (std::size_t lane = 0; lane < width; ++lane) {
+                sums[lane] += scalars[i * width + lane];
+            }
+        }
+        T result;
+        std::memcpy(&result, sums.data(), sizeof(T));
+        return result;
+    } else {
+        T result{};
+        detail::arith_add_op op;
+        for (const auto& value : values) {
+            detail::arith_memberwise(result, value, op);
+        }
+        return result;
+    }
+}
+
+}
+
+}
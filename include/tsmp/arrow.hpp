@@ -0,0 +1,1302 @@
+#pragma once
+
+#include "reflect.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Apache Arrow IPC file format for ranges of reflected records. The fields of the record become the columns of the
+// schema and map to
+//   bool                  -> Bool
+//   integers              -> Int of the same width and signedness
+//   float, double         -> FloatingPoint
+//   std::string           -> Utf8
+//   enums                 -> Utf8 dictionary with int32 indices
+//   std::optional         -> nullable field with a validity bitmap
+//   reflected records     -> Struct
+// Column buffers are written in native byte order, which is recorded in the schema. The FlatBuffers metadata is
+// produced and parsed by the minimal implementation below, so no Arrow or FlatBuffers library is needed.
+
+namespace tsmp {
+
+inline constexpr std::size_t arrow_default_batch_rows = 1 << 16;
+
+namespace detail {
+
+// Minimal FlatBuffers builder. Like the reference implementation it fills the buffer back to front, so objects are
+// created before the tables referencing them. The bytes are collected in reverse order and an object is identified
+// by its distance from the end of the buffer.
+class flatbuffer_builder_t
+{
+public:
+    using offset_t = std::uint32_t;
+
+    template<class V>
+    void push_scalar(V value)
+    {
+        const auto bits = std::bit_cast<std::array<std::byte, sizeof(V)>>(value);
+        for (std::size_t i = 0; i < sizeof(V); ++i) {
+            reversed.push_back(bits[std::endian::native == std::endian::little ? sizeof(V) - 1 - i : i]);
+        }
+    }
+
+    [[nodiscard]] offset_t create_string(std::string_view value)
+    {
+        align(4, value.size() + 1);
+        reversed.push_back(std::byte{0});
+        for (auto it = value.rbegin(); it != value.rend(); ++it) {
+            reversed.push_back(static_cast<std::byte>(*it));
+        }
+        push_scalar(static_cast<std::uint32_t>(value.size()));
+        return size();
+    }
+
+    // FieldNode, Buffer and Block are structs of 8 byte words (the int32 of Block is padded to 8 bytes)
+    template<std::size_t N>
+    [[nodiscard]] offset_t create_struct_vector(std::span<const std::array<std::int64_t, N>> elements)
+    {
+        align(8, elements.size() * N * 8);
+        for (auto element = elements.rbegin(); element != elements.rend(); ++element) {
+            for (auto word = element->rbegin(); word != element->rend(); ++word) {
+                push_scalar(*word);
+            }
+        }
+        push_scalar(static_cast<std::uint32_t>(elements.size()));
+        return size();
+    }
+
+    [[nodiscard]] offset_t create_offset_vector(std::span<const offset_t> elements)
+    {
+        align(4, elements.size() * 4);
+        for (auto element = elements.rbegin(); element != elements.rend(); ++element) {
+            push_offset(*element);
+        }
+        push_scalar(static_cast<std::uint32_t>(elements.size()));
+        return size();
+    }
+
+    void start_table()
+    {
+        table_start = size();
+        table_fields.clear();
+    }
+
+    template<class V>
+    void add_scalar(std::uint16_t field, V value)
+    {
+        align(sizeof(V), 0);
+        push_scalar(value);
+        table_fields.push_back({field, size()});
+    }
+
+    void add_offset(std::uint16_t field, offset_t target)
+    {
+        push_offset(target);
+        table_fields.push_back({field, size()});
+    }
+
+    [[nodiscard]] offset_t end_table()
+    {
+        align(4, 0);
+        push_scalar(std::int32_t{0});
+        const auto table = size();
+        std::uint16_t field_count = 0;
+        for (const auto& [field, position] : table_fields) {
+            field_count = std::max<std::uint16_t>(field_count, static_cast<std::uint16_t>(field + 1));
+        }
+        std::vector<std::uint16_t> entries(field_count, 0);
+        for (const auto& [field, position] : table_fields) {
+            entries[field] = static_cast<std::uint16_t>(table - position);
+        }
+        for (auto entry = entries.rbegin(); entry != entries.rend(); ++entry) {
+            push_scalar(*entry);
+        }
+        push_scalar(static_cast<std::uint16_t>(table - table_start));
+        push_scalar(static_cast<std::uint16_t>(4 + 2 * field_count));
+        patch(table, static_cast<std::int32_t>(size() - table));
+        return table;
+    }
+
+    [[nodiscard]] std::vector<std::byte> finish(offset_t root)
+    {
+        align(8, 4);
+        push_offset(root);
+        return std::vector<std::byte>(reversed.rbegin(), reversed.rend());
+    }
+
+private:
+    struct table_field_t
+    {
+        std::uint16_t field;
+        offset_t position;
+    };
+
+    [[nodiscard]] offset_t size() const noexcept { return static_cast<offset_t>(reversed.size()); }
+
+    // pads so that the next object of the given size starts at a multiple of alignment
+    void align(std::size_t alignment, std::size_t object_size)
+    {
+        while ((reversed.size() + object_size) % alignment != 0) {
+            reversed.push_back(std::byte{0});
+        }
+    }
+
+    void push_offset(offset_t target)
+    {
+        align(4, 0);
+        push_scalar(static_cast<std::uint32_t>(size() + 4 - target));
+    }
+
+    void patch(offset_t object, std::int32_t value)
+    {
+        const auto bits = std::bit_cast<std::array<std::byte, 4>>(value);
+        for (std::size_t i = 0; i < 4; ++i) {
+            reversed[object - 1 - i] = bits[std::endian::native == std::endian::little ? i : 3 - i];
+        }
+    }
+
+    std::vector<std::byte> reversed;
+    offset_t table_start = 0;
+    std::vector<table_field_t> table_fields;
+};
+
+template<class V>
+[[nodiscard]] V read_little_endian(std::span<const std::byte> buffer, std::size_t position)
+{
+    if (position > buffer.size() || buffer.size() - position < sizeof(V)) {
+        throw std::runtime_error("Arrow metadata is out of bounds.");
+    }
+    std::array<std::byte, sizeof(V)> bits;
+    std::memcpy(bits.data(), buffer.data() + position, sizeof(V));
+    if constexpr (std::endian::native == std::endian::big) {
+        std::ranges::reverse(bits);
+    }
+    return std::bit_cast<V>(bits);
+}
+
+// Read access to a FlatBuffers table with bounds checks on every step.
+class flatbuffer_table_t
+{
+public:
+    flatbuffer_table_t(std::span<const std::byte> buffer, std::size_t position)
+        : buffer(buffer)
+        , position(position)
+    {
+        const auto vtable_offset = read_little_endian<std::int32_t>(buffer, position);
+        const auto vtable_position = static_cast<std::int64_t>(position) - vtable_offset;
+        if (vtable_position < 0 || static_cast<std::uint64_t>(vtable_position) >= buffer.size()) {
+            throw std::runtime_error("Arrow metadata is out of bounds.");
+        }
+        vtable = static_cast<std::size_t>(vtable_position);
+        vtable_size = read_little_endian<std::uint16_t>(buffer, vtable);
+    }
+
+    [[nodiscard]] static flatbuffer_table_t root(std::span<const std::byte> buffer)
+    {
+        return flatbuffer_table_t(buffer, follow(buffer, 0));
+    }
+
+    template<class V>
+    [[nodiscard]] V scalar(std::uint16_t field, V fallback) const
+    {
+        const auto found = locate(field);
+        return found ? read_little_endian<V>(buffer, *found) : fallback;
+    }
+
+    [[nodiscard]] std::optional<flatbuffer_table_t> table(std::uint16_t field) const
+    {
+        const auto found = locate(field);
+        if (!found) {
+            return std::nullopt;
+        }
+        return flatbuffer_table_t(buffer, follow(buffer, *found));
+    }
+
+    [[nodiscard]] std::string_view string(std::uint16_t field) const
+    {
+        const auto [begin, size] = vector(field, 1);
+        if (begin + size >= buffer.size()) {
+            throw std::runtime_error("Arrow metadata is out of bounds.");
+        }
+        return {reinterpret_cast<const char*>(buffer.data() + begin), size};
+    }
+
+    // position of the first element and element count, an absent vector is empty
+    [[nodiscard]] std::pair<std::size_t, std::size_t> vector(std::uint16_t field, std::size_t element_size) const
+    {
+        const auto found = locate(field);
+        if (!found) {
+            return {0, 0};
+        }
+        const auto target = follow(buffer, *found);
+        const auto size = read_little_endian<std::uint32_t>(buffer, target);
+        if ((buffer.size() - target - 4) / element_size < size) {
+            throw std::runtime_error("Arrow metadata is out of bounds.");
+        }
+        return {target + 4, size};
+    }
+
+    [[nodiscard]] std::vector<flatbuffer_table_t> tables(std::uint16_t field) const
+    {
+        const auto [begin, size] = vector(field, 4);
+        std::vector<flatbuffer_table_t> result;
+        result.reserve(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            result.emplace_back(buffer, follow(buffer, begin + 4 * i));
+        }
+        return result;
+    }
+
+    template<std::size_t N>
+    [[nodiscard]] std::vector<std::array<std::int64_t, N>> structs(std::uint16_t field) const
+    {
+        const auto [begin, size] = vector(field, N * 8);
+        std::vector<std::array<std::int64_t, N>> result(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            for (std::size_t word = 0; word < N; ++word) {
+                result[i][word] = read_little_endian<std::int64_t>(buffer, begin + 8 * (N * i + word));
+            }
+        }
+        return result;
+    }
+
+private:
+    [[nodiscard]] static std::size_t follow(std::span<const std::byte> buffer, std::size_t position)
+    {
+        const auto target = position + read_little_endian<std::uint32_t>(buffer, position);
+        if (target >= buffer.size()) {
+            throw std::runtime_error("Arrow metadata is out of bounds.");
+        }
+        return target;
+    }
+
+    [[nodiscard]] std::optional<std::size_t> locate(std::uint16_t field) const
+    {
+        const std::size_t entry = 4 + 2 * static_cast<std::size_t>(field);
+        if (entry + 2 > vtable_size) {
+            return std::nullopt;
+        }
+        const auto offset = read_little_endian<std::uint16_t>(buffer, vtable + entry);
+        if (offset == 0) {
+            return std::nullopt;
+        }
+        return position + offset;
+    }
+
+    std::span<const std::byte> buffer;
+    std::size_t position;
+    std::size_t vtable = 0;
+    std::uint16_t vtable_size = 0;
+};
+
+// Field ids of the Arrow FlatBuffers schema (Schema.fbs, Message.fbs and File.fbs)
+enum class arrow_type_t : std::uint8_t
+{
+    integer = 2,
+    floating_point = 3,
+    utf8 = 5,
+    boolean = 6,
+    structure = 13
+};
+
+enum class arrow_header_t : std::uint8_t
+{
+    schema = 1,
+    dictionary_batch = 2,
+    record_batch = 3
+};
+
+inline constexpr std::int16_t arrow_metadata_version = 4;
+inline constexpr std::uint32_t arrow_continuation = 0xffffffff;
+inline constexpr std::string_view arrow_magic{"ARROW1\0\0", 8};
+
+[[nodiscard]] constexpr std::size_t arrow_padded(std::size_t size) noexcept
+{
+    return (size + 7) & ~std::size_t{7};
+}
+
+[[nodiscard]] constexpr std::size_t arrow_bitmap_size(std::size_t length) noexcept
+{
+    return (length + 7) / 8;
+}
+
+// Node and buffer list of a record batch, built before the body is written
+struct arrow_body_t
+{
+    std::vector<std::array<std::int64_t, 2>> nodes;
+    std::vector<std::array<std::int64_t, 2>> buffers;
+    std::size_t size = 0;
+
+    void add_buffer(std::size_t length)
+    {
+        buffers.push_back({static_cast<std::int64_t>(size), static_cast<std::int64_t>(length)});
+        size += arrow_padded(length);
+    }
+};
+
+// Hands out the planned buffers of a zero initialised body in order
+struct arrow_body_writer_t
+{
+    std::byte* body;
+    const arrow_body_t& plan;
+    std::size_t next_buffer = 0;
+
+    [[nodiscard]] std::span<std::byte> buffer()
+    {
+        const auto [offset, length] = plan.buffers[next_buffer++];
+        return {body + offset, static_cast<std::size_t>(length)};
+    }
+};
+
+struct arrow_dictionary_column_t
+{
+    std::int64_t id;
+    std::int32_t index_width;
+    bool index_signed;
+};
+
+struct arrow_batch_reader_t
+{
+    std::span<const std::byte> body;
+    std::vector<std::array<std::int64_t, 2>> nodes;
+    std::vector<std::array<std::int64_t, 2>> buffers;
+    std::size_t length;
+    const std::vector<arrow_dictionary_column_t>& dictionary_columns;
+    const std::map<std::int64_t, std::vector<std::string>>& dictionaries;
+    std::size_t next_node = 0;
+    std::size_t next_buffer = 0;
+    std::size_t next_dictionary = 0;
+
+    [[nodiscard]] std::int64_t node()
+    {
+        if (next_node == nodes.size()) {
+            throw std::runtime_error("Arrow record batch has too few field nodes.");
+        }
+        const auto [node_length, null_count] = nodes[next_node++];
+        if (node_length != static_cast<std::int64_t>(length) || null_count < 0 || null_count > node_length) {
+            throw std::runtime_error("Arrow field node does not match the record batch.");
+        }
+        return null_count;
+    }
+
+    // a buffer shorter than minimum_size is an error, except for absent buffers if that is allowed
+    [[nodiscard]] std::span<const std::byte> buffer(std::size_t minimum_size, bool may_be_absent = false)
+    {
+        if (next_buffer == buffers.size()) {
+            throw std::runtime_error("Arrow record batch has too few buffers.");
+        }
+        const auto [offset, size] = buffers[next_buffer++];
+        if (offset < 0 || size < 0 || static_cast<std::uint64_t>(offset) > body.size() ||
+            static_cast<std::uint64_t>(size) > body.size() - static_cast<std::uint64_t>(offset)) {
+            throw std::runtime_error("Arrow buffer is out of bounds.");
+        }
+        if (static_cast<std::size_t>(size) < minimum_size && !(may_be_absent && size == 0)) {
+            throw std::runtime_error("Arrow buffer is too short.");
+        }
+        return body.subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(size));
+    }
+};
+
+[[nodiscard]] inline bool arrow_bit(std::span<const std::byte> bitmap, std::size_t index) noexcept
+{
+    return bitmap.empty() || std::to_integer<unsigned>(bitmap[index / 8] >> (index % 8)) & 1;
+}
+
+inline void arrow_set_bit(std::span<std::byte> bitmap, std::size_t index) noexcept
+{
+    bitmap[index / 8] |= static_cast<std::byte>(1u << (index % 8));
+}
+
+[[nodiscard]] inline flatbuffer_builder_t::offset_t arrow_field(flatbuffer_builder_t& builder,
+                                                              std::string_view name,
+                                                              bool nullable,
+                                                              arrow_type_t type_id,
+                                                              flatbuffer_builder_t::offset_t type,
+                                                              std::span<const flatbuffer_builder_t::offset_t> children,
+                                                              std::optional<flatbuffer_builder_t::offset_t> dictionary)
+{
+    const auto name_offset = builder.create_string(name);
+    const auto children_offset = builder.create_offset_vector(children);
+    builder.start_table();
+    builder.add_offset(0, name_offset);
+    builder.add_scalar(1, static_cast<std::uint8_t>(nullable));
+    builder.add_scalar(2, static_cast<std::uint8_t>(type_id));
+    builder.add_offset(3, type);
+    if (dictionary) {
+        builder.add_offset(4, *dictionary);
+    }
+    builder.add_offset(5, children_offset);
+    return builder.end_table();
+}
+
+[[nodiscard]] inline flatbuffer_builder_t::offset_t arrow_empty_table(flatbuffer_builder_t& builder)
+{
+    builder.start_table();
+    return builder.end_table();
+}
+
+[[nodiscard]] inline flatbuffer_builder_t::offset_t arrow_int_type(flatbuffer_builder_t& builder,
+                                                                 std::int32_t bit_width,
+                                                                 bool is_signed)
+{
+    builder.start_table();
+    builder.add_scalar(0, bit_width);
+    builder.add_scalar(1, static_cast<std::uint8_t>(is_signed));
+    return builder.end_table();
+}
+
+inline void arrow_check_type(const flatbuffer_table_t& field, arrow_type_t expected)
+{
+    if (field.scalar<std::uint8_t>(2, 0) != static_cast<std::uint8_t>(expected) || !field.table(3)) {
+        throw std::runtime_error("Arrow field type does not match the reflected type.");
+    }
+}
+
+// Each codec describes the Arrow type of its value type and moves the values of one column into and out of the
+// record batch body. Nulls are handled by the arrow_*_column functions below, codecs only see present values.
+template<class T>
+struct arrow_codec_t;
+
+template<class T>
+[[nodiscard]] flatbuffer_builder_t::offset_t arrow_schema_field(flatbuffer_builder_t& builder,
+                                                              std::string_view name,
+                                                              std::int64_t& dictionary_id);
+
+template<class T>
+void arrow_check_field(const flatbuffer_table_t& field, std::vector<arrow_dictionary_column_t>& dictionary_columns);
+
+template<class T, class Rows, class Get>
+void arrow_plan_column(arrow_body_t& body, const Rows& rows, Get get);
+
+template<class T, class Rows, class Get>
+void arrow_write_column(arrow_body_writer_t& writer, const Rows& rows, Get get);
+
+template<class T, class Row, class Get>
+void arrow_read_column(arrow_batch_reader_t& reader, std::span<Row> rows, Get get);
+
+template<Arithmetic T>
+struct arrow_codec_t<T>
+{
+    static_assert(!std::floating_point<T> || sizeof(T) == 4 || sizeof(T) == 8,
+                  "Only 32 and 64 bit floating point types are supported.");
+
+    static constexpr arrow_type_t type_id = std::is_same_v<T, bool>  ? arrow_type_t::boolean
+                                            : std::floating_point<T> ? arrow_type_t::floating_point
+                                                                     : arrow_type_t::integer;
+
+    [[nodiscard]] static flatbuffer_builder_t::offset_t field(flatbuffer_builder_t& builder,
+                                                            std::string_view name,
+                                                            bool nullable,
+                                                            std::int64_t&)
+    {
+        flatbuffer_builder_t::offset_t type;
+        if constexpr (std::is_same_v<T, bool>) {
+            type = arrow_empty_table(builder);
+        } else if constexpr (std::floating_point<T>) {
+            builder.start_table();
+            builder.add_scalar(0, static_cast<std::int16_t>(sizeof(T) == 4 ? 1 : 2));
+            type = builder.end_table();
+        } else {
+            type = arrow_int_type(builder, static_cast<std::int32_t>(8 * sizeof(T)), std::is_signed_v<T>);
+        }
+        return arrow_field(builder, name, nullable, type_id, type, {}, std::nullopt);
+    }
+
+    static void check(const flatbuffer_table_t& field, std::vector<arrow_dictionary_column_t>&)
+    {
+        arrow_check_type(field, type_id);
+        const auto type = *field.table(3);
+        if constexpr (std::floating_point<T>) {
+            if (type.scalar<std::int16_t>(0, 0) != (sizeof(T) == 4 ? 1 : 2)) {
+                throw std::runtime_error("Arrow floating point precision does not match the reflected type.");
+            }
+        } else if constexpr (!std::is_same_v<T, bool>) {
+            if (type.scalar<std::int32_t>(0, 0) != static_cast<std::int32_t>(8 * sizeof(T)) ||
+                (type.scalar<std::uint8_t>(1, 0) != 0) != std::is_signed_v<T>) {
+                throw std::runtime_error("Arrow integer type does not match the reflected type.");
+            }
+        }
+    }
+
+    template<class Rows>
+    static void plan(arrow_body_t& body, const Rows& rows)
+    {
+        const auto length = static_cast<std::size_t>(std::ranges::distance(rows));
+        body.add_buffer(std::is_same_v<T, bool> ? arrow_bitmap_size(length) : length * sizeof(T));
+    }
+
+    template<class Rows, class Get>
+    static void write(arrow_body_writer_t& writer, const Rows& rows, Get get)
+    {
+        const auto values = writer.buffer();
+        std::size_t index = 0;
+        for (const auto& row : rows) {
+            if (const T* value = get(row)) {
+                if constexpr (std::is_same_v<T, bool>) {
+                    if (*value) {
+                        arrow_set_bit(values, index);
+                    }
+                } else {
+                    std::memcpy(values.data() + index * sizeof(T), value, sizeof(T));
+                }
+            }
+            ++index;
+        }
+    }
+
+    template<class Row, class Get>
+    static void read(arrow_batch_reader_t& reader, std::span<Row> rows, Get get)
+    {
+        const auto values =
+            reader.buffer(std::is_same_v<T, bool> ? arrow_bitmap_size(rows.size()) : rows.size() * sizeof(T));
+        for (std::size_t index = 0; index < rows.size(); ++index) {
+            if (T* value = get(rows[index])) {
+                if constexpr (std::is_same_v<T, bool>) {
+                    *value = arrow_bit(values, index);
+                } else {
+                    std::memcpy(value, values.data() + index * sizeof(T), sizeof(T));
+                }
+            }
+        }
+    }
+};
+
+template<Enum T>
+struct arrow_codec_t<T>
+{
+    [[nodiscard]] static flatbuffer_builder_t::offset_t field(flatbuffer_builder_t& builder,
+                                                            std::string_view name,
+                                                            bool nullable,
+                                                            std::int64_t& dictionary_id)
+    {
+        const auto index_type = arrow_int_type(builder, 32, true);
+        builder.start_table();
+        builder.add_scalar(0, dictionary_id++);
+        builder.add_offset(1, index_type);
+        builder.add_scalar(2, std::uint8_t{0});
+        const auto dictionary = builder.end_table();
+        const auto type = arrow_empty_table(builder);
+        return arrow_field(builder, name, nullable, arrow_type_t::utf8, type, {}, dictionary);
+    }
+
+    static void check(const flatbuffer_table_t& field, std::vector<arrow_dictionary_column_t>& dictionary_columns)
+    {
+        arrow_check_type(field, arrow_type_t::utf8);
+        const auto dictionary = field.table(4);
+        if (!dictionary) {
+            throw std::runtime_error("Arrow field of an enumeration is not dictionary encoded.");
+        }
+        arrow_dictionary_column_t column{dictionary->scalar<std::int64_t>(0, 0), 32, true};
+        if (const auto index_type = dictionary->table(1)) {
+            column.index_width = index_type->scalar<std::int32_t>(0, 0);
+            column.index_signed = index_type->scalar<std::uint8_t>(1, 0) != 0;
+        }
+        if (column.index_width != 8 && column.index_width != 16 && column.index_width != 32 &&
+            column.index_width != 64) {
+            throw std::runtime_error("Arrow dictionary index type is not supported.");
+        }
+        dictionary_columns.push_back(column);
+    }
+
+    [[nodiscard]] static std::int32_t index(T value)
+    {
+        const auto found = std::ranges::find(enum_values<T>, value);
+        if (found == enum_values<T>.end()) {
+            throw std::runtime_error("Value is not part of enumeration.");
+        }
+        return static_cast<std::int32_t>(found - enum_values<T>.begin());
+    }
+
+    template<class Rows>
+    static void plan(arrow_body_t& body, const Rows& rows)
+    {
+        body.add_buffer(static_cast<std::size_t>(std::ranges::distance(rows)) * sizeof(std::int32_t));
+    }
+
+    template<class Rows, class Get>
+    static void write(arrow_body_writer_t& writer, const Rows& rows, Get get)
+    {
+        const auto indices = writer.buffer();
+        std::size_t position = 0;
+        for (const auto& row : rows) {
+            if (const T* value = get(row)) {
+                const auto value_index = index(*value);
+                std::memcpy(indices.data() + position * sizeof(std::int32_t), &value_index, sizeof(std::int32_t));
+            }
+            ++position;
+        }
+    }
+
+    template<class Row, class Get>
+    static void read(arrow_batch_reader_t& reader, std::span<Row> rows, Get get)
+    {
+        const auto column = reader.dictionary_columns[reader.next_dictionary++];
+        const auto dictionary = reader.dictionaries.find(column.id);
+        if (dictionary == reader.dictionaries.end()) {
+            throw std::runtime_error("Arrow dictionary is missing.");
+        }
+        std::vector<T> values;
+        values.reserve(dictionary->second.size());
+        for (const auto& name : dictionary->second) {
+            values.push_back(enum_from_string<T>(name));
+        }
+
+        const auto width = static_cast<std::size_t>(column.index_width / 8);
+        const auto indices = reader.buffer(rows.size() * width);
+        for (std::size_t position = 0; position < rows.size(); ++position) {
+            if (T* value = get(rows[position])) {
+                std::uint64_t bits = 0;
+                std::memcpy(&bits, indices.data() + position * width, width);
+                if constexpr (std::endian::native == std::endian::big) {
+                    bits >>= 64 - 8 * width;
+                }
+                auto value_index = static_cast<std::int64_t>(bits);
+                if (column.index_signed && width < 8 && (bits >> (8 * width - 1)) != 0) {
+                    value_index -= std::int64_t{1} << (8 * width);
+                }
+                if (value_index < 0 || static_cast<std::uint64_t>(value_index) >= values.size()) {
+                    throw std::runtime_error("Arrow dictionary index is out of range.");
+                }
+                *value = values[static_cast<std::size_t>(value_index)];
+            }
+        }
+    }
+};
+
+template<>
+struct arrow_codec_t<std::string>
+{
+    [[nodiscard]] static flatbuffer_builder_t::offset_t field(flatbuffer_builder_t& builder,
+                                                            std::string_view name,
+                                                            bool nullable,
+                                                            std::int64_t&)
+    {
+        const auto type = arrow_empty_table(builder);
+        return arrow_field(builder, name, nullable, arrow_type_t::utf8, type, {}, std::nullopt);
+    }
+
+    static void check(const flatbuffer_table_t& field, std::vector<arrow_dictionary_column_t>&)
+    {
+        arrow_check_type(field, arrow_type_t::utf8);
+        if (field.table(4)) {
+            throw std::runtime_error("Dictionary encoded Arrow strings are not supported.");
+        }
+    }
+
+    // Get may also return other contiguous character ranges, like the string_view names of enum dictionaries
+    template<class Rows, class Get>
+    static void plan(arrow_body_t& body, const Rows& rows, Get get)
+    {
+        std::size_t length = 0;
+        std::size_t characters = 0;
+        for (const auto& row : rows) {
+            if (const auto* value = get(row)) {
+                characters += value->size();
+            }
+            ++length;
+        }
+        if (characters > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+            throw std::runtime_error("Arrow string column exceeds 2 GiB, use smaller batches.");
+        }
+        body.add_buffer((length + 1) * sizeof(std::int32_t));
+        body.add_buffer(characters);
+    }
+
+    template<class Rows, class Get>
+    static void write(arrow_body_writer_t& writer, const Rows& rows, Get get)
+    {
+        const auto offsets = writer.buffer();
+        const auto characters = writer.buffer();
+        std::int32_t offset = 0;
+        std::size_t index = 0;
+        for (const auto& row : rows) {
+            if (const auto* value = get(row)) {
+                if (!value->empty()) {
+                    std::memcpy(characters.data() + offset, value->data(), value->size());
+                }
+                offset += static_cast<std::int32_t>(value->size());
+            }
+            std::memcpy(offsets.data() + ++index * sizeof(std::int32_t), &offset, sizeof(std::int32_t));
+        }
+    }
+
+    template<class Row, class Get>
+    static void read(arrow_batch_reader_t& reader, std::span<Row> rows, Get get)
+    {
+        const auto offsets = reader.buffer((rows.size() + 1) * sizeof(std::int32_t));
+        const auto characters = reader.buffer(0);
+        const auto offset = [&](std::size_t index) {
+            std::int32_t value;
+            std::memcpy(&value, offsets.data() + index * sizeof(std::int32_t), sizeof(std::int32_t));
+            return value;
+        };
+        for (std::size_t index = 0; index < rows.size(); ++index) {
+            if (std::string* value = get(rows[index])) {
+                const auto begin = offset(index);
+                const auto end = offset(index + 1);
+                if (begin < 0 || end < begin || static_cast<std::size_t>(end) > characters.size()) {
+                    throw std::runtime_error("Arrow string offsets are invalid.");
+                }
+                value->assign(reinterpret_cast<const char*>(characters.data()) + begin,
+                              static_cast<std::size_t>(end - begin));
+            }
+        }
+    }
+};
+
+template<class T>
+struct arrow_codec_t
+{
+    static_assert(!std::ranges::range<T>, "Only std::string is supported as range type in Arrow columns.");
+
+    // stands in for absent records, so the children of a null struct still have a value in every slot
+    [[nodiscard]] static const T& fallback()
+    {
+        static const T value{};
+        return value;
+    }
+
+    [[nodiscard]] static std::vector<flatbuffer_builder_t::offset_t> children(flatbuffer_builder_t& builder,
+                                                                            std::int64_t& dictionary_id)
+    {
+        return std::apply(
+            [&](auto... decls) {
+                return std::vector<flatbuffer_builder_t::offset_t>{
+                    arrow_schema_field<typename decltype(decls)::value_type>(builder, decls.name, dictionary_id)...};
+            },
+            reflect<T>::fields());
+    }
+
+    [[nodiscard]] static flatbuffer_builder_t::offset_t field(flatbuffer_builder_t& builder,
+                                                            std::string_view name,
+                                                            bool nullable,
+                                                            std::int64_t& dictionary_id)
+    {
+        const auto child_fields = children(builder, dictionary_id);
+        const auto type = arrow_empty_table(builder);
+        return arrow_field(builder, name, nullable, arrow_type_t::structure, type, child_fields, std::nullopt);
+    }
+
+    static void check_children(const std::vector<flatbuffer_table_t>& fields,
+                               std::vector<arrow_dictionary_column_t>& dictionary_columns)
+    {
+        if (fields.size() != std::tuple_size_v<decltype(reflect<T>::fields())>) {
+            throw std::runtime_error("Arrow field count does not match the reflected type.");
+        }
+        std::apply(
+            [&](auto... decls) {
+                (
+                    [&] {
+                        if (fields[decls.id].string(0) != decls.name) {
+                            throw std::runtime_error("Arrow field name does not match the reflected type.");
+                        }
+                        arrow_check_field<typename decltype(decls)::value_type>(fields[decls.id],
+                                                                                 dictionary_columns);
+                    }(),
+                    ...);
+            },
+            reflect<T>::fields());
+    }
+
+    static void check(const flatbuffer_table_t& field, std::vector<arrow_dictionary_column_t>& dictionary_columns)
+    {
+        arrow_check_type(field, arrow_type_t::structure);
+        check_children(field.tables(5), dictionary_columns);
+    }
+
+    template<class Rows, class Get>
+    static void plan_children(arrow_body_t& body, const Rows& rows, Get get)
+    {
+        std::apply(
+            [&](auto... decls) {
+                (arrow_plan_column<typename decltype(decls)::value_type>(
+                     body,
+                     rows,
+                     [&, ptr = decls.ptr](const auto& row) {
+                         const T* value = get(row);
+                         return value ? &(value->*ptr) : &(fallback().*ptr);
+                     }),
+                 ...);
+            },
+            reflect<T>::fields());
+    }
+
+    template<class Rows, class Get>
+    static void write(arrow_body_writer_t& writer, const Rows& rows, Get get)
+    {
+        std::apply(
+            [&](auto... decls) {
+                (arrow_write_column<typename decltype(decls)::value_type>(
+                     writer,
+                     rows,
+                     [&, ptr = decls.ptr](const auto& row) {
+                         const T* value = get(row);
+                         return value ? &(value->*ptr) : &(fallback().*ptr);
+                     }),
+                 ...);
+            },
+            reflect<T>::fields());
+    }
+
+    template<class Row, class Get>
+    static void read(arrow_batch_reader_t& reader, std::span<Row> rows, Get get)
+    {
+        std::apply(
+            [&](auto... decls) {
+                (arrow_read_column<typename decltype(decls)::value_type>(
+                     reader,
+                     rows,
+                     [&, ptr = decls.ptr](Row& row) -> typename decltype(decls)::value_type* {
+                         T* value = get(row);
+                         return value ? &(value->*ptr) : nullptr;
+                     }),
+                 ...);
+            },
+            reflect<T>::fields());
+    }
+};
+
+template<class T>
+inline constexpr bool arrow_has_children = !Arithmetic<T> && !Enum<T> && !std::is_same_v<T, std::string>;
+
+template<class T>
+struct arrow_unwrap_t
+{
+    using type = T;
+};
+
+template<is_optional T>
+struct arrow_unwrap_t<T>
+{
+    static_assert(!is_optional<typename T::value_type>, "Nested optionals cannot be represented in Arrow.");
+    using type = typename T::value_type;
+};
+
+template<class T>
+flatbuffer_builder_t::offset_t arrow_schema_field(flatbuffer_builder_t& builder,
+                                                  std::string_view name,
+                                                  std::int64_t& dictionary_id)
+{
+    return arrow_codec_t<typename arrow_unwrap_t<T>::type>::field(builder, name, is_optional<T>, dictionary_id);
+}
+
+template<class T>
+void arrow_check_field(const flatbuffer_table_t& field, std::vector<arrow_dictionary_column_t>& dictionary_columns)
+{
+    arrow_codec_t<typename arrow_unwrap_t<T>::type>::check(field, dictionary_columns);
+}
+
+// Get maps a row to a pointer to its value of this column, a null pointer marks a null slot.
+template<class T, class Rows, class Get>
+void arrow_plan_column(arrow_body_t& body, const Rows& rows, Get get)
+{
+    using value_type = typename arrow_unwrap_t<T>::type;
+    const auto present = [&](const auto& row) -> const value_type* {
+        if constexpr (is_optional<T>) {
+            const T* value = get(row);
+            return value->has_value() ? &**value : nullptr;
+        } else {
+            return get(row);
+        }
+    };
+    std::size_t length = 0;
+    std::size_t null_count = 0;
+    for (const auto& row : rows) {
+        null_count += present(row) == nullptr;
+        ++length;
+    }
+    body.nodes.push_back({static_cast<std::int64_t>(length), static_cast<std::int64_t>(null_count)});
+    body.add_buffer(null_count > 0 ? arrow_bitmap_size(length) : 0);
+    if constexpr (std::is_same_v<value_type, std::string>) {
+        arrow_codec_t<value_type>::plan(body, rows, present);
+    } else if constexpr (arrow_has_children<value_type>) {
+        arrow_codec_t<value_type>::plan_children(body, rows, present);
+    } else {
+        arrow_codec_t<value_type>::plan(body, rows);
+    }
+}
+
+template<class T, class Rows, class Get>
+void arrow_write_column(arrow_body_writer_t& writer, const Rows& rows, Get get)
+{
+    using value_type = typename arrow_unwrap_t<T>::type;
+    const auto present = [&](const auto& row) -> const value_type* {
+        if constexpr (is_optional<T>) {
+            const T* value = get(row);
+            return value->has_value() ? &**value : nullptr;
+        } else {
+            return get(row);
+        }
+    };
+    const auto validity = writer.buffer();
+    if (!validity.empty()) {
+        std::size_t index = 0;
+        for (const auto& row : rows) {
+            if (present(row) != nullptr) {
+                arrow_set_bit(validity, index);
+            }
+            ++index;
+        }
+    }
+    arrow_codec_t<value_type>::write(writer, rows, present);
+}
+
+// Get maps a row to the storage of this column, or to a null pointer if an enclosing optional is empty.
+template<class T, class Row, class Get>
+void arrow_read_column(arrow_batch_reader_t& reader, std::span<Row> rows, Get get)
+{
+    using value_type = typename arrow_unwrap_t<T>::type;
+    const auto null_count = reader.node();
+    const auto validity = reader.buffer(arrow_bitmap_size(rows.size()), null_count == 0);
+    if constexpr (is_optional<T>) {
+        for (std::size_t index = 0; index < rows.size(); ++index) {
+            if (T* value = get(rows[index])) {
+                if (arrow_bit(validity, index)) {
+                    value->emplace();
+                } else {
+                    value->reset();
+                }
+            }
+        }
+        arrow_codec_t<value_type>::read(reader, rows, [&](Row& row) -> value_type* {
+            T* value = get(row);
+            return value && value->has_value() ? &**value : nullptr;
+        });
+    } else {
+        if (null_count > 0) {
+            for (std::size_t index = 0; index < rows.size(); ++index) {
+                if (get(rows[index]) && !arrow_bit(validity, index)) {
+                    throw std::runtime_error("Arrow column contains a null for a field that is not optional.");
+                }
+            }
+        }
+        arrow_codec_t<value_type>::read(reader, rows, get);
+    }
+}
+
+template<class T>
+void arrow_for_each_enum(auto&& function)
+{
+    using value_type = typename arrow_unwrap_t<T>::type;
+    if constexpr (Enum<value_type>) {
+        function(enum_names<value_type>);
+    } else if constexpr (arrow_has_children<value_type>) {
+        std::apply([&](auto... decls) { (arrow_for_each_enum<typename decltype(decls)::value_type>(function), ...); },
+                   reflect<value_type>::fields());
+    }
+}
+
+[[nodiscard]] inline flatbuffer_builder_t::offset_t arrow_schema(flatbuffer_builder_t& builder,
+                                                               std::span<const flatbuffer_builder_t::offset_t> fields)
+{
+    const auto fields_offset = builder.create_offset_vector(fields);
+    builder.start_table();
+    builder.add_scalar(0, static_cast<std::int16_t>(std::endian::native == std::endian::little ? 0 : 1));
+    builder.add_offset(1, fields_offset);
+    return builder.end_table();
+}
+
+template<class T>
+[[nodiscard]] flatbuffer_builder_t::offset_t arrow_schema(flatbuffer_builder_t& builder)
+{
+    std::int64_t dictionary_id = 0;
+    const auto fields = arrow_codec_t<T>::children(builder, dictionary_id);
+    return arrow_schema(builder, fields);
+}
+
+[[nodiscard]] inline flatbuffer_builder_t::offset_t arrow_record_batch(flatbuffer_builder_t& builder,
+                                                                     std::size_t length,
+                                                                     const arrow_body_t& body)
+{
+    const auto nodes = builder.create_struct_vector<2>(body.nodes);
+    const auto buffers = builder.create_struct_vector<2>(body.buffers);
+    builder.start_table();
+    builder.add_scalar(0, static_cast<std::int64_t>(length));
+    builder.add_offset(1, nodes);
+    builder.add_offset(2, buffers);
+    return builder.end_table();
+}
+
+[[nodiscard]] inline std::vector<std::byte> arrow_message(flatbuffer_builder_t& builder,
+                                                          arrow_header_t header_type,
+                                                          flatbuffer_builder_t::offset_t header,
+                                                          std::size_t body_size)
+{
+    builder.start_table();
+    builder.add_scalar(0, arrow_metadata_version);
+    builder.add_scalar(1, static_cast<std::uint8_t>(header_type));
+    builder.add_offset(2, header);
+    builder.add_scalar(3, static_cast<std::int64_t>(body_size));
+    return builder.finish(builder.end_table());
+}
+
+template<class V>
+void arrow_append(std::vector<std::byte>& buffer, V value)
+{
+    const auto bits = std::bit_cast<std::array<std::byte, sizeof(V)>>(value);
+    for (std::size_t i = 0; i < sizeof(V); ++i) {
+        buffer.push_back(bits[std::endian::native == std::endian::little ? i : sizeof(V) - 1 - i]);
+    }
+}
+
+// Appends an encapsulated message and a zeroed body. Returns the Block describing it in the footer and the offset of
+// the body in the buffer.
+[[nodiscard]] inline std::pair<std::array<std::int64_t, 3>, std::size_t> arrow_write_message(
+    std::vector<std::byte>& buffer,
+    std::span<const std::byte> metadata,
+    std::size_t body_size)
+{
+    const auto offset = buffer.size();
+    const auto metadata_size = arrow_padded(metadata.size());
+    arrow_append(buffer, arrow_continuation);
+    arrow_append(buffer, static_cast<std::int32_t>(metadata_size));
+    buffer.insert(buffer.end(), metadata.begin(), metadata.end());
+    buffer.resize(buffer.size() + metadata_size - metadata.size() + body_size);
+    return {{static_cast<std::int64_t>(offset),
+             static_cast<std::int64_t>(8 + metadata_size),
+             static_cast<std::int64_t>(body_size)},
+            offset + 8 + metadata_size};
+}
+
+[[nodiscard]] inline flatbuffer_table_t arrow_read_message(std::span<const std::byte> file,
+                                                           const std::array<std::int64_t, 3>& block,
+                                                           arrow_header_t expected,
+                                                           std::span<const std::byte>& body)
+{
+    const auto [offset, metadata_length, body_length] = block;
+    if (offset < 0 || metadata_length < 8 || body_length < 0 || static_cast<std::uint64_t>(offset) > file.size() ||
+        static_cast<std::uint64_t>(metadata_length) > file.size() - static_cast<std::uint64_t>(offset) ||
+        static_cast<std::uint64_t>(body_length) >
+            file.size() - static_cast<std::uint64_t>(offset) - static_cast<std::uint64_t>(metadata_length)) {
+        throw std::runtime_error("Arrow block is out of bounds.");
+    }
+    auto metadata = file.subspan(static_cast<std::size_t>(offset), static_cast<std::size_t>(metadata_length));
+    // files written before Arrow 0.15 have no continuation marker
+    const std::size_t prefix = read_little_endian<std::uint32_t>(metadata, 0) == arrow_continuation ? 8 : 4;
+    metadata = metadata.subspan(prefix);
+    body = file.subspan(static_cast<std::size_t>(offset + metadata_length), static_cast<std::size_t>(body_length));
+
+    const auto message = flatbuffer_table_t::root(metadata);
+    if (message.scalar<std::uint8_t>(1, 0) != static_cast<std::uint8_t>(expected) || !message.table(2)) {
+        throw std::runtime_error("Arrow message has an unexpected type.");
+    }
+    return *message.table(2);
+}
+
+[[nodiscard]] inline arrow_batch_reader_t arrow_batch_reader(
+    const flatbuffer_table_t& record_batch,
+    std::span<const std::byte> body,
+    const std::vector<arrow_dictionary_column_t>& dictionary_columns,
+    const std::map<std::int64_t, std::vector<std::string>>& dictionaries)
+{
+    if (record_batch.table(3)) {
+        throw std::runtime_error("Compressed Arrow record batches are not supported.");
+    }
+    // every column stores at least a bit per row, which bounds the length before any rows are allocated
+    const auto length = record_batch.scalar<std::int64_t>(0, 0);
+    if (length < 0 || static_cast<std::uint64_t>(length) > body.size() * 8 + 1) {
+        throw std::runtime_error("Arrow record batch length is invalid.");
+    }
+    return arrow_batch_reader_t{body,
+                                record_batch.structs<2>(1),
+                                record_batch.structs<2>(2),
+                                static_cast<std::size_t>(length),
+                                dictionary_columns,
+                                dictionaries};
+}
+
+}
+
+// Writes records as an Arrow IPC file, split into record batches of at most batch_rows rows.
+template<std::ranges::forward_range Range>
+void to_arrow(const Range& records, std::vector<std::byte>& buffer, std::size_t batch_rows = arrow_default_batch_rows)
+{
+    using T = std::ranges::range_value_t<Range>;
+    static_assert(detail::arrow_has_children<T>, "Arrow files hold ranges of reflected records.");
+    if (batch_rows == 0) {
+        throw std::invalid_argument("Arrow batches need at least one row.");
+    }
+
+    buffer.insert(buffer.end(),
+                  reinterpret_cast<const std::byte*>(detail::arrow_magic.data()),
+                  reinterpret_cast<const std::byte*>(detail::arrow_magic.data() + detail::arrow_magic.size()));
+    {
+        detail::flatbuffer_builder_t builder;
+        const auto schema = detail::arrow_schema<T>(builder);
+        const auto metadata = detail::arrow_message(builder, detail::arrow_header_t::schema, schema, 0);
+        (void)detail::arrow_write_message(buffer, metadata, 0);
+    }
+
+    std::vector<std::array<std::int64_t, 3>> dictionary_blocks;
+    detail::arrow_for_each_enum<T>([&](const auto& names) {
+        detail::arrow_body_t body;
+        const auto identity = [](const std::string_view& name) { return &name; };
+        body.nodes.push_back({static_cast<std::int64_t>(names.size()), 0});
+        body.add_buffer(0);
+        detail::arrow_codec_t<std::string>::plan(body, names, identity);
+
+        detail::flatbuffer_builder_t builder;
+        const auto data = detail::arrow_record_batch(builder, names.size(), body);
+        builder.start_table();
+        builder.add_scalar(0, static_cast<std::int64_t>(dictionary_blocks.size()));
+        builder.add_offset(1, data);
+        builder.add_scalar(2, std::uint8_t{0});
+        const auto batch = builder.end_table();
+        const auto metadata =
+            detail::arrow_message(builder, detail::arrow_header_t::dictionary_batch, batch, body.size);
+        const auto [block, body_offset] = detail::arrow_write_message(buffer, metadata, body.size);
+        detail::arrow_body_writer_t writer{buffer.data() + body_offset, body};
+        (void)writer.buffer();
+        detail::arrow_codec_t<std::string>::write(writer, names, identity);
+        dictionary_blocks.push_back(block);
+    });
+
+    std::vector<std::array<std::int64_t, 3>> record_blocks;
+    auto first = std::ranges::begin(records);
+    const auto last = std::ranges::end(records);
+    while (first != last) {
+        auto batch_end = first;
+        std::size_t length = 0;
+        while (batch_end != last && length < batch_rows) {
+            ++batch_end;
+            ++length;
+        }
+        const auto rows = std::ranges::subrange(first, batch_end);
+        const auto identity = [](const T& row) { return &row; };
+
+        detail::arrow_body_t body;
+        detail::arrow_codec_t<T>::plan_children(body, rows, identity);
+        detail::flatbuffer_builder_t builder;
+        const auto batch = detail::arrow_record_batch(builder, length, body);
+        const auto metadata = detail::arrow_message(builder, detail::arrow_header_t::record_batch, batch, body.size);
+        const auto [block, body_offset] = detail::arrow_write_message(buffer, metadata, body.size);
+
+        // every column goes straight from the records into its final place in the output
+        detail::arrow_body_writer_t writer{buffer.data() + body_offset, body};
+        detail::arrow_codec_t<T>::write(writer, rows, identity);
+        record_blocks.push_back(block);
+        first = batch_end;
+    }
+
+    detail::arrow_append(buffer, detail::arrow_continuation);
+    detail::arrow_append(buffer, std::int32_t{0});
+
+    detail::flatbuffer_builder_t builder;
+    const auto schema = detail::arrow_schema<T>(builder);
+    const auto dictionaries = builder.create_struct_vector<3>(dictionary_blocks);
+    const auto batches = builder.create_struct_vector<3>(record_blocks);
+    builder.start_table();
+    builder.add_scalar(0, detail::arrow_metadata_version);
+    builder.add_offset(1, schema);
+    builder.add_offset(2, dictionaries);
+    builder.add_offset(3, batches);
+    const auto footer = builder.finish(builder.end_table());
+    buffer.insert(buffer.end(), footer.begin(), footer.end());
+    detail::arrow_append(buffer, static_cast<std::int32_t>(footer.size()));
+    buffer.insert(buffer.end(),
+                  reinterpret_cast<const std::byte*>(detail::arrow_magic.data()),
+                  reinterpret_cast<const std::byte*>(detail::arrow_magic.data() + 6));
+}
+
+template<std::ranges::forward_range Range>
+[[nodiscard]] std::vector<std::byte> to_arrow(const Range& records, std::size_t batch_rows = arrow_default_batch_rows)
+{
+    std::vector<std::byte> buffer;
+    to_arrow(records, buffer, batch_rows);
+    return buffer;
+}
+
+// Reads all record batches of an Arrow IPC file. The schema of the file has to match T field by field.
+template<class T, class... Validator>
+[[nodiscard]] std::vector<T> from_arrow(std::span<const std::byte> buffer, Validator&&... validator)
+{
+    static_assert(detail::arrow_has_children<T>, "Arrow files hold ranges of reflected records.");
+    const auto magic = std::as_bytes(std::span(detail::arrow_magic.data(), 6));
+    if (buffer.size() < 18 || !std::ranges::equal(buffer.first(6), magic) ||
+        !std::ranges::equal(buffer.last(6), magic)) {
+        throw std::runtime_error("Input is not an Arrow file.");
+    }
+    const auto footer_size = detail::read_little_endian<std::int32_t>(buffer, buffer.size() - 10);
+    if (footer_size <= 0 || static_cast<std::size_t>(footer_size) > buffer.size() - 18) {
+        throw std::runtime_error("Arrow footer is out of bounds.");
+    }
+    const auto footer =
+        detail::flatbuffer_table_t::root(buffer.subspan(buffer.size() - 10 - static_cast<std::size_t>(footer_size),
+                                                        static_cast<std::size_t>(footer_size)));
+
+    const auto schema = footer.table(1);
+    if (!schema) {
+        throw std::runtime_error("Arrow footer has no schema.");
+    }
+    if (schema->scalar<std::int16_t>(0, 0) != (std::endian::native == std::endian::little ? 0 : 1)) {
+        throw std::runtime_error("Arrow file was written with a different byte order.");
+    }
+    std::vector<detail::arrow_dictionary_column_t> dictionary_columns;
+    detail::arrow_codec_t<T>::check_children(schema->tables(1), dictionary_columns);
+
+    std::map<std::int64_t, std::vector<std::string>> dictionaries;
+    for (const auto& block : footer.structs<3>(2)) {
+        std::span<const std::byte> body;
+        const auto batch = detail::arrow_read_message(buffer, block, detail::arrow_header_t::dictionary_batch, body);
+        const auto data = batch.table(1);
+        if (!data) {
+            throw std::runtime_error("Arrow dictionary batch has no data.");
+        }
+        auto reader = detail::arrow_batch_reader(*data, body, dictionary_columns, dictionaries);
+        std::vector<std::string> names(reader.length);
+        detail::arrow_read_column<std::string>(reader, std::span(names), [](std::string& name) { return &name; });
+
+        auto& dictionary = dictionaries[batch.scalar<std::int64_t>(0, 0)];
+        if (batch.scalar<std::uint8_t>(2, 0) == 0) {
+            dictionary.clear();
+        }
+        dictionary.insert(dictionary.end(), names.begin(), names.end());
+    }
+
+    std::vector<T> result;
+    for (const auto& block : footer.structs<3>(3)) {
+        std::span<const std::byte> body;
+        const auto batch = detail::arrow_read_message(buffer, block, detail::arrow_header_t::record_batch, body);
+        auto reader = detail::arrow_batch_reader(batch, body, dictionary_columns, dictionaries);
+        const auto first = result.size();
+        result.resize(first + reader.length);
+        detail::arrow_codec_t<T>::read(reader, std::span(result).subspan(first), [](T& row) { return &row; });
+    }
+
+    for (const auto& record : result) {
+        if (!(true && ... && validator(record))) {
+            throw std::runtime_error("Validator was not satisfied.");
+        }
+    }
+    return result;
+}
+
+template<class T, class... Validator>
+[[nodiscard]] std::optional<std::vector<T>> try_from_arrow(std::span<const std::byte> buffer,
+                                                           Validator&&... validator) noexcept
+{
+    try {
+        return from_arrow<T>(buffer, std::forward<Validator>(validator)...);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+}
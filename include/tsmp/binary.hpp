@@ -0,0 +1,502 @@
+#pragma once
+
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace tsmp {
+
+namespace detail {
+
+struct binary_writer_t
+{
+    std::vector<std::byte>& buffer;
+
+    void write_bytes(const void* data, std::size_t size)
+    {
+        const auto* begin = static_cast<const std::byte*>(data);
+        buffer.insert(buffer.end(), begin, begin + size);
+    }
+
+    void write_byte(std::byte byte) { buffer.push_back(byte); }
+
+    void write_varint(std::uint64_t value)
+    {
+        std::array<std::byte, 10> bytes;
+        std::size_t size = 0;
+        while (value >= 0x80) {
+            bytes[size++] = static_cast<std::byte>(value | 0x80);
+            value >>= 7;
+        }
+        bytes[size++] = static_cast<std::byte>(value);
+        write_bytes(bytes.data(), size);
+    }
+
+    template<std::unsigned_integral T>
+    void write_little_endian(T value)
+    {
+        if constexpr (std::endian::native == std::endian::little) {
+            write_bytes(&value, sizeof(T));
+        } else {
+            for (std::size_t i = 0; i < sizeof(T); ++i) {
+                write_byte(static_cast<std::byte>(value >> (8 * i)));
+            }
+        }
+    }
+};
+
+struct binary_reader_t
+{
+    std::span<const std::byte> buffer;
+    std::size_t position = 0;
+
+    [[nodiscard]] std::size_t remaining() const noexcept { return buffer.size() - position; }
+
+    void require(std::size_t size) const
+    {
+        if (remaining() < size) {
+            throw std::runtime_error("Unexpected end of binary input.");
+        }
+    }
+
+    void read_bytes(void* data, std::size_t size)
+    {
+        require(size);
+        if (size > 0) {
+            std::memcpy(data, buffer.data() + position, size);
+        }
+        position += size;
+    }
+
+    [[nodiscard]] std::byte read_byte()
+    {
+        require(1);
+        return buffer[position++];
+    }
+
+    [[nodiscard]] std::uint64_t read_varint()
+    {
+        std::uint64_t result = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const auto byte = std::to_integer<std::uint64_t>(read_byte());
+            result |= (byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return result;
+            }
+        }
+        throw std::runtime_error("Varint exceeds 64 bit.");
+    }
+
+    template<std::unsigned_integral T>
+    [[nodiscard]] T read_little_endian()
+    {
+        T value{};
+        if constexpr (std::endian::native == std::endian::little) {
+            read_bytes(&value, sizeof(T));
+        } else {
+            for (std::size_t i = 0; i < sizeof(T); ++i) {
+                value |= static_cast<T>(std::to_integer<T>(read_byte()) << (8 * i));
+            }
+        }
+        return value;
+    }
+
+    [[nodiscard]] std::size_t read_size()
+    {
+        const auto size = read_varint();
+        if (size > std::numeric_limits<std::size_t>::max()) {
+            throw std::runtime_error("Size exceeds the addressable range.");
+        }
+        return static_cast<std::size_t>(size);
+    }
+};
+
+[[nodiscard]] constexpr std::size_t varint_size(std::uint64_t value) noexcept
+{
+    return static_cast<std::size_t>((std::bit_width(value | 1) + 6) / 7);
+}
+
+[[nodiscard]] constexpr std::uint64_t zigzag_encode(std::int64_t value) noexcept
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+[[nodiscard]] constexpr std::int64_t zigzag_decode(std::uint64_t value) noexcept
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+template<class T>
+struct bitwise_float_t
+{
+    using type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+};
+
+// Each codec exports whether values of its type can be copied byte by byte (trivially copyable, no padding and
+// no validation necessary). Aggregates that are bitwise as a whole are encoded with a single memcpy.
+template<class T>
+struct binary_codec_t;
+
+template<Arithmetic T>
+struct binary_codec_t<T>
+{
+    static constexpr bool bitwise = !std::is_same_v<T, bool> && std::endian::native == std::endian::little;
+
+    static void encode(binary_writer_t& writer, const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            writer.write_byte(static_cast<std::byte>(value ? 1 : 0));
+        } else if constexpr (std::floating_point<T>) {
+            static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only 32 and 64 bit floating point types are supported.");
+            writer.write_little_endian(std::bit_cast<typename bitwise_float_t<T>::type>(value));
+        } else if constexpr (sizeof(T) == 1) {
+            writer.write_byte(static_cast<std::byte>(value));
+        } else if constexpr (std::is_signed_v<T>) {
+            writer.write_varint(zigzag_encode(value));
+        } else {
+            writer.write_varint(value);
+        }
+    }
+
+    [[nodiscard]] static T decode(binary_reader_t& reader)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            const auto byte = std::to_integer<unsigned>(reader.read_byte());
+            if (byte > 1) {
+                throw std::runtime_error("Invalid boolean value.");
+            }
+            return byte == 1;
+        } else if constexpr (std::floating_point<T>) {
+            return std::bit_cast<T>(reader.read_little_endian<typename bitwise_float_t<T>::type>());
+        } else if constexpr (sizeof(T) == 1) {
+            return static_cast<T>(std::to_integer<unsigned char>(reader.read_byte()));
+        } else if constexpr (std::is_signed_v<T>) {
+            const auto value = zigzag_decode(reader.read_varint());
+            if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+                throw std::runtime_error("Integer out of range.");
+            }
+            return static_cast<T>(value);
+        } else {
+            const auto value = reader.read_varint();
+            if (value > std::numeric_limits<T>::max()) {
+                throw std::runtime_error("Integer out of range.");
+            }
+            return static_cast<T>(value);
+        }
+    }
+};
+
+template<Enum T>
+struct binary_codec_t<T>
+{
+    static constexpr bool bitwise = false;
+
+    // Most enumerations are declared without explicit values. In that case the index equals the underlying value
+    // and the lookup can be skipped.
+    static constexpr bool dense = []() {
+        bool result = true;
+        for (std::size_t index = 0; index < enum_values<T>.size(); ++index) {
+            using underlying_t = std::underlying_type_t<T>;
+            result = result && static_cast<underlying_t>(enum_values<T>[index]) == static_cast<underlying_t>(index);
+        }
+        return result;
+    }();
+
+    static void encode(binary_writer_t& writer, const T& value)
+    {
+        if constexpr (dense) {
+            const auto index = static_cast<std::uint64_t>(value);
+            if (index >= enum_values<T>.size()) {
+                throw std::runtime_error("Value is not part of enumeration.");
+            }
+            writer.write_varint(index);
+        } else {
+            const auto it = std::ranges::find(enum_values<T>, value);
+            if (it == enum_values<T>.end()) {
+                throw std::runtime_error("Value is not part of enumeration.");
+            }
+            writer.write_varint(static_cast<std::uint64_t>(it - enum_values<T>.begin()));
+        }
+    }
+
+    [[nodiscard]] static T decode(binary_reader_t& reader)
+    {
+        const auto index = reader.read_varint();
+        if (index >= enum_values<T>.size()) {
+            throw std::runtime_error("Enumeration index out of range.");
+        }
+        return enum_values<T>[index];
+    }
+};
+
+template<>
+struct binary_codec_t<std::string>
+{
+    static constexpr bool bitwise = false;
+
+    static void encode(binary_writer_t& writer, const std::string& value)
+    {
+        writer.write_varint(value.size());
+        writer.write_bytes(value.data(), value.size());
+    }
+
+    [[nodiscard]] static std::string decode(binary_reader_t& reader)
+    {
+        const auto size = reader.read_size();
+        reader.require(size);
+        std::string result(size, '\0');
+        reader.read_bytes(result.data(), size);
+        return result;
+    }
+};
+
+template<std::size_t N>
+struct binary_codec_t<string_literal_t<N>>
+{
+    static constexpr bool bitwise = true;
+
+    static void encode(binary_writer_t& writer, const string_literal_t<N>& value)
+    {
+        writer.write_bytes(value.data(), N);
+    }
+
+    [[nodiscard]] static string_literal_t<N> decode(binary_reader_t& reader)
+    {
+        string_literal_t<N> result("");
+        reader.read_bytes(result.data(), N);
+        return result;
+    }
+};
+
+template<class T, std::size_t N>
+struct binary_codec_t<std::array<T, N>>
+{
+    static constexpr bool bitwise = binary_codec_t<T>::bitwise && sizeof(std::array<T, N>) == N * sizeof(T);
+
+    static void encode(binary_writer_t& writer, const std::array<T, N>& value)
+    {
+        if constexpr (bitwise) {
+            writer.write_bytes(value.data(), sizeof(value));
+        } else {
+            for (const auto& element : value) {
+                binary_codec_t<T>::encode(writer, element);
+            }
+        }
+    }
+
+    [[nodiscard]] static std::array<T, N> decode(binary_reader_t& reader)
+    {
+        std::array<T, N> result;
+        if constexpr (bitwise) {
+            reader.read_bytes(result.data(), sizeof(result));
+        } else {
+            for (auto& element : result) {
+                element = binary_codec_t<T>::decode(reader);
+            }
+        }
+        return result;
+    }
+};
+
+template<class T>
+struct binary_codec_t<std::optional<T>>
+{
+    static constexpr bool bitwise = false;
+
+    static void encode(binary_writer_t& writer, const std::optional<T>& value)
+    {
+        binary_codec_t<bool>::encode(writer, value.has_value());
+        if (value) {
+            binary_codec_t<T>::encode(writer, *value);
+        }
+    }
+
+    [[nodiscard]] static std::optional<T> decode(binary_reader_t& reader)
+    {
+        if (binary_codec_t<bool>::decode(reader)) {
+            return binary_codec_t<T>::decode(reader);
+        }
+        return std::nullopt;
+    }
+};
+
+template<class... Ts>
+struct binary_codec_t<std::variant<Ts...>>
+{
+    static constexpr bool bitwise = false;
+
+    static void encode(binary_writer_t& writer, const std::variant<Ts...>& value)
+    {
+        if (value.valueless_by_exception()) {
+            throw std::runtime_error("Can not encode a valueless variant.");
+        }
+        writer.write_varint(value.index());
+        std::visit(
+            [&writer](const auto& alternative) {
+                binary_codec_t<std::remove_cvref_t<decltype(alternative)>>::encode(writer, alternative);
+            },
+            value);
+    }
+
+    [[nodiscard]] static std::variant<Ts...> decode(binary_reader_t& reader)
+    {
+        using decoder_t = std::variant<Ts...> (*)(binary_reader_t&);
+        constexpr std::array<decoder_t, sizeof...(Ts)> decoders{
+            [](binary_reader_t& input) -> std::variant<Ts...> {
+                return std::variant<Ts...>{std::in_place_type<Ts>, binary_codec_t<Ts>::decode(input)};
+            }...};
+        const auto index = reader.read_varint();
+        if (index >= decoders.size()) {
+            throw std::runtime_error("Variant index out of range.");
+        }
+        return decoders[index](reader);
+    }
+};
+
+template<std::ranges::input_range Range>
+struct binary_codec_t<Range>
+{
+    using value_type = std::ranges::range_value_t<Range>;
+
+    static constexpr bool bitwise = false;
+    static constexpr bool block_copy = std::ranges::contiguous_range<Range> && binary_codec_t<value_type>::bitwise;
+
+    static void encode(binary_writer_t& writer, const Range& range)
+    {
+        if constexpr (block_copy) {
+            const auto size = std::ranges::size(range);
+            writer.write_varint(size);
+            writer.write_bytes(std::ranges::data(range), size * sizeof(value_type));
+        } else {
+            writer.write_varint(static_cast<std::uint64_t>(std::ranges::distance(range)));
+            for (const auto& element : range) {
+                binary_codec_t<value_type>::encode(writer, element);
+            }
+        }
+    }
+
+    [[nodiscard]] static Range decode(binary_reader_t& reader)
+    {
+        const auto size = reader.read_size();
+        if constexpr (block_copy && requires(Range r) { r.resize(std::size_t{}); }) {
+            if (size > reader.remaining() / sizeof(value_type)) {
+                throw std::runtime_error("Unexpected end of binary input.");
+            }
+            Range result;
+            result.resize(size);
+            reader.read_bytes(std::ranges::data(result), size * sizeof(value_type));
+            return result;
+        } else {
+            std::vector<value_type> buffer;
+            buffer.reserve(std::min(size, reader.remaining()));
+            for (std::size_t i = 0; i < size; ++i) {
+                buffer.emplace_back(binary_codec_t<value_type>::decode(reader));
+            }
+            if constexpr (std::is_same_v<Range, std::vector<value_type>>) {
+                return buffer;
+            } else {
+                return Range{std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end())};
+            }
+        }
+    }
+};
+
+template<class T>
+struct binary_codec_t
+{
+    static constexpr bool bitwise = std::apply(
+        [](auto... decls) {
+            return sizeof...(decls) > 0 && std::is_trivially_copyable_v<T> &&
+                   (binary_codec_t<typename decltype(decls)::value_type>::bitwise && ... && true) &&
+                   sizeof(T) == (sizeof(typename decltype(decls)::value_type) + ... + 0);
+        },
+        reflect<T>::fields());
+
+    static void encode(binary_writer_t& writer, const T& value)
+    {
+        if constexpr (bitwise) {
+            writer.write_bytes(&value, sizeof(T));
+        } else {
+            std::apply(
+                [&](auto... decls) {
+                    (binary_codec_t<typename decltype(decls)::value_type>::encode(writer, value.*(decls.ptr)), ...);
+                },
+                reflect<T>::fields());
+        }
+    }
+
+    [[nodiscard]] static T decode(binary_reader_t& reader)
+    {
+        T result{};
+        if constexpr (bitwise) {
+            reader.read_bytes(&result, sizeof(T));
+        } else {
+            std::apply(
+                [&](auto... decls) {
+                    ((result.*(decls.ptr) = binary_codec_t<typename decltype(decls)::value_type>::decode(reader)), ...);
+                },
+                reflect<T>::fields());
+        }
+        return result;
+    }
+};
+
+}
+
+template<class T>
+void to_binary(const T& value, std::vector<std::byte>& buffer)
+{
+    detail::binary_writer_t writer{buffer};
+    detail::binary_codec_t<T>::encode(writer, value);
+}
+
+template<class T>
+[[nodiscard]] std::vector<std::byte> to_binary(const T& value)
+{
+    std::vector<std::byte> buffer;
+    to_binary(value, buffer);
+    return buffer;
+}
+
+template<class T, class... Validator>
+[[nodiscard]] T from_binary(std::span<const std::byte> buffer, Validator&&... validator)
+{
+    detail::binary_reader_t reader{buffer};
+    auto result = detail::binary_codec_t<T>::decode(reader);
+    if (reader.remaining() != 0) {
+        throw std::runtime_error("Trailing bytes after binary input.");
+    }
+    if ((true && ... && validator(result))) {
+        return result;
+    } else {
+        throw std::runtime_error("Validator was not satisfied.");
+    }
+}
+
+template<class T, class... Validator>
+[[nodiscard]] std::optional<T> try_from_binary(std::span<const std::byte> buffer, Validator&&... validator) noexcept
+{
+    try {
+        return from_binary<T>(buffer, std::forward<Validator>(validator)...);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+}
@@ -0,0 +1,384 @@
+#pragma once
+
+#include "tagged.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace tsmp {
+
+namespace detail {
+
+enum class cbor_major_t : std::uint8_t
+{
+    unsigned_integer = 0,
+    negative_integer = 1,
+    byte_string = 2,
+    text_string = 3,
+    array = 4,
+    map = 5,
+    tag = 6,
+    simple = 7
+};
+
+struct cbor_writer_t
+{
+    std::vector<std::byte>& buffer;
+
+    void write_head(cbor_major_t major, std::uint64_t argument)
+    {
+        const auto type = static_cast<std::uint8_t>(static_cast<std::uint8_t>(major) << 5);
+        if (argument < 24) {
+            buffer.push_back(static_cast<std::byte>(type | argument));
+        } else if (argument <= 0xff) {
+            buffer.push_back(static_cast<std::byte>(type | 24));
+            write_big_endian(buffer, static_cast<std::uint8_t>(argument));
+        } else if (argument <= 0xffff) {
+            buffer.push_back(static_cast<std::byte>(type | 25));
+            write_big_endian(buffer, static_cast<std::uint16_t>(argument));
+        } else if (argument <= 0xffffffff) {
+            buffer.push_back(static_cast<std::byte>(type | 26));
+            write_big_endian(buffer, static_cast<std::uint32_t>(argument));
+        } else {
+            buffer.push_back(static_cast<std::byte>(type | 27));
+            write_big_endian(buffer, argument);
+        }
+    }
+
+    void write_nil() { buffer.push_back(std::byte{0xf6}); }
+
+    void write_bool(bool value) { buffer.push_back(value ? std::byte{0xf5} : std::byte{0xf4}); }
+
+    void write_unsigned(std::uint64_t value) { write_head(cbor_major_t::unsigned_integer, value); }
+
+    void write_signed(std::int64_t value)
+    {
+        if (value >= 0) {
+            write_head(cbor_major_t::unsigned_integer, static_cast<std::uint64_t>(value));
+        } else {
+            // negative integers are stored as -1 - value, which is the bitwise complement in two's complement
+            write_head(cbor_major_t::negative_integer, ~static_cast<std::uint64_t>(value));
+        }
+    }
+
+    void write_float(float value)
+    {
+        buffer.push_back(std::byte{0xfa});
+        write_big_endian(buffer, std::bit_cast<std::uint32_t>(value));
+    }
+
+    void write_double(double value)
+    {
+        buffer.push_back(std::byte{0xfb});
+        write_big_endian(buffer, std::bit_cast<std::uint64_t>(value));
+    }
+
+    void write_string(std::string_view value)
+    {
+        write_head(cbor_major_t::text_string, value.size());
+        const auto* data = reinterpret_cast<const std::byte*>(value.data());
+        buffer.insert(buffer.end(), data, data + value.size());
+    }
+
+    void write_array_header(std::size_t size) { write_head(cbor_major_t::array, size); }
+
+    void write_map_header(std::size_t size) { write_head(cbor_major_t::map, size); }
+};
+
+// decoding of IEEE 754 half precision numbers as given in RFC 8949, Appendix D
+[[nodiscard]] inline double cbor_decode_half(std::uint16_t half) noexcept
+{
+    const int exponent = (half >> 10) & 0x1f;
+    const int mantissa = half & 0x3ff;
+    double value;
+    if (exponent == 0) {
+        value = std::ldexp(mantissa, -24);
+    } else if (exponent != 31) {
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+    } else {
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+struct cbor_reader_t : tagged_cursor_t
+{
+    static constexpr std::uint8_t indefinite_length = 31;
+    static constexpr std::size_t max_skip_depth = 512;
+
+    struct head_t
+    {
+        cbor_major_t major;
+        std::uint8_t info;
+        std::uint64_t argument;
+    };
+
+    [[nodiscard]] bool read_head(head_t& head) noexcept
+    {
+        // semantic tags are not interpreted and skipped transparently
+        do {
+            std::uint8_t initial;
+            if (!read_byte(initial)) {
+                return false;
+            }
+            head.major = static_cast<cbor_major_t>(initial >> 5);
+            head.info = initial & 0x1f;
+            head.argument = head.info;
+            if (head.info == 24) {
+                std::uint8_t argument;
+                if (!read_big_endian(argument)) {
+                    return false;
+                }
+                head.argument = argument;
+            } else if (head.info == 25) {
+                std::uint16_t argument;
+                if (!read_big_endian(argument)) {
+                    return false;
+                }
+                head.argument = argument;
+            } else if (head.info == 26) {
+                std::uint32_t argument;
+                if (!read_big_endian(argument)) {
+                    return false;
+                }
+                head.argument = argument;
+            } else if (head.info == 27) {
+                if (!read_big_endian(head.argument)) {
+                    return false;
+                }
+            } else if (head.info > 27 && head.info < indefinite_length) {
+                return fail("Reserved CBOR additional information.");
+            }
+        } while (head.major == cbor_major_t::tag);
+        return true;
+    }
+
+    [[nodiscard]] bool peek_head(head_t& head) noexcept
+    {
+        auto lookahead = *this;
+        if (!lookahead.read_head(head)) {
+            error = lookahead.error;
+            return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] tagged_kind_t peek() noexcept
+    {
+        head_t head;
+        if (!peek_head(head)) {
+            return tagged_kind_t::other;
+        }
+        switch (head.major) {
+            case cbor_major_t::unsigned_integer:
+            case cbor_major_t::negative_integer:
+                return tagged_kind_t::integer;
+            case cbor_major_t::byte_string:
+                return tagged_kind_t::binary;
+            case cbor_major_t::text_string:
+                return tagged_kind_t::string;
+            case cbor_major_t::array:
+                return tagged_kind_t::array;
+            case cbor_major_t::map:
+                return tagged_kind_t::map;
+            default:
+                break;
+        }
+        if (head.info == 20 || head.info == 21) {
+            return tagged_kind_t::boolean;
+        } else if (head.info == 22 || head.info == 23) {
+            return tagged_kind_t::nil;
+        } else if (head.info >= 25 && head.info <= 27) {
+            return tagged_kind_t::floating;
+        }
+        return tagged_kind_t::other;
+    }
+
+    [[nodiscard]] bool read_nil() noexcept
+    {
+        auto lookahead = *this;
+        head_t head;
+        if (lookahead.read_head(head) && head.major == cbor_major_t::simple && (head.info == 22 || head.info == 23)) {
+            *this = lookahead;
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool read_bool(bool& value) noexcept
+    {
+        head_t head;
+        if (!read_head(head)) {
+            return false;
+        }
+        if (head.major != cbor_major_t::simple || (head.info != 20 && head.info != 21)) {
+            return fail("Value is not a boolean.");
+        }
+        value = head.info == 21;
+        return true;
+    }
+
+    [[nodiscard]] bool read_integer(tagged_integer_t& integer) noexcept
+    {
+        head_t head;
+        if (!read_head(head)) {
+            return false;
+        }
+        if ((head.major != cbor_major_t::unsigned_integer && head.major != cbor_major_t::negative_integer) ||
+            head.info == indefinite_length) {
+            return fail("Value is not an integer.");
+        }
+        integer = {head.major == cbor_major_t::negative_integer, head.argument};
+        return true;
+    }
+
+    [[nodiscard]] bool read_float(double& value) noexcept
+    {
+        head_t head;
+        if (!read_head(head)) {
+            return false;
+        }
+        if (head.major != cbor_major_t::simple || head.info < 25 || head.info > 27) {
+            return fail("Value is not a floating point number.");
+        }
+        if (head.info == 25) {
+            value = cbor_decode_half(static_cast<std::uint16_t>(head.argument));
+        } else if (head.info == 26) {
+            value = std::bit_cast<float>(static_cast<std::uint32_t>(head.argument));
+        } else {
+            value = std::bit_cast<double>(head.argument);
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool read_string(std::string_view& value) noexcept
+    {
+        head_t head;
+        if (!read_head(head)) {
+            return false;
+        }
+        if (head.major != cbor_major_t::text_string) {
+            return fail("Value is not a string.");
+        }
+        if (head.info == indefinite_length) {
+            // chunked strings can not be referenced without a copy
+            return fail("Indefinite length strings are not supported.");
+        }
+        return read_view(head.argument, value);
+    }
+
+    [[nodiscard]] bool read_container_header(tagged_container_t& header, cbor_major_t major)
+    {
+        head_t head;
+        if (!read_head(head)) {
+            return false;
+        }
+        if (head.major != major) {
+            return fail(major == cbor_major_t::array ? "Value is not an array." : "Value is not a map.");
+        }
+        if (head.argument > std::numeric_limits<std::size_t>::max()) {
+            return fail("Container size exceeds the addressable range.");
+        }
+        header = {static_cast<std::size_t>(head.argument), head.info == indefinite_length};
+        return true;
+    }
+
+    [[nodiscard]] bool read_array_header(tagged_container_t& header)
+    {
+        return read_container_header(header, cbor_major_t::array);
+    }
+
+    [[nodiscard]] bool read_map_header(tagged_container_t& header)
+    {
+        return read_container_header(header, cbor_major_t::map);
+    }
+
+    [[nodiscard]] bool read_break() noexcept
+    {
+        std::uint8_t byte;
+        if (peek_byte(byte) && byte == 0xff) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool skip(std::size_t depth = 0) noexcept
+    {
+        if (depth > max_skip_depth) {
+            return fail("CBOR nesting exceeds the supported depth.");
+        }
+        head_t head;
+        if (!read_head(head)) {
+            return false;
+        }
+        const bool indefinite = head.info == indefinite_length;
+        switch (head.major) {
+            case cbor_major_t::unsigned_integer:
+            case cbor_major_t::negative_integer:
+            case cbor_major_t::simple:
+                return !indefinite || fail("Unexpected break.");
+            case cbor_major_t::byte_string:
+            case cbor_major_t::text_string:
+                if (indefinite) {
+                    while (!read_break()) {
+                        if (!skip(depth + 1)) {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+                return skip_bytes(head.argument);
+            case cbor_major_t::array:
+            case cbor_major_t::map: {
+                const std::uint64_t factor = head.major == cbor_major_t::map ? 2 : 1;
+                for (std::uint64_t i = 0; indefinite ? !read_break() : i < head.argument * factor; ++i) {
+                    if (!skip(depth + 1)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            default:
+                return fail("Invalid CBOR major type.");
+        }
+    }
+};
+
+}
+
+template<class T>
+void to_cbor(const T& value, std::vector<std::byte>& buffer)
+{
+    detail::cbor_writer_t writer{buffer};
+    detail::tagged_codec_t<T>::encode(writer, value);
+}
+
+template<class T>
+[[nodiscard]] std::vector<std::byte> to_cbor(const T& value)
+{
+    std::vector<std::byte> buffer;
+    to_cbor(value, buffer);
+    return buffer;
+}
+
+template<class T, class... Validator>
+[[nodiscard]] T from_cbor(std::span<const std::byte> buffer, Validator&&... validator)
+{
+    return detail::from_tagged<T, detail::cbor_reader_t>(buffer, std::forward<Validator>(validator)...);
+}
+
+template<class T, class... Validator>
+[[nodiscard]] std::optional<T> try_from_cbor(std::span<const std::byte> buffer, Validator&&... validator) noexcept
+{
+    return detail::try_from_tagged<T, detail::cbor_reader_t>(buffer, std::forward<Validator>(validator)...);
+}
+
+}
@@ -0,0 +1,487 @@
+#pragma once
+
+#include "binary.hpp"
+#include "reflect.hpp"
+#include "schema_hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Compressed columnar snapshot of a range of reflected records. Every field becomes a column whose encoding depends on
+// its type:
+//   integers, floats      -> plain little endian values or runs of equal values
+//   bool, enums           -> indices into enum_values bit packed to the smallest width, or runs of equal indices
+//   std::string           -> dictionary of the distinct values plus indices like enums
+//   std::optional         -> presence column plus a column of the present values
+//   reflected records     -> one column per field
+// Runs are chosen whenever they are smaller than the plain or packed form, which is the case for sorted and other
+// clustered columns.
+
+namespace tsmp {
+
+namespace detail {
+
+enum class column_encoding_t : std::uint8_t
+{
+    plain = 0,
+    packed = 1,
+    run_length = 2
+};
+
+[[nodiscard]] constexpr std::size_t column_bit_width(std::size_t domain) noexcept
+{
+    return domain <= 1 ? 0 : static_cast<std::size_t>(std::bit_width(domain - 1));
+}
+
+[[nodiscard]] inline std::uint64_t column_load_word(const std::byte* data) noexcept
+{
+    std::uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    if constexpr (std::endian::native == std::endian::big) {
+        std::uint64_t swapped = 0;
+        for (std::size_t i = 0; i < sizeof(word); ++i) {
+            swapped |= ((word >> (8 * i)) & 0xff) << (8 * (sizeof(word) - 1 - i));
+        }
+        word = swapped;
+    }
+    return word;
+}
+
+inline void column_pack_bits(binary_writer_t& writer, std::span<const std::uint32_t> values, std::size_t width)
+{
+    std::uint64_t pending = 0;
+    std::size_t pending_bits = 0;
+    for (const auto value : values) {
+        pending |= static_cast<std::uint64_t>(value) << pending_bits;
+        pending_bits += width;
+        while (pending_bits >= 8) {
+            writer.write_byte(static_cast<std::byte>(pending));
+            pending >>= 8;
+            pending_bits -= 8;
+        }
+    }
+    if (pending_bits > 0) {
+        writer.write_byte(static_cast<std::byte>(pending));
+    }
+}
+
+// Every value is extracted from an unaligned 64 bit load at its byte offset, which needs no branches and no state
+// carried between values. Only the values near the end of the input, where such a load would overrun, take the
+// byte by byte path.
+inline void column_unpack_bits(std::span<const std::byte> packed, std::size_t width, std::span<std::uint32_t> values)
+{
+    if (width == 0) {
+        std::ranges::fill(values, 0);
+        return;
+    }
+    const std::uint64_t mask = (std::uint64_t{1} << width) - 1;
+    const auto loadable = packed.size() < 8 ? 0 : std::min(values.size(), ((packed.size() - 8) * 8 + 7) / width + 1);
+    for (std::size_t i = 0; i < loadable; ++i) {
+        const auto bit = i * width;
+        values[i] = static_cast<std::uint32_t>((column_load_word(packed.data() + bit / 8) >> (bit % 8)) & mask);
+    }
+    for (std::size_t i = loadable; i < values.size(); ++i) {
+        const auto bit = i * width;
+        std::uint64_t word = 0;
+        for (std::size_t byte = bit / 8; byte < packed.size() && byte < bit / 8 + 8; ++byte) {
+            word |= std::to_integer<std::uint64_t>(packed[byte]) << (8 * (byte - bit / 8));
+        }
+        values[i] = static_cast<std::uint32_t>((word >> (bit % 8)) & mask);
+    }
+}
+
+// Calls function(first, length) for every run of equal elements.
+template<class Range, class Function>
+void column_for_each_run(const Range& values, Function&& function)
+{
+    std::size_t first = 0;
+    for (std::size_t i = 1; i <= values.size(); ++i) {
+        if (i == values.size() || values[i] != values[first]) {
+            function(first, i - first);
+            first = i;
+        }
+    }
+}
+
+inline void column_write_indices(binary_writer_t& writer, std::span<const std::uint32_t> indices, std::size_t domain)
+{
+    const auto width = column_bit_width(domain);
+    std::size_t runs = 0;
+    std::size_t run_bytes = 0;
+    column_for_each_run(indices, [&](std::size_t first, std::size_t length) {
+        ++runs;
+        run_bytes += varint_size(indices[first]) + varint_size(length);
+    });
+    if (run_bytes < (indices.size() * width + 7) / 8) {
+        writer.write_byte(static_cast<std::byte>(column_encoding_t::run_length));
+        writer.write_varint(runs);
+        column_for_each_run(indices, [&](std::size_t first, std::size_t length) {
+            writer.write_varint(indices[first]);
+            writer.write_varint(length);
+        });
+    } else {
+        writer.write_byte(static_cast<std::byte>(column_encoding_t::packed));
+        column_pack_bits(writer, indices, width);
+    }
+}
+
+[[nodiscard]] inline column_encoding_t column_read_encoding(binary_reader_t& reader)
+{
+    const auto encoding = std::to_integer<std::uint8_t>(reader.read_byte());
+    if (encoding > static_cast<std::uint8_t>(column_encoding_t::run_length)) {
+        throw std::runtime_error("Unknown column encoding.");
+    }
+    return static_cast<column_encoding_t>(encoding);
+}
+
+// Calls function(first, length) for every run and checks that the runs cover exactly count rows.
+template<class Function>
+void column_read_runs(binary_reader_t& reader, std::size_t count, Function&& function)
+{
+    const auto runs = reader.read_size();
+    std::size_t covered = 0;
+    for (std::size_t run = 0; run < runs; ++run) {
+        function(covered, [&] {
+            const auto length = reader.read_size();
+            if (length == 0 || length > count - covered) {
+                throw std::runtime_error("Column runs do not match the row count.");
+            }
+            covered += length;
+            return length;
+        });
+    }
+    if (covered != count) {
+        throw std::runtime_error("Column runs do not match the row count.");
+    }
+}
+
+inline void column_read_indices(binary_reader_t& reader, std::span<std::uint32_t> indices, std::size_t domain)
+{
+    const auto encoding = column_read_encoding(reader);
+    if (encoding == column_encoding_t::run_length) {
+        column_read_runs(reader, indices.size(), [&](std::size_t first, auto read_length) {
+            const auto index = reader.read_varint();
+            if (index >= domain) {
+                throw std::runtime_error("Column index out of range.");
+            }
+            std::fill_n(indices.begin() + static_cast<std::ptrdiff_t>(first),
+                        read_length(),
+                        static_cast<std::uint32_t>(index));
+        });
+    } else if (encoding == column_encoding_t::packed) {
+        const auto width = column_bit_width(domain);
+        const auto size = (indices.size() * width + 7) / 8;
+        reader.require(size);
+        column_unpack_bits(reader.buffer.subspan(reader.position, size), width, indices);
+        reader.position += size;
+        if (std::ranges::any_of(indices, [domain](std::uint32_t index) { return index >= domain; })) {
+            throw std::runtime_error("Column index out of range.");
+        }
+    } else {
+        throw std::runtime_error("Unexpected column encoding.");
+    }
+}
+
+// Every codec encodes the values behind a span of pointers and decodes into the values behind a span of pointers,
+// which lets optionals and nested records hand a subset or the fields of their values to the next codec.
+template<class T>
+struct column_codec_t;
+
+template<Arithmetic T>
+    requires(!std::is_same_v<T, bool>)
+struct column_codec_t<T>
+{
+    using bits_t =
+        std::conditional_t<sizeof(T) == 1,
+                           std::uint8_t,
+                           std::conditional_t<sizeof(T) == 2,
+                                              std::uint16_t,
+                                              std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+    static_assert(sizeof(T) == sizeof(bits_t), "Only 8, 16, 32 and 64 bit arithmetic types are supported.");
+
+    static void encode(binary_writer_t& writer, std::span<const T* const> values)
+    {
+        // compared bit by bit, so runs of NaN are found and 0.0 and -0.0 stay apart
+        std::vector<bits_t> bits(values.size());
+        std::ranges::transform(values, bits.begin(), [](const T* value) { return std::bit_cast<bits_t>(*value); });
+        std::size_t runs = 0;
+        std::size_t run_bytes = 0;
+        column_for_each_run(bits, [&](std::size_t, std::size_t length) {
+            ++runs;
+            run_bytes += sizeof(T) + varint_size(length);
+        });
+        if (run_bytes < bits.size() * sizeof(T)) {
+            writer.write_byte(static_cast<std::byte>(column_encoding_t::run_length));
+            writer.write_varint(runs);
+            column_for_each_run(bits, [&](std::size_t first, std::size_t length) {
+                writer.write_little_endian(bits[first]);
+                writer.write_varint(length);
+            });
+        } else {
+            writer.write_byte(static_cast<std::byte>(column_encoding_t::plain));
+            if constexpr (std::endian::native == std::endian::little) {
+                writer.write_bytes(bits.data(), bits.size() * sizeof(T));
+            } else {
+                for (const auto value : bits) {
+                    writer.write_little_endian(value);
+                }
+            }
+        }
+    }
+
+    static void decode(binary_reader_t& reader, std::span<T* const> values)
+    {
+        const auto encoding = column_read_encoding(reader);
+        if (encoding == column_encoding_t::run_length) {
+            column_read_runs(reader, values.size(), [&](std::size_t first, auto read_length) {
+                const auto value = std::bit_cast<T>(reader.read_little_endian<bits_t>());
+                const auto length = read_length();
+                for (std::size_t i = first; i < first + length; ++i) {
+                    *values[i] = value;
+                }
+            });
+        } else if (encoding == column_encoding_t::plain) {
+            reader.require(values.size() * sizeof(T));
+            for (T* value : values) {
+                *value = std::bit_cast<T>(reader.read_little_endian<bits_t>());
+            }
+        } else {
+            throw std::runtime_error("Unexpected column encoding.");
+        }
+    }
+};
+
+template<>
+struct column_codec_t<bool>
+{
+    static void encode(binary_writer_t& writer, std::span<const bool* const> values)
+    {
+        std::vector<std::uint32_t> indices(values.size());
+        std::ranges::transform(values, indices.begin(), [](const bool* value) { return *value ? 1u : 0u; });
+        column_write_indices(writer, indices, 2);
+    }
+
+    static void decode(binary_reader_t& reader, std::span<bool* const> values)
+    {
+        std::vector<std::uint32_t> indices(values.size());
+        column_read_indices(reader, indices, 2);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            *values[i] = indices[i] != 0;
+        }
+    }
+};
+
+template<Enum T>
+struct column_codec_t<T>
+{
+    static void encode(binary_writer_t& writer, std::span<const T* const> values)
+    {
+        std::vector<std::uint32_t> indices(values.size());
+        std::ranges::transform(values, indices.begin(), [](const T* value) {
+            const auto found = std::ranges::find(enum_values<T>, *value);
+            if (found == enum_values<T>.end()) {
+                throw std::runtime_error("Value is not part of enumeration.");
+            }
+            return static_cast<std::uint32_t>(found - enum_values<T>.begin());
+        });
+        column_write_indices(writer, indices, enum_values<T>.size());
+    }
+
+    static void decode(binary_reader_t& reader, std::span<T* const> values)
+    {
+        std::vector<std::uint32_t> indices(values.size());
+        column_read_indices(reader, indices, enum_values<T>.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            *values[i] = enum_values<T>[indices[i]];
+        }
+    }
+};
+
+template<>
+struct column_codec_t<std::string>
+{
+    static void encode(binary_writer_t& writer, std::span<const std::string* const> values)
+    {
+        std::unordered_map<std::string_view, std::uint32_t> positions;
+        std::vector<std::string_view> dictionary;
+        std::vector<std::uint32_t> indices(values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            const auto [position, inserted] =
+                positions.try_emplace(*values[i], static_cast<std::uint32_t>(dictionary.size()));
+            if (inserted) {
+                dictionary.push_back(*values[i]);
+            }
+            indices[i] = position->second;
+        }
+        writer.write_varint(dictionary.size());
+        for (const auto entry : dictionary) {
+            writer.write_varint(entry.size());
+            writer.write_bytes(entry.data(), entry.size());
+        }
+        column_write_indices(writer, indices, dictionary.size());
+    }
+
+    static void decode(binary_reader_t& reader, std::span<std::string* const> values)
+    {
+        const auto size = reader.read_size();
+        // every entry takes at least its length byte
+        reader.require(size);
+        std::vector<std::string> dictionary(size);
+        for (auto& entry : dictionary) {
+            entry.resize(reader.read_size());
+            reader.read_bytes(entry.data(), entry.size());
+        }
+        std::vector<std::uint32_t> indices(values.size());
+        column_read_indices(reader, indices, dictionary.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            *values[i] = dictionary[indices[i]];
+        }
+    }
+};
+
+template<is_optional T>
+struct column_codec_t<T>
+{
+    using value_type = typename T::value_type;
+
+    static void encode(binary_writer_t& writer, std::span<const T* const> values)
+    {
+        std::vector<std::uint32_t> presence(values.size());
+        std::vector<const value_type*> present;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            presence[i] = values[i]->has_value();
+            if (*values[i]) {
+                present.push_back(&**values[i]);
+            }
+        }
+        column_write_indices(writer, presence, 2);
+        column_codec_t<value_type>::encode(writer, present);
+    }
+
+    static void decode(binary_reader_t& reader, std::span<T* const> values)
+    {
+        std::vector<std::uint32_t> presence(values.size());
+        column_read_indices(reader, presence, 2);
+        std::vector<value_type*> present;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (presence[i] != 0) {
+                present.push_back(&values[i]->emplace());
+            } else {
+                values[i]->reset();
+            }
+        }
+        column_codec_t<value_type>::decode(reader, present);
+    }
+};
+
+template<class T>
+struct column_codec_t
+{
+    static_assert(!std::ranges::range<T>, "Only std::string is supported as range type in column blocks.");
+
+    static void encode(binary_writer_t& writer, std::span<const T* const> values)
+    {
+        std::apply(
+            [&](auto... decls) {
+                (
+                    [&] {
+                        using field_type = typename decltype(decls)::value_type;
+                        std::vector<const field_type*> fields(values.size());
+                        std::ranges::transform(
+                            values, fields.begin(), [ptr = decls.ptr](const T* value) { return &(value->*ptr); });
+                        column_codec_t<field_type>::encode(writer, fields);
+                    }(),
+                    ...);
+            },
+            reflect<T>::fields());
+    }
+
+    static void decode(binary_reader_t& reader, std::span<T* const> values)
+    {
+        std::apply(
+            [&](auto... decls) {
+                (
+                    [&] {
+                        using field_type = typename decltype(decls)::value_type;
+                        std::vector<field_type*> fields(values.size());
+                        std::ranges::transform(
+                            values, fields.begin(), [ptr = decls.ptr](T* value) { return &(value->*ptr); });
+                        column_codec_t<field_type>::decode(reader, fields);
+                    }(),
+                    ...);
+            },
+            reflect<T>::fields());
+    }
+};
+
+}
+
+// Encodes the records column by column, prefixed by schema_hash<T> and the number of records.
+template<std::ranges::forward_range Range>
+void to_column_block(const Range& records, std::vector<std::byte>& buffer)
+{
+    using T = std::ranges::range_value_t<Range>;
+    std::vector<const T*> values;
+    for (const auto& record : records) {
+        values.push_back(&record);
+    }
+    detail::binary_writer_t writer{buffer};
+    writer.write_little_endian(schema_hash<T>);
+    writer.write_varint(values.size());
+    detail::column_codec_t<T>::encode(writer, values);
+}
+
+template<std::ranges::forward_range Range>
+[[nodiscard]] std::vector<std::byte> to_column_block(const Range& records)
+{
+    std::vector<std::byte> buffer;
+    to_column_block(records, buffer);
+    return buffer;
+}
+
+template<class T, class... Validator>
+[[nodiscard]] std::vector<T> from_column_block(std::span<const std::byte> buffer, Validator&&... validator)
+{
+    detail::binary_reader_t reader{buffer};
+    if (reader.read_little_endian<std::uint64_t>() != schema_hash<T>) {
+        throw std::runtime_error("Column block was written for a different schema.");
+    }
+    std::vector<T> result(reader.read_size());
+    std::vector<T*> values(result.size());
+    std::ranges::transform(result, values.begin(), [](T& record) { return &record; });
+    detail::column_codec_t<T>::decode(reader, values);
+    if (reader.remaining() != 0) {
+        throw std::runtime_error("Unexpected bytes after the column block.");
+    }
+    for (const auto& record : result) {
+        if (!(true && ... && validator(record))) {
+            throw std::runtime_error("Validator was not satisfied.");
+        }
+    }
+    return result;
+}
+
+template<class T, class... Validator>
+[[nodiscard]] std::optional<std::vector<T>> try_from_column_block(std::span<const std::byte> buffer,
+                                                                  Validator&&... validator) noexcept
+{
+    try {
+        return from_column_block<T>(buffer, std::forward<Validator>(validator)...);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+}
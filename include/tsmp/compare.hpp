@@ -0,0 +1,229 @@
+#pragma once
+
+#include "reflect.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Memberwise equality and ordering of reflected records, which need neither operator== nor operator<=>. Fields are
+// compared in declaration order and the comparison stops at the first difference. Values with unique object
+// representations (no padding, no floating point fields) are equal if their bytes are. Such records, contiguous ranges
+// of them and runs of adjacent such fields are compared for equality with a single memcmp, which the C library
+// implements with vector instructions.
+// compare returns the weakest comparison category of the fields, std::partial_ordering if there are floating point
+// fields and std::strong_ordering otherwise. Optionals without value order first.
+
+namespace tsmp {
+
+namespace detail {
+
+template<class V>
+concept compare_record = reflect<V>::reflectable;
+
+template<class V>
+inline constexpr bool compare_bytewise =
+    std::has_unique_object_representations_v<V> && !std::is_pointer_v<V> && !std::is_member_pointer_v<V>;
+
+template<class V>
+struct compare_category;
+
+template<class V>
+using compare_category_t = typename compare_category<V>::type;
+
+template<class V>
+    requires(Arithmetic<V> || Enum<V>)
+struct compare_category<V>
+{
+    using type = std::compare_three_way_result_t<V>;
+};
+
+template<class V>
+    requires(!Arithmetic<V> && !Enum<V> && std::is_convertible_v<const V&, std::string_view>)
+struct compare_category<V>
+{
+    using type = std::strong_ordering;
+};
+
+template<class V>
+struct compare_category<std::optional<V>>
+{
+    using type = compare_category_t<V>;
+};
+
+template<class V>
+    requires(!std::is_convertible_v<const V&, std::string_view> && std::ranges::range<V>)
+struct compare_category<V>
+{
+    using type = compare_category_t<std::ranges::range_value_t<V>>;
+};
+
+template<class Fields>
+struct compare_fields_category;
+
+template<class... Decls>
+struct compare_fields_category<std::tuple<Decls...>>
+{
+    using type =
+        std::common_comparison_category_t<std::strong_ordering, compare_category_t<typename Decls::value_type>...>;
+};
+
+template<compare_record V>
+    requires(!std::ranges::range<V> && !is_optional<V>)
+struct compare_category<V>
+{
+    using type = typename compare_fields_category<decltype(reflect<V>::fields())>::type;
+};
+
+template<class V>
+[[nodiscard]] bool compare_equal(const V& lhs, const V& rhs);
+
+template<class V, std::size_t id>
+inline constexpr auto compare_field_pointer = std::get<id>(reflect<V>::fields()).ptr;
+
+template<class V, std::size_t id>
+using compare_field_t = typename std::tuple_element_t<id, decltype(reflect<V>::fields())>::value_type;
+
+template<class V>
+inline constexpr std::size_t compare_field_count = std::tuple_size_v<decltype(reflect<V>::fields())>;
+
+// end of the run of fields starting at first that may be compared bytewise
+template<class V, std::size_t first>
+[[nodiscard]] consteval std::size_t compare_run_end() noexcept
+{
+    if constexpr (first < compare_field_count<V>) {
+        if constexpr (compare_bytewise<compare_field_t<V, first>>) {
+            return compare_run_end<V, first + 1>();
+        }
+    }
+    return first;
+}
+
+template<class V, std::size_t first, std::size_t... id>
+[[nodiscard]] bool compare_run_equal(const V& lhs, const V& rhs, std::index_sequence<id...>)
+{
+    constexpr std::size_t last = first + sizeof...(id) - 1;
+    constexpr std::size_t bytes = (sizeof(compare_field_t<V, first + id>) + ...);
+    const auto* left = reinterpret_cast<const std::byte*>(&(lhs.*compare_field_pointer<V, first>));
+    const auto* right = reinterpret_cast<const std::byte*>(&(rhs.*compare_field_pointer<V, first>));
+    const auto* end = reinterpret_cast<const std::byte*>(&(lhs.*compare_field_pointer<V, last>)) +
+                      sizeof(compare_field_t<V, last>);
+    // the offsets are constants after inlining, so only one of the branches remains
+    if (end - left == static_cast<std::ptrdiff_t>(bytes)) {
+        return std::memcmp(left, right, bytes) == 0;
+    }
+    return (compare_equal(lhs.*compare_field_pointer<V, first + id>, rhs.*compare_field_pointer<V, first + id>) && ...);
+}
+
+// compares the fields from first on, adjacent fields without padding in between are compared with one memcmp
+template<class V, std::size_t first>
+[[nodiscard]] bool compare_fields_equal(const V& lhs, const V& rhs)
+{
+    if constexpr (first == compare_field_count<V>) {
+        return true;
+    } else {
+        constexpr auto last = compare_run_end<V, first>();
+        if constexpr (last - first > 1) {
+            return compare_run_equal<V, first>(lhs, rhs, std::make_index_sequence<last - first>{}) &&
+                   compare_fields_equal<V, last>(lhs, rhs);
+        } else {
+            return compare_equal(lhs.*compare_field_pointer<V, first>, rhs.*compare_field_pointer<V, first>) &&
+                   compare_fields_equal<V, first + 1>(lhs, rhs);
+        }
+    }
+}
+
+template<class V>
+[[nodiscard]] bool compare_equal(const V& lhs, const V& rhs)
+{
+    if constexpr (Arithmetic<V> || Enum<V>) {
+        return lhs == rhs;
+    } else if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+        return std::string_view(lhs) == std::string_view(rhs);
+    } else if constexpr (is_optional<V>) {
+        return lhs.has_value() == rhs.has_value() && (!lhs || compare_equal(*lhs, *rhs));
+    } else if constexpr (std::ranges::range<V>) {
+        using element_type = std::ranges::range_value_t<V>;
+        if constexpr (std::ranges::contiguous_range<V> && std::ranges::sized_range<V> &&
+                      compare_bytewise<element_type>) {
+            const auto size = std::ranges::size(lhs);
+            if (size != std::ranges::size(rhs)) {
+                return false;
+            }
+            return size == 0 ||
+                   std::memcmp(std::ranges::data(lhs), std::ranges::data(rhs), size * sizeof(element_type)) == 0;
+        } else {
+            auto left = std::ranges::begin(lhs);
+            auto right = std::ranges::begin(rhs);
+            for (; left != std::ranges::end(lhs) && right != std::ranges::end(rhs); ++left, ++right) {
+                if (!compare_equal(*left, *right)) {
+                    return false;
+                }
+            }
+            return left == std::ranges::end(lhs) && right == std::ranges::end(rhs);
+        }
+    } else if constexpr (compare_bytewise<V>) {
+        return std::memcmp(&lhs, &rhs, sizeof(V)) == 0;
+    } else {
+        static_assert(compare_record<V>, "The type is not supported by tsmp::equal.");
+        return compare_fields_equal<V, 0>(lhs, rhs);
+    }
+}
+
+template<class V>
+[[nodiscard]] compare_category_t<V> compare_three_way(const V& lhs, const V& rhs)
+{
+    if constexpr (Arithmetic<V> || Enum<V>) {
+        return lhs <=> rhs;
+    } else if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+        return std::string_view(lhs) <=> std::string_view(rhs);
+    } else if constexpr (is_optional<V>) {
+        if (lhs && rhs) {
+            return compare_three_way(*lhs, *rhs);
+        }
+        return lhs.has_value() <=> rhs.has_value();
+    } else if constexpr (std::ranges::range<V>) {
+        auto left = std::ranges::begin(lhs);
+        auto right = std::ranges::begin(rhs);
+        for (; left != std::ranges::end(lhs) && right != std::ranges::end(rhs); ++left, ++right) {
+            if (const auto result = compare_three_way(*left, *right); result != 0) {
+                return result;
+            }
+        }
+        return (left != std::ranges::end(lhs)) <=> (right != std::ranges::end(rhs));
+    } else {
+        static_assert(compare_record<V>, "The type is not supported by tsmp::compare.");
+        compare_category_t<V> result = std::strong_ordering::equal;
+        std::apply(
+            [&](const auto&... decls) {
+                ((result = compare_three_way(lhs.*decls.ptr, rhs.*decls.ptr), result == 0) && ...);
+            },
+            reflect<V>::fields());
+        return result;
+    }
+}
+
+}
+
+// True if all fields of the values are equal.
+template<class T>
+[[nodiscard]] bool equal(const T& lhs, const T& rhs)
+{
+    return detail::compare_equal(lhs, rhs);
+}
+
+// Lexicographic comparison of the fields in declaration order.
+template<class T>
+[[nodiscard]] detail::compare_category_t<T> compare(const T& lhs, const T& rhs)
+{
+    return detail::compare_three_way(lhs, rhs);
+}
+
+}
@@ -0,0 +1,468 @@
+#pragma once
+
+#include "reflect.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// CSV (RFC 4180) reader and writer for flat reflected records. Columns are matched to fields by the names in the
+// header line. Numbers are formatted with std::to_chars and parsed with std::from_chars, bools are true/false, enums
+// use their names and an empty unquoted cell is an empty std::optional.
+
+namespace tsmp {
+
+struct csv_options_t
+{
+    char delimiter = ',';
+    char quote = '"';
+    // without a header the columns are the fields in declaration order
+    bool header = true;
+    // input is read and output is flushed in chunks of this size
+    std::size_t chunk_size = 1 << 16;
+    // upper bound of the memory a single record may occupy while it is read
+    std::size_t max_record_size = 1 << 24;
+};
+
+namespace detail {
+
+// Finds the first occurrence of one of the characters. Eight bytes are compared at a time with the bit trick of
+// subtracting 0x01 from every byte, which sets the top bit of bytes that were zero after the xor with the needle.
+template<std::same_as<char>... Needle>
+[[nodiscard]] inline const char* csv_find(const char* first, const char* last, Needle... needle) noexcept
+{
+    if constexpr (std::endian::native == std::endian::little) {
+        constexpr std::uint64_t ones = 0x0101010101010101;
+        constexpr std::uint64_t highs = 0x8080808080808080;
+        for (; last - first >= 8; first += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, first, 8);
+            const auto matches = ([&] {
+                const auto zeroed = word ^ (ones * static_cast<unsigned char>(needle));
+                return (zeroed - ones) & ~zeroed & highs;
+            }() | ...);
+            if (matches != 0) {
+                return first + std::countr_zero(matches) / 8;
+            }
+        }
+    }
+    for (; first != last; ++first) {
+        if (((*first == needle) || ...)) {
+            return first;
+        }
+    }
+    return last;
+}
+
+struct csv_cell_t
+{
+    std::string_view text;
+    bool quoted;
+};
+
+template<class T>
+void csv_parse(const csv_cell_t& cell, T& value)
+{
+    if constexpr (is_optional<T>) {
+        if (cell.text.empty() && !cell.quoted) {
+            value.reset();
+        } else {
+            csv_parse(cell, value.emplace());
+        }
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        value.assign(cell.text);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        if (cell.text == "true" || cell.text == "1") {
+            value = true;
+        } else if (cell.text == "false" || cell.text == "0") {
+            value = false;
+        } else {
+            throw std::runtime_error("Invalid boolean value.");
+        }
+    } else if constexpr (Arithmetic<T>) {
+        const auto* last = cell.text.data() + cell.text.size();
+        const auto [end, error] = std::from_chars(cell.text.data(), last, value);
+        if (error == std::errc::result_out_of_range) {
+            throw std::runtime_error("Number out of range.");
+        }
+        if (error != std::errc{} || end != last) {
+            throw std::runtime_error("Invalid number.");
+        }
+    } else if constexpr (Enum<T>) {
+        value = enum_from_string<T>(cell.text);
+    } else {
+        static_assert(Arithmetic<T>, "CSV columns hold arithmetic types, enums, strings or optionals of them.");
+    }
+}
+
+template<class T>
+using csv_field_parser_t = void (*)(T&, const csv_cell_t&);
+
+template<class T>
+inline constexpr auto csv_field_parsers = []<std::size_t... id>(std::index_sequence<id...>) {
+    return std::array<csv_field_parser_t<T>, sizeof...(id)>{[](T& record, const csv_cell_t& cell) {
+        csv_parse(cell, record.*std::get<id>(reflect<T>::fields()).ptr);
+    }...};
+}(std::make_index_sequence<std::tuple_size_v<decltype(reflect<T>::fields())>>{});
+
+template<class T>
+inline constexpr auto csv_field_names = []<std::size_t... id>(std::index_sequence<id...>) {
+    return std::array<std::string_view, sizeof...(id)>{std::get<id>(reflect<T>::fields()).name...};
+}(std::make_index_sequence<std::tuple_size_v<decltype(reflect<T>::fields())>>{});
+
+}
+
+// Reads records of T from a stream. Only the current chunk and the record being parsed are held in memory.
+template<class T>
+class csv_reader
+{
+public:
+    explicit csv_reader(std::istream& input, csv_options_t options = {})
+        : input(input)
+        , options(options)
+        , buffer(std::max<std::size_t>(options.chunk_size, 64))
+    {
+        constexpr auto& names = detail::csv_field_names<T>;
+        if (!options.header) {
+            for (std::size_t id = 0; id < names.size(); ++id) {
+                column_parsers.push_back(detail::csv_field_parsers<T>[id]);
+            }
+            return;
+        }
+        if (!read_cells()) {
+            throw std::runtime_error("CSV input has no header.");
+        }
+        std::array<bool, names.size()> found{};
+        for (const auto& cell : cells) {
+            detail::csv_field_parser_t<T> parser = nullptr;
+            for (std::size_t id = 0; id < names.size(); ++id) {
+                if (names[id] == cell.text) {
+                    if (found[id]) {
+                        throw std::runtime_error("CSV header contains the column " + std::string(cell.text) +
+                                                 " twice.");
+                    }
+                    found[id] = true;
+                    parser = detail::csv_field_parsers<T>[id];
+                }
+            }
+            // columns without a field are skipped
+            column_parsers.push_back(parser);
+        }
+        std::apply(
+            [&](auto... decls) {
+                (
+                    [&] {
+                        if (!found[decls.id] && !is_optional<typename decltype(decls)::value_type>) {
+                            throw std::runtime_error("CSV header has no column " + std::string(decls.name) + ".");
+                        }
+                    }(),
+                    ...);
+            },
+            reflect<T>::fields());
+    }
+
+    // Fields without a column keep their value, returns false at the end of the input.
+    [[nodiscard]] bool read(T& record)
+    {
+        if (!read_cells()) {
+            return false;
+        }
+        if (cells.size() != column_parsers.size()) {
+            throw std::runtime_error("CSV record " + std::to_string(records) + " has " + std::to_string(cells.size()) +
+                                     " columns instead of " + std::to_string(column_parsers.size()) + ".");
+        }
+        for (std::size_t column = 0; column < cells.size(); ++column) {
+            if (column_parsers[column] == nullptr) {
+                continue;
+            }
+            try {
+                column_parsers[column](record, cells[column]);
+            } catch (const std::exception& error) {
+                throw std::runtime_error("CSV record " + std::to_string(records) + ", column " +
+                                         std::to_string(column + 1) + ": " + error.what());
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] std::optional<T> next()
+    {
+        T record{};
+        if (read(record)) {
+            return record;
+        }
+        return std::nullopt;
+    }
+
+    // number of lines consumed so far, a record with quoted line breaks counts once
+    [[nodiscard]] std::size_t record_number() const noexcept { return records; }
+
+private:
+    // Splits the next record into cells, reading more input whenever it is not complete yet. Blank lines are skipped.
+    [[nodiscard]] bool read_cells()
+    {
+        while (true) {
+            const auto consumed = parse(buffer.data() + position, buffer.data() + filled);
+            if (consumed > 0) {
+                position += consumed;
+                ++records;
+                if (cells.size() == 1 && cells[0].text.empty() && !cells[0].quoted) {
+                    continue;
+                }
+                return true;
+            }
+            if (exhausted) {
+                return false;
+            }
+            refill();
+        }
+    }
+
+    void refill()
+    {
+        if (position > 0) {
+            std::memmove(buffer.data(), buffer.data() + position, filled - position);
+            filled -= position;
+            position = 0;
+        }
+        if (filled == buffer.size()) {
+            if (buffer.size() >= options.max_record_size) {
+                throw std::runtime_error("CSV record " + std::to_string(records + 1) + " exceeds the size limit.");
+            }
+            buffer.resize(std::min(2 * buffer.size(), options.max_record_size));
+        }
+        input.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+        auto read = static_cast<std::size_t>(input.gcount());
+        exhausted = read == 0;
+        if (!started && read >= 3 && std::string_view(buffer.data(), 3) == "\xEF\xBB\xBF") {
+            std::memmove(buffer.data(), buffer.data() + 3, read - 3);
+            read -= 3;
+        }
+        started = true;
+        filled += read;
+    }
+
+    // Returns the length of the record at first, or 0 if more input is needed to complete it.
+    [[nodiscard]] std::size_t parse(const char* first, const char* last)
+    {
+        if (first == last) {
+            return 0;
+        }
+        const char quote = options.quote;
+        const char delimiter = options.delimiter;
+        cells.clear();
+        const char* cursor = first;
+        while (true) {
+            if (cursor != last && *cursor == quote) {
+                if (unquoted.size() <= cells.size()) {
+                    unquoted.resize(cells.size() + 1);
+                }
+                auto& text = unquoted[cells.size()];
+                text.clear();
+                ++cursor;
+                while (true) {
+                    const char* found = detail::csv_find(cursor, last, quote);
+                    if (found == last) {
+                        if (exhausted) {
+                            throw std::runtime_error("CSV record " + std::to_string(records + 1) +
+                                                     " has an unterminated quote.");
+                        }
+                        return 0;
+                    }
+                    text.append(cursor, found);
+                    if (found + 1 == last && !exhausted) {
+                        return 0;
+                    }
+                    cursor = found + 1;
+                    if (cursor == last || *cursor != quote) {
+                        break;
+                    }
+                    text.push_back(quote);
+                    ++cursor;
+                }
+                cells.push_back({text, true});
+            } else {
+                const char* found = detail::csv_find(cursor, last, delimiter, '\n');
+                if (found == last && !exhausted) {
+                    return 0;
+                }
+                std::string_view text(cursor, static_cast<std::size_t>(found - cursor));
+                if ((found == last || *found == '\n') && text.ends_with('\r')) {
+                    text.remove_suffix(1);
+                }
+                cells.push_back({text, false});
+                cursor = found;
+            }
+
+            if (cursor == last) {
+                if (!exhausted) {
+                    return 0;
+                }
+                return static_cast<std::size_t>(last - first);
+            }
+            if (*cursor == delimiter) {
+                ++cursor;
+            } else if (*cursor == '\n') {
+                return static_cast<std::size_t>(cursor + 1 - first);
+            } else if (*cursor == '\r' && cursor + 1 == last && !exhausted) {
+                return 0;
+            } else if (*cursor == '\r' && (cursor + 1 == last || cursor[1] == '\n')) {
+                return static_cast<std::size_t>(cursor + (cursor + 1 == last ? 1 : 2) - first);
+            } else {
+                throw std::runtime_error("CSV record " + std::to_string(records + 1) +
+                                         " has characters after a closing quote.");
+            }
+        }
+    }
+
+    std::istream& input;
+    csv_options_t options;
+    std::vector<detail::csv_field_parser_t<T>> column_parsers;
+    std::vector<char> buffer;
+    std::size_t position = 0;
+    std::size_t filled = 0;
+    bool started = false;
+    bool exhausted = false;
+    std::size_t records = 0;
+    std::vector<detail::csv_cell_t> cells;
+    // a deque keeps the cells of quoted fields in place while more of them are added
+    std::deque<std::string> unquoted;
+};
+
+// Writes a header and records of T to a stream. Output is buffered and flushed in chunks. The destructor writes the
+// remaining records but can not report errors, call close to find out whether all records reached the stream.
+template<class T>
+class csv_writer
+{
+public:
+    explicit csv_writer(std::ostream& output, csv_options_t options = {})
+        : output(output)
+        , options(options)
+    {
+        if (options.header) {
+            for (const auto name : detail::csv_field_names<T>) {
+                if (!pending.empty()) {
+                    pending.push_back(options.delimiter);
+                }
+                write_string(name);
+            }
+            pending.push_back('\n');
+        }
+    }
+
+    csv_writer(const csv_writer&) = delete;
+    csv_writer& operator=(const csv_writer&) = delete;
+
+    ~csv_writer()
+    {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    void write(const T& record)
+    {
+        std::apply(
+            [&](auto... decls) {
+                (
+                    [&] {
+                        if (decls.id > 0) {
+                            pending.push_back(options.delimiter);
+                        }
+                        write_value(record.*decls.ptr);
+                    }(),
+                    ...);
+            },
+            reflect<T>::fields());
+        pending.push_back('\n');
+        if (pending.size() >= options.chunk_size) {
+            flush();
+        }
+    }
+
+    // Writes the buffered records to the stream, throws if the stream failed.
+    void flush()
+    {
+        output.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+        pending.clear();
+        if (!output) {
+            throw std::runtime_error("Could not write CSV output.");
+        }
+    }
+
+    // Writes the buffered records and flushes the stream itself, throws if the stream failed.
+    void close()
+    {
+        flush();
+        output.flush();
+        if (!output) {
+            throw std::runtime_error("Could not write CSV output.");
+        }
+    }
+
+private:
+    template<class V>
+    void write_value(const V& value)
+    {
+        if constexpr (is_optional<V>) {
+            if (value) {
+                write_value(*value);
+            }
+        } else if constexpr (std::is_same_v<V, std::string>) {
+            write_string(value);
+        } else if constexpr (std::is_same_v<V, bool>) {
+            pending.append(value ? "true" : "false");
+        } else if constexpr (Arithmetic<V>) {
+            std::array<char, 64> text;
+            const auto [end, error] = std::to_chars(text.data(), text.data() + text.size(), value);
+            pending.append(text.data(), end);
+        } else if constexpr (Enum<V>) {
+            pending.append(enum_to_string(value));
+        } else {
+            static_assert(Arithmetic<V>, "CSV columns hold arithmetic types, enums, strings or optionals of them.");
+        }
+    }
+
+    // empty strings are quoted to tell them apart from an empty optional
+    void write_string(std::string_view value)
+    {
+        const char special[] = {options.delimiter, options.quote, '\n', '\r'};
+        if (!value.empty() && value.find_first_of(std::string_view(special, 4)) == std::string_view::npos) {
+            pending.append(value);
+            return;
+        }
+        pending.push_back(options.quote);
+        for (const char c : value) {
+            if (c == options.quote) {
+                pending.push_back(options.quote);
+            }
+            pending.push_back(c);
+        }
+        pending.push_back(options.quote);
+    }
+
+    std::ostream& output;
+    csv_options_t options;
+    std::string pending;
+};
+
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "binary.hpp"
+#include "compare.hpp"
+#include "reflect.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Field level differences between two versions of a reflected record. The fields of nested records are flattened, so
+// every field that is not itself a record has an index in declaration order, e.g. for
+//   struct position_t { double x; double y; };
+//   struct unit_t { int id; position_t position; std::string name; };
+// id is 0, position.x is 1, position.y is 2 and name is 3. diff returns a bitmask of the changed fields. delta encodes
+// only the changed fields as their index followed by their value in the format of to_binary, apply writes them into
+// the receiver's copy of the record.
+
+namespace tsmp {
+
+namespace detail {
+
+template<class T>
+concept delta_record = reflect<T>::reflectable && std::tuple_size_v<decltype(reflect<T>::fields())> > 0 &&
+                       !std::ranges::range<T> && !is_optional<T>;
+
+template<class T>
+[[nodiscard]] constexpr std::size_t delta_leaves_of() noexcept;
+
+template<class T>
+inline constexpr auto delta_field_leaves = std::apply(
+    [](auto... decls) {
+        return std::array<std::size_t, sizeof...(decls)>{delta_leaves_of<typename decltype(decls)::value_type>()...};
+    },
+    reflect<T>::fields());
+
+// number of flattened fields
+template<class T>
+[[nodiscard]] constexpr std::size_t delta_leaves_of() noexcept
+{
+    if constexpr (delta_record<T>) {
+        std::size_t result = 0;
+        for (const auto leaves : delta_field_leaves<T>) {
+            result += leaves;
+        }
+        return result;
+    } else {
+        return 1;
+    }
+}
+
+template<class T>
+inline constexpr std::size_t delta_leaves = delta_leaves_of<T>();
+
+// index of the first flattened field of field id
+template<class T, std::size_t id>
+inline constexpr std::size_t delta_field_offset = [] {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < id; ++i) {
+        result += delta_field_leaves<T>[i];
+    }
+    return result;
+}();
+
+// calls fn(std::integral_constant<std::size_t, index>, field, other_fields...) for every flattened field of the values
+template<std::size_t offset, class Fn, class T, class... Ts>
+void delta_visit(Fn& fn, T& value, Ts&... others)
+{
+    [&]<std::size_t... id>(std::index_sequence<id...>) {
+        (
+            [&] {
+                constexpr auto ptr = std::get<id>(reflect<T>::fields()).ptr;
+                constexpr auto index = offset + delta_field_offset<std::remove_const_t<T>, id>;
+                using value_type = typename std::tuple_element_t<id, decltype(reflect<T>::fields())>::value_type;
+                if constexpr (delta_record<value_type>) {
+                    delta_visit<index>(fn, value.*ptr, others.*ptr...);
+                } else {
+                    fn(std::integral_constant<std::size_t, index>{}, value.*ptr, others.*ptr...);
+                }
+            }(),
+            ...);
+    }(std::make_index_sequence<std::tuple_size_v<decltype(reflect<T>::fields())>>{});
+}
+
+template<class V>
+[[nodiscard]] bool delta_equal(const V& lhs, const V& rhs)
+{
+    if constexpr (requires { std::variant_size<V>::value; }) {
+        return lhs == rhs;
+    } else {
+        return compare_equal(lhs, rhs);
+    }
+}
+
+template<class T, std::size_t index>
+void delta_decode_field(T& value, binary_reader_t& reader)
+{
+    auto decode = [&](auto field_index, auto& field) {
+        if constexpr (decltype(field_index)::value == index) {
+            field = binary_codec_t<std::remove_cvref_t<decltype(field)>>::decode(reader);
+        }
+    };
+    delta_visit<0>(decode, value);
+}
+
+// decoders of the flattened fields by index
+template<class T>
+inline constexpr auto delta_decoders = []<std::size_t... index>(std::index_sequence<index...>) {
+    return std::array<void (*)(T&, binary_reader_t&), sizeof...(index)>{&delta_decode_field<T, index>...};
+}(std::make_index_sequence<delta_leaves<T>>{});
+
+}
+
+// Bit i is set if the flattened field i differs.
+template<class T>
+using delta_mask = std::bitset<detail::delta_leaves<T>>;
+
+template<class T>
+[[nodiscard]] delta_mask<T> diff(const T& old_value, const T& new_value)
+{
+    delta_mask<T> result;
+    auto compare = [&](auto index, const auto& old_field, const auto& new_field) {
+        if (!detail::delta_equal(old_field, new_field)) {
+            result.set(decltype(index)::value);
+        }
+    };
+    detail::delta_visit<0>(compare, old_value, new_value);
+    return result;
+}
+
+// Appends the fields of value selected by mask to buffer.
+template<class T>
+void delta(const T& value, const delta_mask<T>& mask, std::vector<std::byte>& buffer)
+{
+    detail::binary_writer_t writer{buffer};
+    writer.write_varint(mask.count());
+    auto encode = [&](auto index, const auto& field) {
+        if (mask.test(decltype(index)::value)) {
+            writer.write_varint(decltype(index)::value);
+            detail::binary_codec_t<std::remove_cvref_t<decltype(field)>>::encode(writer, field);
+        }
+    };
+    detail::delta_visit<0>(encode, value);
+}
+
+// Encodes the fields that changed from old_value to new_value.
+template<class T>
+[[nodiscard]] std::vector<std::byte> delta(const T& old_value, const T& new_value)
+{
+    std::vector<std::byte> buffer;
+    delta(new_value, diff(old_value, new_value), buffer);
+    return buffer;
+}
+
+// Writes the fields of the delta into value and returns which fields were written. If the delta is invalid, an
+// exception is thrown and the fields before the invalid one are already written.
+template<class T>
+delta_mask<T> apply(T& value, std::span<const std::byte> delta)
+{
+    detail::binary_reader_t reader{delta};
+    const auto count = reader.read_size();
+    delta_mask<T> result;
+    std::optional<std::size_t> previous;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto index = reader.read_size();
+        if (index >= detail::delta_leaves<T> || (previous && index <= *previous)) {
+            throw std::runtime_error("Invalid field index in delta.");
+        }
+        detail::delta_decoders<T>[index](value, reader);
+        result.set(index);
+        previous = index;
+    }
+    if (reader.remaining() != 0) {
+        throw std::runtime_error("Trailing bytes after delta.");
+    }
+    return result;
+}
+
+}
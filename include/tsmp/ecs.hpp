@@ -0,0 +1,619 @@
+#pragma once
+
+#include "introspect.hpp"
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Entity component storage. Entities with the same set of components form an archetype, whose rows are stored in
+// chunks of about ecs_chunk_size bytes. Inside a chunk every field of every component has its own cache line aligned
+// column, so systems iterate over contiguous arrays of the fields they touch:
+//   chunk: [entity ids][component 0 field 0][component 0 field 1]...[component n field m]
+// Adding or removing a component moves the entity to another archetype. Removing an entity moves the last row of
+// its archetype into the gap, so rows and chunks stay dense.
+
+namespace tsmp {
+
+struct entity_t
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+
+    [[nodiscard]] friend bool operator==(const entity_t&, const entity_t&) noexcept = default;
+};
+
+inline constexpr std::size_t ecs_chunk_size = 16 * 1024;
+inline constexpr std::size_t ecs_cache_line = 64;
+
+namespace detail {
+
+template<class T, class... Ts>
+inline constexpr std::size_t ecs_index = [] {
+    std::size_t index = 0;
+    static_cast<void>(((std::is_same_v<T, Ts> ? false : (++index, true)) && ...));
+    return index;
+}();
+
+template<class T>
+using ecs_fields_t = decltype(reflect<T>::fields());
+
+template<class T>
+inline constexpr std::size_t ecs_field_count = std::tuple_size_v<ecs_fields_t<T>>;
+
+template<class T, std::size_t id>
+using ecs_field_type_t = typename std::tuple_element_t<id, ecs_fields_t<T>>::value_type;
+
+// type erased operations on one column, used when rows move between chunks
+struct ecs_column_ops_t
+{
+    std::size_t size;
+    void (*relocate)(std::byte* target, std::byte* source) noexcept;
+    void (*destroy)(std::byte* object) noexcept;
+};
+
+template<class V>
+[[nodiscard]] consteval ecs_column_ops_t ecs_make_column_ops() noexcept
+{
+    static_assert(std::is_nothrow_move_constructible_v<V>, "Component fields must be nothrow move constructible.");
+    static_assert(alignof(V) <= ecs_cache_line, "Component fields must not be aligned beyond a cache line.");
+    return {sizeof(V),
+            [](std::byte* target, std::byte* source) noexcept {
+                auto* value = std::launder(reinterpret_cast<V*>(source));
+                std::construct_at(reinterpret_cast<V*>(target), std::move(*value));
+                std::destroy_at(value);
+            },
+            [](std::byte* object) noexcept { std::destroy_at(std::launder(reinterpret_cast<V*>(object))); }};
+}
+
+template<class T>
+inline constexpr auto ecs_component_ops = []<std::size_t... id>(std::index_sequence<id...>) {
+    return std::array<ecs_column_ops_t, sizeof...(id)>{ecs_make_column_ops<ecs_field_type_t<T, id>>()...};
+}(std::make_index_sequence<ecs_field_count<T>>{});
+
+struct ecs_block_deleter_t
+{
+    void operator()(std::byte* data) const noexcept { ::operator delete[](data, std::align_val_t{ecs_cache_line}); }
+};
+
+struct ecs_chunk_t
+{
+    std::unique_ptr<std::byte[], ecs_block_deleter_t> data;
+    std::size_t size = 0;
+};
+
+}
+
+// Entities and their components. Every component type must be a reflected record, each field becomes a column.
+template<class... Components>
+class ecs
+{
+    static constexpr std::size_t component_count = sizeof...(Components);
+    static_assert(component_count <= 64, "ecs supports up to 64 component types.");
+
+    template<class C>
+    static constexpr std::size_t component_index = detail::ecs_index<C, Components...>;
+
+    template<class C>
+    static constexpr std::uint64_t component_bit = [] {
+        static_assert(component_index<C> < component_count, "The type is not a component of this ecs.");
+        return std::uint64_t{1} << component_index<C>;
+    }();
+
+    // columns of all components, numbered consecutively
+    static constexpr std::array<std::size_t, component_count + 1> first_column = [] {
+        std::array<std::size_t, component_count + 1> result{};
+        std::size_t index = 0;
+        ((result[index + 1] = result[index] + detail::ecs_field_count<Components>, ++index), ...);
+        return result;
+    }();
+
+    static constexpr std::size_t column_count = first_column[component_count];
+
+    static constexpr auto column_ops = [] {
+        std::array<detail::ecs_column_ops_t, column_count> result{};
+        auto position = result.begin();
+        ((position = std::ranges::copy(detail::ecs_component_ops<Components>, position).out), ...);
+        return result;
+    }();
+
+    static constexpr auto column_component = [] {
+        std::array<std::size_t, column_count> result{};
+        for (std::size_t component = 0; component < component_count; ++component) {
+            const auto first = result.begin() + static_cast<std::ptrdiff_t>(first_column[component]);
+            std::fill(first, result.begin() + static_cast<std::ptrdiff_t>(first_column[component + 1]), component);
+        }
+        return result;
+    }();
+
+    struct archetype_t
+    {
+        std::uint64_t mask;
+        std::size_t capacity;
+        std::size_t chunk_bytes;
+        std::vector<std::size_t> columns;
+        std::array<std::size_t, column_count> offsets{};
+        std::vector<detail::ecs_chunk_t> chunks;
+    };
+
+    struct location_t
+    {
+        std::uint32_t generation = 0;
+        bool alive = false;
+        std::size_t archetype = 0;
+        std::size_t chunk = 0;
+        std::size_t row = 0;
+    };
+
+public:
+    // One chunk of an archetype. Columns of components that are not part of the archetype are empty.
+    class chunk_view
+    {
+    public:
+        [[nodiscard]] std::size_t size() const noexcept { return rows; }
+
+        [[nodiscard]] std::span<const entity_t> entities() const noexcept
+        {
+            return {reinterpret_cast<const entity_t*>(data), rows};
+        }
+
+        template<class C>
+        [[nodiscard]] bool has() const noexcept
+        {
+            return (archetype->mask & component_bit<C>) != 0;
+        }
+
+        template<class C, std::size_t id>
+        [[nodiscard]] std::span<detail::ecs_field_type_t<C, id>> column() const noexcept
+        {
+            using value_type = detail::ecs_field_type_t<C, id>;
+            if (!has<C>()) {
+                return {};
+            }
+            const auto offset = archetype->offsets[first_column[component_index<C>] + id];
+            return {std::launder(reinterpret_cast<value_type*>(data + offset)), rows};
+        }
+
+        template<class C, string_literal_t name>
+        [[nodiscard]] auto column() const noexcept
+        {
+            return column<C, introspect<C>::field_id(name)>();
+        }
+
+    private:
+        friend class ecs;
+
+        chunk_view(const archetype_t& archetype, const detail::ecs_chunk_t& chunk) noexcept
+            : archetype(&archetype)
+            , data(chunk.data.get())
+            , rows(chunk.size)
+        {
+        }
+
+        const archetype_t* archetype;
+        std::byte* data;
+        std::size_t rows;
+    };
+
+    ecs() = default;
+    ecs(const ecs&) = delete;
+    ecs(ecs&&) = default;
+    ecs& operator=(const ecs&) = delete;
+
+    ecs& operator=(ecs&& other)
+    {
+        if (this != &other) {
+            destroy_components();
+            archetypes = std::move(other.archetypes);
+            archetype_indices = std::move(other.archetype_indices);
+            locations = std::move(other.locations);
+            free_indices = std::move(other.free_indices);
+            count = std::exchange(other.count, 0);
+        }
+        return *this;
+    }
+
+    ~ecs() { destroy_components(); }
+
+    // Destroys all entities.
+    void clear()
+    {
+        destroy_components();
+        for (std::size_t index = 0; index < locations.size(); ++index) {
+            if (locations[index].alive) {
+                locations[index].alive = false;
+                ++locations[index].generation;
+                free_indices.push_back(static_cast<std::uint32_t>(index));
+            }
+        }
+        count = 0;
+    }
+
+    template<class... C>
+    entity_t create(C... components)
+    {
+        constexpr auto mask = (std::uint64_t{0} | ... | component_bit<C>);
+        static_assert(std::popcount(mask) == sizeof...(C), "Every component can only be added once.");
+
+        const auto target = find_archetype(mask);
+        const auto [chunk, row] = allocate(archetypes[target]);
+        (construct(archetypes[target], archetypes[target].chunks[chunk], row, std::move(components)), ...);
+
+        std::uint32_t index;
+        if (free_indices.empty()) {
+            index = static_cast<std::uint32_t>(locations.size());
+            locations.emplace_back();
+        } else {
+            index = free_indices.back();
+            free_indices.pop_back();
+        }
+        auto& location = locations[index];
+        const entity_t entity{index, location.generation};
+        commit(archetypes[target], chunk, row, entity);
+        location.alive = true;
+        ++count;
+        return entity;
+    }
+
+    void destroy(entity_t entity)
+    {
+        auto& location = locate(entity);
+        auto& archetype = archetypes[location.archetype];
+        for (const auto column : archetype.columns) {
+            column_ops[column].destroy(pointer(archetype, archetype.chunks[location.chunk], column, location.row));
+        }
+        erase(archetype, location.chunk, location.row);
+        location.alive = false;
+        ++location.generation;
+        free_indices.push_back(entity.index);
+        --count;
+    }
+
+    [[nodiscard]] bool alive(entity_t entity) const noexcept
+    {
+        return entity.index < locations.size() && locations[entity.index].alive &&
+               locations[entity.index].generation == entity.generation;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return count; }
+
+    template<class C>
+    [[nodiscard]] bool has(entity_t entity) const
+    {
+        return (archetypes[locate(entity).archetype].mask & component_bit<C>) != 0;
+    }
+
+    template<class C, std::size_t id>
+    [[nodiscard]] detail::ecs_field_type_t<C, id>& get(entity_t entity)
+    {
+        return *field<C, id>(entity);
+    }
+
+    template<class C, std::size_t id>
+    [[nodiscard]] const detail::ecs_field_type_t<C, id>& get(entity_t entity) const
+    {
+        return *field<C, id>(entity);
+    }
+
+    template<class C, string_literal_t name>
+    [[nodiscard]] auto& get(entity_t entity)
+    {
+        return get<C, introspect<C>::field_id(name)>(entity);
+    }
+
+    template<class C, string_literal_t name>
+    [[nodiscard]] const auto& get(entity_t entity) const
+    {
+        return get<C, introspect<C>::field_id(name)>(entity);
+    }
+
+    // Gathers the fields of the component into a value.
+    template<class C>
+    [[nodiscard]] C get(entity_t entity) const
+    {
+        C result{};
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            ((result.*std::get<id>(reflect<C>::fields()).ptr = get<C, id>(entity)), ...);
+        }(std::make_index_sequence<detail::ecs_field_count<C>>{});
+        return result;
+    }
+
+    // Assigns the component, adding it to the entity if necessary.
+    template<class C>
+    void set(entity_t entity, C component)
+    {
+        if (!has<C>(entity)) {
+            add(entity, std::move(component));
+            return;
+        }
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            ((get<C, id>(entity) = std::move(component.*std::get<id>(reflect<C>::fields()).ptr)), ...);
+        }(std::make_index_sequence<detail::ecs_field_count<C>>{});
+    }
+
+    template<class C>
+    void add(entity_t entity, C component)
+    {
+        if (has<C>(entity)) {
+            set(entity, std::move(component));
+            return;
+        }
+        auto& location = locate(entity);
+        const auto source = location.archetype;
+        const auto target = find_archetype(archetypes[source].mask | component_bit<C>);
+        const auto [chunk, row] = allocate(archetypes[target]);
+        construct(archetypes[target], archetypes[target].chunks[chunk], row, std::move(component));
+        move(source, location, target, chunk, row, entity);
+    }
+
+    template<class C>
+    void remove(entity_t entity)
+    {
+        if (!has<C>(entity)) {
+            return;
+        }
+        auto& location = locate(entity);
+        const auto source = location.archetype;
+        auto& archetype = archetypes[source];
+        for (auto column = first_column[component_index<C>]; column < first_column[component_index<C> + 1]; ++column) {
+            column_ops[column].destroy(pointer(archetype, archetype.chunks[location.chunk], column, location.row));
+        }
+        const auto target = find_archetype(archetype.mask & ~component_bit<C>);
+        const auto [chunk, row] = allocate(archetypes[target]);
+        move(source, location, target, chunk, row, entity);
+    }
+
+    // Chunks of all archetypes that contain every one of the components C.
+    template<class... C>
+    [[nodiscard]] std::vector<chunk_view> query()
+    {
+        constexpr auto mask = (std::uint64_t{0} | ... | component_bit<C>);
+        std::vector<chunk_view> result;
+        for (const auto& archetype : archetypes) {
+            if ((archetype.mask & mask) == mask) {
+                for (const auto& chunk : archetype.chunks) {
+                    result.push_back(chunk_view(archetype, chunk));
+                }
+            }
+        }
+        return result;
+    }
+
+    // Calls function(chunk_view) for the chunks of query<C...>(). The function must not add or remove entities or
+    // components.
+    template<class... C, class Function>
+    void for_each(Function&& function)
+    {
+        for (const auto& chunk : query<C...>()) {
+            function(chunk);
+        }
+    }
+
+    // Like for_each, but distributes the chunks over up to threads threads. The first exception thrown by function
+    // is rethrown after all threads finished.
+    template<class... C, class Function>
+    void parallel_for_each(Function&& function, std::size_t threads = std::thread::hardware_concurrency())
+    {
+        const auto chunks = query<C...>();
+        std::atomic<std::size_t> next = 0;
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        const auto work = [&] {
+            for (auto index = next++; index < chunks.size(); index = next++) {
+                try {
+                    function(chunks[index]);
+                } catch (...) {
+                    const std::lock_guard lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+        };
+        {
+            // jthreads join on destruction, so a failure to start a worker does not leave running threads behind
+            std::vector<std::jthread> workers;
+            const auto worker_count = std::min(std::max<std::size_t>(threads, 1), chunks.size());
+            for (std::size_t i = 1; i < worker_count; ++i) {
+                workers.emplace_back(work);
+            }
+            work();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct slot_t
+    {
+        std::size_t chunk;
+        std::size_t row;
+    };
+
+    [[nodiscard]] static std::byte* pointer(const archetype_t& archetype,
+                                            const detail::ecs_chunk_t& chunk,
+                                            std::size_t column,
+                                            std::size_t row) noexcept
+    {
+        return chunk.data.get() + archetype.offsets[column] + row * column_ops[column].size;
+    }
+
+    void destroy_components() noexcept
+    {
+        for (auto& archetype : archetypes) {
+            for (auto& chunk : archetype.chunks) {
+                for (const auto column : archetype.columns) {
+                    for (std::size_t row = 0; row < chunk.size; ++row) {
+                        column_ops[column].destroy(pointer(archetype, chunk, column, row));
+                    }
+                }
+            }
+            archetype.chunks.clear();
+        }
+    }
+
+    template<class C, std::size_t id>
+    [[nodiscard]] detail::ecs_field_type_t<C, id>* field(entity_t entity) const
+    {
+        const auto& location = locate(entity);
+        const auto& archetype = archetypes[location.archetype];
+        if ((archetype.mask & component_bit<C>) == 0) {
+            throw std::out_of_range("The entity does not have the component.");
+        }
+        const auto column = first_column[component_index<C>] + id;
+        return std::launder(reinterpret_cast<detail::ecs_field_type_t<C, id>*>(
+            pointer(archetype, archetype.chunks[location.chunk], column, location.row)));
+    }
+
+    [[nodiscard]] static archetype_t make_archetype(std::uint64_t mask)
+    {
+        archetype_t archetype{mask, 0, 0, {}, {}, {}};
+        std::size_t row_bytes = sizeof(entity_t);
+        for (std::size_t column = 0; column < column_count; ++column) {
+            if ((mask >> column_component[column] & 1) != 0) {
+                archetype.columns.push_back(column);
+                row_bytes += column_ops[column].size;
+            }
+        }
+        // the entity ids start at offset 0, each column at the next cache line
+        const auto layout = [&](std::size_t rows) {
+            auto end = rows * sizeof(entity_t);
+            for (const auto column : archetype.columns) {
+                end = (end + ecs_cache_line - 1) / ecs_cache_line * ecs_cache_line;
+                archetype.offsets[column] = end;
+                end += rows * column_ops[column].size;
+            }
+            return (end + ecs_cache_line - 1) / ecs_cache_line * ecs_cache_line;
+        };
+        archetype.capacity = std::max<std::size_t>(ecs_chunk_size / row_bytes, 1);
+        while (archetype.capacity > 1 && layout(archetype.capacity) > ecs_chunk_size) {
+            --archetype.capacity;
+        }
+        archetype.chunk_bytes = layout(archetype.capacity);
+        return archetype;
+    }
+
+    [[nodiscard]] std::size_t find_archetype(std::uint64_t mask)
+    {
+        const auto [position, inserted] = archetype_indices.try_emplace(mask, archetypes.size());
+        if (inserted) {
+            archetypes.push_back(make_archetype(mask));
+        }
+        return position->second;
+    }
+
+    // returns the next free row, which becomes part of the chunk with commit
+    [[nodiscard]] slot_t allocate(archetype_t& archetype)
+    {
+        if (archetype.chunks.empty() || archetype.chunks.back().size == archetype.capacity) {
+            archetype.chunks.push_back({std::unique_ptr<std::byte[], detail::ecs_block_deleter_t>(
+                                            new (std::align_val_t{ecs_cache_line}) std::byte[archetype.chunk_bytes]),
+                                        0});
+        }
+        return {archetype.chunks.size() - 1, archetype.chunks.back().size};
+    }
+
+    void commit(archetype_t& archetype, std::size_t chunk, std::size_t row, entity_t entity) noexcept
+    {
+        std::construct_at(reinterpret_cast<entity_t*>(archetype.chunks[chunk].data.get()) + row, entity);
+        ++archetype.chunks[chunk].size;
+        auto& location = locations[entity.index];
+        location.archetype = static_cast<std::size_t>(&archetype - archetypes.data());
+        location.chunk = chunk;
+        location.row = row;
+    }
+
+    template<class C>
+    void construct(archetype_t& archetype, detail::ecs_chunk_t& chunk, std::size_t row, C&& component)
+    {
+        using value_type = std::remove_cvref_t<C>;
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            (std::construct_at(reinterpret_cast<detail::ecs_field_type_t<value_type, id>*>(pointer(
+                                   archetype, chunk, first_column[component_index<value_type>] + id, row)),
+                               std::move(component.*std::get<id>(reflect<value_type>::fields()).ptr)),
+             ...);
+        }(std::make_index_sequence<detail::ecs_field_count<value_type>>{});
+    }
+
+    // relocates the columns both archetypes share into the allocated row of target and closes the gap in source
+    void move(std::size_t source,
+              location_t& location,
+              std::size_t target,
+              std::size_t chunk,
+              std::size_t row,
+              entity_t entity) noexcept
+    {
+        auto& from = archetypes[source];
+        auto& to = archetypes[target];
+        for (const auto column : from.columns) {
+            if ((to.mask >> column_component[column] & 1) != 0) {
+                column_ops[column].relocate(pointer(to, to.chunks[chunk], column, row),
+                                            pointer(from, from.chunks[location.chunk], column, location.row));
+            }
+        }
+        const auto old_chunk = location.chunk;
+        const auto old_row = location.row;
+        commit(to, chunk, row, entity);
+        erase(from, old_chunk, old_row);
+    }
+
+    // moves the last row of the archetype into the row, whose columns must already be destroyed or relocated
+    void erase(archetype_t& archetype, std::size_t chunk, std::size_t row) noexcept
+    {
+        auto& last = archetype.chunks.back();
+        const auto last_row = last.size - 1;
+        auto* entities = reinterpret_cast<entity_t*>(archetype.chunks[chunk].data.get());
+        if (&archetype.chunks[chunk] != &last || row != last_row) {
+            for (const auto column : archetype.columns) {
+                column_ops[column].relocate(pointer(archetype, archetype.chunks[chunk], column, row),
+                                            pointer(archetype, last, column, last_row));
+            }
+            const auto moved = reinterpret_cast<entity_t*>(last.data.get())[last_row];
+            entities[row] = moved;
+            locations[moved.index].chunk = chunk;
+            locations[moved.index].row = row;
+        }
+        if (--last.size == 0) {
+            archetype.chunks.pop_back();
+        }
+    }
+
+    [[nodiscard]] const location_t& locate(entity_t entity) const
+    {
+        if (!alive(entity)) {
+            throw std::out_of_range("The entity is not alive.");
+        }
+        return locations[entity.index];
+    }
+
+    [[nodiscard]] location_t& locate(entity_t entity)
+    {
+        return const_cast<location_t&>(std::as_const(*this).locate(entity));
+    }
+
+    std::vector<archetype_t> archetypes;
+    std::unordered_map<std::uint64_t, std::size_t> archetype_indices;
+    std::vector<location_t> locations;
+    std::vector<std::uint32_t> free_indices;
+    std::size_t count = 0;
+};
+
+}
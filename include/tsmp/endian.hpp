@@ -0,0 +1,103 @@
+#pragma once
+
+#include "reflect.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Byte order conversion of reflected records in place. Every field is swapped through its member pointer, so the
+// offsets and widths of all swaps are compile-time constants. For arrays the compiler turns the unrolled per record
+// swaps into byte shuffles of the instruction set the program is compiled for (e.g. pshufb with -mssse3 or -mavx2).
+// Supported fields are arithmetic types, enums, std::array of them and nested reflected records.
+
+namespace tsmp {
+
+namespace detail {
+
+template<class V>
+[[nodiscard]] constexpr V endian_byteswap(V value) noexcept
+{
+    auto bytes = std::bit_cast<std::array<std::byte, sizeof(V)>>(value);
+    std::ranges::reverse(bytes);
+    return std::bit_cast<V>(bytes);
+}
+
+template<class T>
+struct endian_swap_t
+{
+    static_assert(!std::ranges::range<T>, "Byte order conversion supports fixed size fields only.");
+
+    static constexpr void swap(T& value) noexcept
+    {
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            (endian_swap_t<typename std::tuple_element_t<id, decltype(reflect<T>::fields())>::value_type>::swap(
+                 value.*std::get<id>(reflect<T>::fields()).ptr),
+             ...);
+        }(std::make_index_sequence<std::tuple_size_v<decltype(reflect<T>::fields())>>{});
+    }
+};
+
+template<class T>
+    requires(Arithmetic<T> || Enum<T>)
+struct endian_swap_t<T>
+{
+    static constexpr void swap(T& value) noexcept
+    {
+        if constexpr (sizeof(T) > 1) {
+            value = endian_byteswap(value);
+        }
+    }
+};
+
+template<class V, std::size_t N>
+struct endian_swap_t<std::array<V, N>>
+{
+    static constexpr void swap(std::array<V, N>& values) noexcept
+    {
+        for (auto& value : values) {
+            endian_swap_t<V>::swap(value);
+        }
+    }
+};
+
+}
+
+// Reverses the byte order of every field.
+template<class T>
+    requires(!std::ranges::range<T>)
+constexpr void byteswap_fields(T& value) noexcept
+{
+    detail::endian_swap_t<T>::swap(value);
+}
+
+template<class T>
+constexpr void byteswap_fields(std::span<T> values) noexcept
+{
+    for (auto& value : values) {
+        detail::endian_swap_t<T>::swap(value);
+    }
+}
+
+// Converts records between host byte order and big endian. Both are no-ops on big endian hosts.
+template<class T>
+constexpr void to_big_endian(std::span<T> values) noexcept
+{
+    if constexpr (std::endian::native == std::endian::little) {
+        byteswap_fields(values);
+    }
+}
+
+template<class T>
+constexpr void from_big_endian(std::span<T> values) noexcept
+{
+    to_big_endian(values);
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace tsmp::detail {
+
+template<class T>
+struct throw_handler_t
+{
+    using value_type = T;
+    T operator()(std::string msg) { throw std::runtime_error(std::move(msg)); }
+};
+
+template<class T>
+struct nullopt_handler_t
+{
+    using value_type = std::optional<T>;
+    std::optional<T> operator()(std::string) { return std::nullopt; }
+};
+
+}
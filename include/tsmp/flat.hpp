@@ -0,0 +1,415 @@
+#pragma once
+
+#include "binary.hpp"
+#include "introspect.hpp"
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// The flat format stores a reflected record as a table. Fields of fixed size (arithmetic values, enums and bitwise
+// aggregates) are stored inline in the table, everything else is stored behind a 32 bit offset relative to the start
+// of the buffer. The layout of a table is known at compile time, therefore no vtables are needed.
+//
+//   record:   [inline fields and offsets, aligned to their natural alignment]
+//   string:   [uint32 size][characters]['\0']
+//   vector:   [uint32 size][padding][elements]    for elements of fixed size
+//             [uint32 size][uint32 offsets...]    for all other elements
+//   optional: offset 0 marks an empty optional
+//
+// Values are written in host byte order. The root table starts at offset 0 of the buffer.
+
+namespace tsmp {
+
+template<class T>
+class flat_view;
+
+template<class T>
+class flat_vector_view;
+
+namespace detail {
+
+class flat_builder_t
+{
+public:
+    [[nodiscard]] std::uint32_t allocate(std::size_t size, std::size_t alignment, std::size_t prefix = 0)
+    {
+        // aligns the position after the prefix, so that prefixed arrays start at an aligned address
+        const auto padding = (alignment - (buffer.size() + prefix) % alignment) % alignment;
+        const auto position = buffer.size() + padding;
+        if (position + prefix + size > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("Flat buffers are limited to 4GiB.");
+        }
+        buffer.resize(position + prefix + size);
+        return static_cast<std::uint32_t>(position);
+    }
+
+    void store(std::uint32_t position, const void* data, std::size_t size)
+    {
+        if (size > 0) {
+            std::memcpy(buffer.data() + position, data, size);
+        }
+    }
+
+    template<class T>
+    void store(std::uint32_t position, const T& value)
+    {
+        store(position, &value, sizeof(T));
+    }
+
+    [[nodiscard]] std::vector<std::byte> release() noexcept { return std::move(buffer); }
+
+private:
+    std::vector<std::byte> buffer;
+};
+
+template<class T>
+[[nodiscard]] T flat_load(std::span<const std::byte> buffer, std::size_t position)
+{
+    if (position > buffer.size() || buffer.size() - position < sizeof(T)) {
+        throw std::out_of_range("Flat buffer access out of range.");
+    }
+    T result;
+    std::memcpy(&result, buffer.data() + position, sizeof(T));
+    return result;
+}
+
+template<class T>
+struct flat_traits_t;
+
+template<class T>
+concept flat_inline = Arithmetic<T> || Enum<T> || binary_codec_t<T>::bitwise;
+
+template<flat_inline T>
+struct flat_traits_t<T>
+{
+    using view_type = T;
+    static constexpr std::size_t slot_size = sizeof(T);
+    static constexpr std::size_t slot_alignment = alignof(T);
+
+    [[nodiscard]] static std::uint32_t write(flat_builder_t& builder, const T& value)
+    {
+        const auto position = builder.allocate(sizeof(T), alignof(T));
+        builder.store(position, value);
+        return position;
+    }
+
+    [[nodiscard]] static view_type read(std::span<const std::byte> buffer, std::uint32_t position)
+    {
+        return flat_load<T>(buffer, position);
+    }
+};
+
+template<class T>
+struct flat_offset_slot_t
+{
+    static constexpr std::size_t slot_size = sizeof(std::uint32_t);
+    static constexpr std::size_t slot_alignment = alignof(std::uint32_t);
+};
+
+template<>
+struct flat_traits_t<std::string> : flat_offset_slot_t<std::string>
+{
+    using view_type = std::string_view;
+
+    [[nodiscard]] static std::uint32_t write(flat_builder_t& builder, const std::string& value)
+    {
+        const auto position = builder.allocate(sizeof(std::uint32_t) + value.size() + 1, alignof(std::uint32_t));
+        builder.store(position, static_cast<std::uint32_t>(value.size()));
+        builder.store(position + sizeof(std::uint32_t), value.data(), value.size());
+        return position;
+    }
+
+    [[nodiscard]] static view_type read(std::span<const std::byte> buffer, std::uint32_t position)
+    {
+        const auto size = flat_load<std::uint32_t>(buffer, position);
+        const auto begin = std::size_t{position} + sizeof(std::uint32_t);
+        if (buffer.size() - begin < size) {
+            throw std::out_of_range("Flat buffer access out of range.");
+        }
+        return std::string_view(reinterpret_cast<const char*>(buffer.data() + begin), size);
+    }
+};
+
+template<class T>
+struct flat_traits_t<std::optional<T>> : flat_offset_slot_t<std::optional<T>>
+{
+    using view_type = std::optional<typename flat_traits_t<T>::view_type>;
+
+    [[nodiscard]] static std::uint32_t write(flat_builder_t& builder, const std::optional<T>& value)
+    {
+        return value ? flat_traits_t<T>::write(builder, *value) : 0;
+    }
+
+    [[nodiscard]] static view_type read(std::span<const std::byte> buffer, std::uint32_t position)
+    {
+        if (position == 0) {
+            return std::nullopt;
+        }
+        return flat_traits_t<T>::read(buffer, position);
+    }
+};
+
+template<std::ranges::input_range Range>
+    requires(!flat_inline<Range>)
+struct flat_traits_t<Range> : flat_offset_slot_t<Range>
+{
+    using value_type = std::ranges::range_value_t<Range>;
+    static constexpr bool fixed_size_elements = flat_inline<value_type>;
+    using view_type =
+        std::conditional_t<fixed_size_elements, std::span<const value_type>, flat_vector_view<value_type>>;
+
+    [[nodiscard]] static std::uint32_t write(flat_builder_t& builder, const Range& range)
+    {
+        const auto size = static_cast<std::size_t>(std::ranges::distance(range));
+        if constexpr (fixed_size_elements) {
+            const auto position =
+                builder.allocate(size * sizeof(value_type), alignof(value_type), sizeof(std::uint32_t));
+            builder.store(position, static_cast<std::uint32_t>(size));
+            auto element_position = position + static_cast<std::uint32_t>(sizeof(std::uint32_t));
+            if constexpr (std::ranges::contiguous_range<Range>) {
+                builder.store(element_position, std::ranges::data(range), size * sizeof(value_type));
+            } else {
+                for (const value_type element : range) {
+                    builder.store(element_position, element);
+                    element_position += sizeof(value_type);
+                }
+            }
+            return position;
+        } else {
+            const auto position = builder.allocate((size + 1) * sizeof(std::uint32_t), alignof(std::uint32_t));
+            builder.store(position, static_cast<std::uint32_t>(size));
+            auto offset_position = position;
+            for (const auto& element : range) {
+                offset_position += sizeof(std::uint32_t);
+                builder.store(offset_position, flat_traits_t<value_type>::write(builder, element));
+            }
+            return position;
+        }
+    }
+
+    [[nodiscard]] static view_type read(std::span<const std::byte> buffer, std::uint32_t position)
+    {
+        const auto size = flat_load<std::uint32_t>(buffer, position);
+        const auto begin = std::size_t{position} + sizeof(std::uint32_t);
+        if constexpr (fixed_size_elements) {
+            if ((buffer.size() - begin) / sizeof(value_type) < size) {
+                throw std::out_of_range("Flat buffer access out of range.");
+            }
+            const auto* data = buffer.data() + begin;
+            if (reinterpret_cast<std::uintptr_t>(data) % alignof(value_type) != 0) {
+                throw std::runtime_error("Flat buffer is not aligned.");
+            }
+            return view_type(reinterpret_cast<const value_type*>(data), size);
+        } else {
+            if ((buffer.size() - begin) / sizeof(std::uint32_t) < size) {
+                throw std::out_of_range("Flat buffer access out of range.");
+            }
+            return view_type(buffer, position, size);
+        }
+    }
+};
+
+template<class T>
+struct flat_traits_t : flat_offset_slot_t<T>
+{
+    using view_type = flat_view<T>;
+
+    static constexpr std::size_t field_count = std::tuple_size_v<decltype(reflect<T>::fields())>;
+
+    struct table_layout_t
+    {
+        std::array<std::size_t, field_count> offsets{};
+        std::size_t size = 0;
+        std::size_t alignment = alignof(std::uint32_t);
+    };
+
+    static constexpr table_layout_t layout = []() {
+        const auto [sizes, alignments] = std::apply(
+            [](auto... decls) {
+                return std::pair{
+                    std::array<std::size_t, field_count>{
+                        flat_traits_t<typename decltype(decls)::value_type>::slot_size...},
+                    std::array<std::size_t, field_count>{
+                        flat_traits_t<typename decltype(decls)::value_type>::slot_alignment...}};
+            },
+            reflect<T>::fields());
+        table_layout_t result;
+        for (std::size_t i = 0; i < field_count; ++i) {
+            result.size = (result.size + alignments[i] - 1) / alignments[i] * alignments[i];
+            result.offsets[i] = result.size;
+            result.size += sizes[i];
+            result.alignment = std::max(result.alignment, alignments[i]);
+        }
+        return result;
+    }();
+
+    [[nodiscard]] static std::uint32_t write(flat_builder_t& builder, const T& value)
+    {
+        // the table may be empty, but every table needs a distinct position, because offset 0 marks empty optionals
+        const auto position = builder.allocate(std::max<std::size_t>(layout.size, 1), layout.alignment);
+        std::apply(
+            [&](auto... decls) {
+                (write_field<typename decltype(decls)::value_type>(
+                     builder, static_cast<std::uint32_t>(position + layout.offsets[decls.id]), value.*(decls.ptr)),
+                 ...);
+            },
+            reflect<T>::fields());
+        return position;
+    }
+
+    template<class V>
+    static void write_field(flat_builder_t& builder, std::uint32_t slot, const V& value)
+    {
+        if constexpr (flat_inline<V>) {
+            builder.store(slot, value);
+        } else {
+            // the child has to be written before the slot is stored, because writing may grow the buffer
+            const auto child = flat_traits_t<V>::write(builder, value);
+            builder.store(slot, child);
+        }
+    }
+
+    [[nodiscard]] static view_type read(std::span<const std::byte> buffer, std::uint32_t position)
+    {
+        return view_type(buffer, position);
+    }
+};
+
+}
+
+template<class T>
+class flat_view
+{
+public:
+    explicit flat_view(std::span<const std::byte> buffer, std::uint32_t position = 0)
+        : buffer(buffer)
+        , position(position)
+    {
+        if (position > buffer.size() || buffer.size() - position < traits_t::layout.size) {
+            throw std::out_of_range("Flat buffer is too small for the requested table.");
+        }
+    }
+
+    template<std::size_t id>
+    [[nodiscard]] auto get() const
+    {
+        using value_type = typename std::tuple_element_t<id, decltype(reflect<T>::fields())>::value_type;
+        const auto slot = position + traits_t::layout.offsets[id];
+        if constexpr (detail::flat_inline<value_type>) {
+            return detail::flat_load<value_type>(buffer, slot);
+        } else {
+            return detail::flat_traits_t<value_type>::read(buffer, detail::flat_load<std::uint32_t>(buffer, slot));
+        }
+    }
+
+    template<string_literal_t name>
+    [[nodiscard]] auto get() const
+    {
+        constexpr auto id = introspect<T>::field_id(name);
+        return get<id>();
+    }
+
+    [[nodiscard]] std::span<const std::byte> data() const noexcept { return buffer; }
+
+    [[nodiscard]] std::uint32_t offset() const noexcept { return position; }
+
+private:
+    using traits_t = detail::flat_traits_t<T>;
+
+    std::span<const std::byte> buffer;
+    std::uint32_t position;
+};
+
+template<class T>
+class flat_vector_view
+{
+public:
+    using value_type = typename detail::flat_traits_t<T>::view_type;
+
+    class iterator
+    {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = flat_vector_view::value_type;
+
+        iterator() = default;
+
+        iterator(const flat_vector_view* range, std::size_t index)
+            : range(range)
+            , index(index)
+        {
+        }
+
+        [[nodiscard]] value_type operator*() const { return (*range)[index]; }
+
+        iterator& operator++()
+        {
+            ++index;
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto result = *this;
+            ++index;
+            return result;
+        }
+
+        [[nodiscard]] bool operator==(const iterator& other) const noexcept { return index == other.index; }
+
+    private:
+        const flat_vector_view* range = nullptr;
+        std::size_t index = 0;
+    };
+
+    flat_vector_view(std::span<const std::byte> buffer, std::uint32_t position, std::size_t size)
+        : buffer(buffer)
+        , position(position)
+        , count(size)
+    {
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return count; }
+
+    [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+    [[nodiscard]] value_type operator[](std::size_t index) const
+    {
+        const auto slot = position + (index + 1) * sizeof(std::uint32_t);
+        return detail::flat_traits_t<T>::read(buffer, detail::flat_load<std::uint32_t>(buffer, slot));
+    }
+
+    [[nodiscard]] iterator begin() const { return iterator(this, 0); }
+
+    [[nodiscard]] iterator end() const { return iterator(this, count); }
+
+private:
+    std::span<const std::byte> buffer;
+    std::uint32_t position;
+    std::size_t count;
+};
+
+template<class T>
+[[nodiscard]] std::vector<std::byte> to_flat(const T& value)
+{
+    detail::flat_builder_t builder;
+    [[maybe_unused]] const auto root = detail::flat_traits_t<T>::write(builder, value);
+    return builder.release();
+}
+
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "reflect.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Hashing of reflected values, e.g. std::unordered_map<key_t, value_t, tsmp::hash<key_t>>. Records whose equal values
+// have equal bytes (std::has_unique_object_representations_v, i.e. no padding and no floating point fields) are hashed
+// as one block of bytes with MurmurHash64A. Other records combine the hashes of their fields, which may be arithmetic
+// types, enums, strings, optionals, ranges or nested records. Floating point fields hash 0.0 and -0.0 alike.
+
+namespace tsmp {
+
+namespace detail {
+
+inline constexpr std::uint64_t hash_multiplier = 0xc6a4a7935bd1e995;
+
+// final mix of MurmurHash3, every input bit affects every output bit
+[[nodiscard]] constexpr std::uint64_t hash_mix(std::uint64_t value) noexcept
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccd;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53;
+    value ^= value >> 33;
+    return value;
+}
+
+[[nodiscard]] constexpr std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t value) noexcept
+{
+    return hash_mix(seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2)));
+}
+
+// MurmurHash64A, the size is a compile-time constant for records, so the loop is unrolled
+[[nodiscard]] inline std::uint64_t hash_bytes(const std::byte* data, std::size_t size) noexcept
+{
+    std::uint64_t result = 0x8445d61a4e774912 ^ (size * hash_multiplier);
+    for (; size >= 8; size -= 8, data += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data, 8);
+        word *= hash_multiplier;
+        word ^= word >> 47;
+        word *= hash_multiplier;
+        result ^= word;
+        result *= hash_multiplier;
+    }
+    if (size > 0) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data, size);
+        result ^= word;
+        result *= hash_multiplier;
+    }
+    result ^= result >> 47;
+    result *= hash_multiplier;
+    result ^= result >> 47;
+    return result;
+}
+
+template<class V>
+concept hash_record = reflect<V>::reflectable;
+
+template<class V>
+[[nodiscard]] std::uint64_t hash_value(const V& value);
+
+template<class V>
+[[nodiscard]] std::uint64_t hash_fields(const V& value)
+{
+    return std::apply(
+        [&](const auto&... decls) {
+            std::uint64_t result = 0;
+            ((result = hash_combine(result, hash_value(value.*decls.ptr))), ...);
+            return result;
+        },
+        reflect<V>::fields());
+}
+
+template<class V>
+[[nodiscard]] std::uint64_t hash_value(const V& value)
+{
+    if constexpr (std::is_same_v<V, bool>) {
+        return hash_mix(value ? 1 : 0);
+    } else if constexpr (std::integral<V> || Enum<V>) {
+        return hash_mix(static_cast<std::uint64_t>(value));
+    } else if constexpr (std::floating_point<V> && (sizeof(V) == 4 || sizeof(V) == 8)) {
+        using bits_t = std::conditional_t<sizeof(V) == 4, std::uint32_t, std::uint64_t>;
+        return hash_mix(value == V{0} ? 0 : std::bit_cast<bits_t>(value));
+    } else if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+        return std::hash<std::string_view>{}(std::string_view(value));
+    } else if constexpr (is_optional<V>) {
+        return value ? hash_combine(1, hash_value(*value)) : 0;
+    } else if constexpr (std::ranges::range<V>) {
+        std::uint64_t result = 0;
+        std::uint64_t size = 0;
+        for (const auto& element : value) {
+            result = hash_combine(result, hash_value(element));
+            ++size;
+        }
+        return hash_combine(result, size);
+    } else if constexpr (std::has_unique_object_representations_v<V>) {
+        return hash_bytes(reinterpret_cast<const std::byte*>(&value), sizeof(V));
+    } else {
+        static_assert(hash_record<V>, "The type is not supported by tsmp::hash.");
+        return hash_fields(value);
+    }
+}
+
+}
+
+template<class T>
+struct hash
+{
+    [[nodiscard]] std::size_t operator()(const T& value) const
+    {
+        return static_cast<std::size_t>(detail::hash_value(value));
+    }
+};
+
+// Hashes all values into hashes, which must have the same size. Records are hashed independently of each other, so
+// the hashes of consecutive records are computed in parallel by the pipeline of the CPU.
+template<class T>
+void hash_many(std::span<const T> values, std::span<std::size_t> hashes)
+{
+    if (values.size() != hashes.size()) {
+        throw std::out_of_range("hash_many needs one hash per value.");
+    }
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        hashes[i] = static_cast<std::size_t>(detail::hash_value(values[i]));
+    }
+}
+
+template<class T>
+[[nodiscard]] std::vector<std::size_t> hash_many(std::span<const T> values)
+{
+    std::vector<std::size_t> hashes(values.size());
+    hash_many(values, std::span<std::size_t>(hashes));
+    return hashes;
+}
+
+}
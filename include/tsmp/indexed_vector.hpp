@@ -0,0 +1,314 @@
+#pragma once
+
+#include "introspect.hpp"
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A vector of reflected records with secondary indexes on some of their fields, e.g.
+//   tsmp::indexed_vector<order_t, tsmp::hash_index<"id">, tsmp::ordered_index<"ts">>
+// Hash indexes find records by key in constant time, ordered indexes additionally find key ranges in logarithmic
+// time. Both allow duplicate keys. Records are accessed by position and can only be modified through update, which
+// keeps the indexes in sync. Erasing a record moves the last record into its position.
+
+namespace tsmp {
+
+template<string_literal_t field>
+struct hash_index
+{};
+
+template<string_literal_t field>
+struct ordered_index
+{};
+
+namespace detail {
+
+// maps the keys of one field to the positions of the records
+template<class T, string_literal_t field, class Map, bool is_ordered>
+struct indexed_map_t
+{
+    static constexpr std::string_view name = field;
+    static constexpr bool ordered = is_ordered;
+    using key_type = field_type_t<T, field>;
+
+    Map map;
+
+    [[nodiscard]] static const key_type& key(const T& record) noexcept
+    {
+        return record.*field_pointer<T, field>;
+    }
+
+    void insert(const T& record, std::size_t position) { map.emplace(key(record), position); }
+
+    void erase(const key_type& key, std::size_t position)
+    {
+        const auto [first, last] = map.equal_range(key);
+        for (auto entry = first; entry != last; ++entry) {
+            if (entry->second == position) {
+                map.erase(entry);
+                return;
+            }
+        }
+    }
+
+    void move(const T& record, std::size_t from, std::size_t to)
+    {
+        const auto [first, last] = map.equal_range(key(record));
+        for (auto entry = first; entry != last; ++entry) {
+            if (entry->second == from) {
+                entry->second = to;
+                return;
+            }
+        }
+    }
+
+    void rebuild(const std::vector<T>& records)
+    {
+        map.clear();
+        if constexpr (!is_ordered) {
+            map.reserve(records.size());
+        }
+        for (std::size_t position = 0; position < records.size(); ++position) {
+            insert(records[position], position);
+        }
+    }
+};
+
+template<class T, class Index>
+struct indexed_storage;
+
+template<class T, string_literal_t field>
+struct indexed_storage<T, hash_index<field>>
+{
+    using type = indexed_map_t<T, field, std::unordered_multimap<field_type_t<T, field>, std::size_t>, false>;
+};
+
+template<class T, string_literal_t field>
+struct indexed_storage<T, ordered_index<field>>
+{
+    using type = indexed_map_t<T, field, std::multimap<field_type_t<T, field>, std::size_t>, true>;
+};
+
+template<class T, class Index>
+using indexed_storage_t = typename indexed_storage<T, Index>::type;
+
+}
+
+template<class T, class... Indexes>
+class indexed_vector
+{
+    using indexes_t = std::tuple<detail::indexed_storage_t<T, Indexes>...>;
+
+    // position of the first index on the field, ordered_only skips hash indexes
+    template<string_literal_t field, bool ordered_only>
+    static constexpr std::size_t index_of = [] {
+        std::size_t position = 0;
+        const bool found = (((detail::indexed_storage_t<T, Indexes>::name == std::string_view(field) &&
+                              (!ordered_only || detail::indexed_storage_t<T, Indexes>::ordered))
+                                 ? true
+                                 : (++position, false)) ||
+                            ...);
+        return found ? position : sizeof...(Indexes);
+    }();
+
+    template<string_literal_t field, bool ordered_only = false>
+    [[nodiscard]] const auto& index() const
+    {
+        static_assert(index_of<field, ordered_only> < sizeof...(Indexes), "The field has no index of this kind.");
+        if (batching) {
+            throw std::logic_error("The indexes are not up to date during a batch.");
+        }
+        return std::get<index_of<field, ordered_only>>(indexes).map;
+    }
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    indexed_vector() = default;
+
+    template<std::ranges::input_range Range>
+    explicit indexed_vector(const Range& range)
+    {
+        append(range);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return records.size(); }
+    [[nodiscard]] bool empty() const noexcept { return records.empty(); }
+    [[nodiscard]] const T& operator[](std::size_t position) const noexcept { return records[position]; }
+    [[nodiscard]] const_iterator begin() const noexcept { return records.begin(); }
+    [[nodiscard]] const_iterator end() const noexcept { return records.end(); }
+
+    void reserve(std::size_t capacity) { records.reserve(capacity); }
+
+    // Appends the record and returns its position.
+    std::size_t push_back(T record)
+    {
+        records.push_back(std::move(record));
+        const auto position = records.size() - 1;
+        if (!batching) {
+            std::apply([&](auto&... index) { (index.insert(records.back(), position), ...); }, indexes);
+        }
+        return position;
+    }
+
+    // Appends all records and rebuilds the indexes once.
+    template<std::ranges::input_range Range>
+    void append(const Range& range)
+    {
+        const batch_guard_t guard{*this, std::exchange(batching, true)};
+        if constexpr (std::ranges::sized_range<Range>) {
+            records.reserve(records.size() + std::ranges::size(range));
+        }
+        for (const auto& record : range) {
+            records.push_back(record);
+        }
+        if (!guard.was_batching) {
+            end_batch();
+        }
+    }
+
+    // Calls function with a reference to the record and updates the indexes of the fields it changed.
+    template<class Function>
+    void update(std::size_t position, Function&& function)
+    {
+        if (batching) {
+            function(records.at(position));
+            return;
+        }
+        auto& record = records.at(position);
+        const auto keys = std::apply([&](const auto&... index) { return std::tuple(index.key(record)...); }, indexes);
+        function(record);
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            (update_index(std::get<id>(indexes), std::get<id>(keys), position), ...);
+        }(std::index_sequence_for<Indexes...>{});
+    }
+
+    void replace(std::size_t position, T record)
+    {
+        update(position, [&](T& current) { current = std::move(record); });
+    }
+
+    // Removes the record by moving the last record into its position.
+    void erase(std::size_t position)
+    {
+        const auto last = records.size() - 1;
+        if (!batching) {
+            std::apply(
+                [&](auto&... index) {
+                    (index.erase(index.key(records.at(position)), position), ...);
+                    if (position != last) {
+                        (index.move(records[last], last, position), ...);
+                    }
+                },
+                indexes);
+        }
+        if (position != last) {
+            records.at(position) = std::move(records[last]);
+        }
+        records.pop_back();
+    }
+
+    void clear() noexcept
+    {
+        records.clear();
+        std::apply([](auto&... index) { (index.map.clear(), ...); }, indexes);
+    }
+
+    // Defers all index maintenance until end_batch, which rebuilds the indexes once. Lookups throw std::logic_error
+    // until then.
+    void begin_batch() noexcept { batching = true; }
+
+    void end_batch()
+    {
+        std::apply([&](auto&... index) { (index.rebuild(records), ...); }, indexes);
+        batching = false;
+    }
+
+    // Position of a record with the key, if there is one.
+    template<string_literal_t field>
+    [[nodiscard]] std::optional<std::size_t> find(const detail::field_type_t<T, field>& key) const
+    {
+        const auto& map = index<field>();
+        const auto entry = map.find(key);
+        return entry == map.end() ? std::nullopt : std::optional(entry->second);
+    }
+
+    template<string_literal_t field>
+    [[nodiscard]] bool contains(const detail::field_type_t<T, field>& key) const
+    {
+        return index<field>().contains(key);
+    }
+
+    // Positions of all records with the key, in key order for ordered indexes.
+    template<string_literal_t field>
+    [[nodiscard]] std::vector<std::size_t> find_all(const detail::field_type_t<T, field>& key) const
+    {
+        const auto [first, last] = index<field>().equal_range(key);
+        std::vector<std::size_t> result;
+        for (auto entry = first; entry != last; ++entry) {
+            result.push_back(entry->second);
+        }
+        return result;
+    }
+
+    // Positions of all records with keys in [lower, upper], ordered by key.
+    template<string_literal_t field>
+    [[nodiscard]] std::vector<std::size_t> range(const detail::field_type_t<T, field>& lower,
+                                                 const detail::field_type_t<T, field>& upper) const
+    {
+        const auto& map = index<field, true>();
+        std::vector<std::size_t> result;
+        for (auto entry = map.lower_bound(lower); entry != map.end() && !(upper < entry->first); ++entry) {
+            result.push_back(entry->second);
+        }
+        return result;
+    }
+
+private:
+    // Ends a batch that append started when a record fails to copy. If the indexes can not be rebuilt either, the
+    // batch stays open and lookups keep throwing until end_batch succeeds.
+    struct batch_guard_t
+    {
+        indexed_vector& vector;
+        bool was_batching;
+
+        ~batch_guard_t()
+        {
+            if (!was_batching && vector.batching) {
+                try {
+                    vector.end_batch();
+                } catch (...) {
+                }
+            }
+        }
+    };
+
+    template<class Index, class Key>
+    void update_index(Index& index, const Key& old_key, std::size_t position)
+    {
+        const auto& record = records[position];
+        if (!(Index::key(record) == old_key)) {
+            index.erase(old_key, position);
+            index.insert(record, position);
+        }
+    }
+
+    std::vector<T> records;
+    indexes_t indexes;
+    bool batching = false;
+};
+
+}
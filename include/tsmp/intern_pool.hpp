@@ -0,0 +1,144 @@
+#pragma once
+
+#include "compare.hpp"
+#include "hash.hpp"
+#include "reflect.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+
+// Hash-consing of reflected values. intern_pool<T> stores every distinct value once and hands out interned<T>
+// handles to it. Values are hashed and compared memberwise through reflection, so T needs neither std::hash nor
+// operator==. Handles to equal values point to the same object, which makes comparing and hashing handles a pointer
+// operation.
+
+namespace tsmp {
+
+namespace detail {
+
+// hash and equality of the pooled values, which can be looked up by a plain T as well
+template<class T>
+struct intern_traits_t
+{
+    using is_transparent = void;
+
+    [[nodiscard]] std::size_t operator()(const T& value) const { return hash<T>{}(value); }
+    [[nodiscard]] std::size_t operator()(const std::shared_ptr<const T>& value) const { return hash<T>{}(*value); }
+
+    [[nodiscard]] static const T& get(const T& value) noexcept { return value; }
+    [[nodiscard]] static const T& get(const std::shared_ptr<const T>& value) noexcept { return *value; }
+
+    template<class L, class R>
+    [[nodiscard]] bool operator()(const L& lhs, const R& rhs) const
+    {
+        return tsmp::equal(get(lhs), get(rhs));
+    }
+};
+
+}
+
+template<class T>
+class intern_pool;
+
+// Handle to a value of an intern_pool. The value stays alive as long as a handle or the pool refers to it.
+template<class T>
+class interned
+{
+public:
+    using value_type = T;
+
+    // an empty handle, which may only be assigned to or compared
+    interned() noexcept = default;
+
+    [[nodiscard]] const T& operator*() const noexcept { return *value; }
+    [[nodiscard]] const T* operator->() const noexcept { return value.get(); }
+    [[nodiscard]] const T* get() const noexcept { return value.get(); }
+
+    // handles of the same pool are equal if and only if their values are
+    [[nodiscard]] friend bool operator==(const interned& lhs, const interned& rhs) noexcept = default;
+
+private:
+    friend class intern_pool<T>;
+
+    explicit interned(std::shared_ptr<const T> value) noexcept
+        : value(std::move(value))
+    {}
+
+    std::shared_ptr<const T> value;
+};
+
+// Stores each distinct value once. intern is thread safe.
+template<class T>
+class intern_pool
+{
+public:
+    using value_type = T;
+
+    // Returns the handle to the pooled value equal to value, which is added if there is none.
+    [[nodiscard]] interned<T> intern(const T& value)
+    {
+        std::lock_guard lock(mutex);
+        if (const auto entry = values.find(value); entry != values.end()) {
+            return interned<T>(*entry);
+        }
+        return interned<T>(*values.insert(std::make_shared<const T>(value)).first);
+    }
+
+    [[nodiscard]] interned<T> intern(T&& value)
+    {
+        std::lock_guard lock(mutex);
+        if (const auto entry = values.find(value); entry != values.end()) {
+            return interned<T>(*entry);
+        }
+        return interned<T>(*values.insert(std::make_shared<const T>(std::move(value))).first);
+    }
+
+    [[nodiscard]] bool contains(const T& value) const
+    {
+        std::lock_guard lock(mutex);
+        return values.contains(value);
+    }
+
+    // Number of distinct values in the pool.
+    [[nodiscard]] std::size_t size() const
+    {
+        std::lock_guard lock(mutex);
+        return values.size();
+    }
+
+    // Removes the values without handles and returns how many were removed.
+    std::size_t collect()
+    {
+        std::lock_guard lock(mutex);
+        return std::erase_if(values, [](const auto& value) { return value.use_count() == 1; });
+    }
+
+    // Removes all values from the pool. Existing handles stay valid, but equal values interned afterwards get
+    // a different handle.
+    void clear()
+    {
+        std::lock_guard lock(mutex);
+        values.clear();
+    }
+
+private:
+    using traits_t = detail::intern_traits_t<T>;
+
+    mutable std::mutex mutex;
+    std::unordered_set<std::shared_ptr<const T>, traits_t, traits_t> values;
+};
+
+}
+
+template<class T>
+struct std::hash<tsmp::interned<T>>
+{
+    [[nodiscard]] std::size_t operator()(const tsmp::interned<T>& handle) const noexcept
+    {
+        return std::hash<const T*>{}(handle.get());
+    }
+};
@@ -8,6 +8,7 @@
 #include <stdexcept>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 #include <variant>
 
 namespace tsmp {
@@ -284,4 +285,15 @@ struct introspect
             reflect<T>::fields());
     }
 };
+
+namespace detail {
+
+// member pointer and type of the field with the name
+template<class T, string_literal_t name>
+inline constexpr auto field_pointer = std::get<introspect<T>::field_id(name)>(reflect<T>::fields()).ptr;
+
+template<class T, string_literal_t name>
+using field_type_t = std::remove_cvref_t<decltype(std::declval<const T&>().*field_pointer<T, name>)>;
+
+}
 }
\ No newline at end of file
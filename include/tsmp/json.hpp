@@ -18,16 +18,11 @@
 #include <type_traits>
 
 #include <nlohmann/json.hpp>
+#include <tsmp/error_handler.hpp>
 #include <tsmp/introspect.hpp>
 
 namespace tsmp {
 
-template<class T>
-concept Arithmetic = std::floating_point<T> || std::integral<T>;
-
-template<class T>
-concept is_optional = std::is_same_v<T, std::optional<typename T::value_type>>;
-
 template<auto value>
 struct immutable_t
 {
@@ -130,20 +125,6 @@ template<class... Ts>
 
 namespace detail {
 
-template<class T>
-struct throw_handler_t
-{
-    using value_type = T;
-    T operator()(std::string msg) { throw std::runtime_error(std::move(msg)); }
-};
-
-template<class T>
-struct nullopt_handler_t
-{
-    using value_type = std::optional<T>;
-    std::optional<T> operator()(std::string) { return std::nullopt; }
-};
-
 template<class T, template<class> class ErrorHandler>
 struct from_json_t;
 
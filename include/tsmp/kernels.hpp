@@ -0,0 +1,257 @@
+#pragma once
+
+#include "reflect.hpp"
+#include "soa_vector.hpp"
+#include "string_literal.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Aggregation kernels over the columns of a soa_vector. The loops are split into independent lanes without data
+// dependent branches, which lets the compiler vectorize them for the instruction set the program is compiled for
+// (e.g. -mavx2 or -march=native). Predicates should be simple comparisons, like the ones provided below, to keep
+// the loops vectorizable. The kernels live in tsmp::kernels, e.g. tsmp::kernels::count_if<"latency">(requests,
+// tsmp::kernels::greater{2.0}), to keep names like sum, min and select out of the tsmp namespace.
+
+namespace tsmp {
+
+namespace detail {
+
+inline constexpr std::size_t kernel_lanes = 16;
+
+template<class V>
+using kernel_sum_t = std::conditional_t<std::floating_point<V>,
+                                        double,
+                                        std::conditional_t<std::is_signed_v<V>, std::int64_t, std::uint64_t>>;
+
+template<class Accumulator, class V>
+[[nodiscard]] Accumulator kernel_sum(std::span<const V> column) noexcept
+{
+    std::array<Accumulator, kernel_lanes> lanes{};
+    const auto blocked = column.size() - column.size() % kernel_lanes;
+    for (std::size_t i = 0; i < blocked; i += kernel_lanes) {
+        for (std::size_t lane = 0; lane < kernel_lanes; ++lane) {
+            lanes[lane] += static_cast<Accumulator>(column[i + lane]);
+        }
+    }
+    Accumulator result{};
+    for (std::size_t i = blocked; i < column.size(); ++i) {
+        result += static_cast<Accumulator>(column[i]);
+    }
+    for (const auto lane : lanes) {
+        result += lane;
+    }
+    return result;
+}
+
+template<class V, class Select>
+[[nodiscard]] std::optional<V> kernel_reduce(std::span<const V> column, Select select) noexcept
+{
+    if (column.empty()) {
+        return std::nullopt;
+    }
+    std::array<V, kernel_lanes> lanes;
+    lanes.fill(column[0]);
+    const auto blocked = column.size() - column.size() % kernel_lanes;
+    for (std::size_t i = 0; i < blocked; i += kernel_lanes) {
+        for (std::size_t lane = 0; lane < kernel_lanes; ++lane) {
+            lanes[lane] = select(lanes[lane], column[i + lane]);
+        }
+    }
+    auto result = column[0];
+    for (std::size_t i = blocked; i < column.size(); ++i) {
+        result = select(result, column[i]);
+    }
+    for (const auto lane : lanes) {
+        result = select(result, lane);
+    }
+    return result;
+}
+
+template<class V, class Predicate>
+[[nodiscard]] std::size_t kernel_count_if(std::span<const V> column, Predicate predicate)
+{
+    std::array<std::size_t, kernel_lanes> lanes{};
+    const auto blocked = column.size() - column.size() % kernel_lanes;
+    for (std::size_t i = 0; i < blocked; i += kernel_lanes) {
+        for (std::size_t lane = 0; lane < kernel_lanes; ++lane) {
+            lanes[lane] += static_cast<std::size_t>(static_cast<bool>(predicate(column[i + lane])));
+        }
+    }
+    std::size_t result = 0;
+    for (std::size_t i = blocked; i < column.size(); ++i) {
+        result += static_cast<std::size_t>(static_cast<bool>(predicate(column[i])));
+    }
+    for (const auto lane : lanes) {
+        result += lane;
+    }
+    return result;
+}
+
+// every index is written and the output position only advances on a match, which avoids mispredicted branches
+template<class V, class Predicate>
+[[nodiscard]] std::vector<std::size_t> kernel_select(std::span<const V> column, Predicate predicate)
+{
+    std::vector<std::size_t> selection(column.size());
+    std::size_t selected = 0;
+    for (std::size_t i = 0; i < column.size(); ++i) {
+        selection[selected] = i;
+        selected += static_cast<std::size_t>(static_cast<bool>(predicate(column[i])));
+    }
+    selection.resize(selected);
+    return selection;
+}
+
+template<class V, class Predicate>
+[[nodiscard]] std::vector<std::size_t> kernel_refine(std::span<const V> column,
+                                                     std::span<const std::size_t> selection,
+                                                     Predicate predicate)
+{
+    std::vector<std::size_t> result(selection.size());
+    std::size_t selected = 0;
+    for (const auto index : selection) {
+        result[selected] = index;
+        selected += static_cast<std::size_t>(static_cast<bool>(predicate(column[index])));
+    }
+    result.resize(selected);
+    return result;
+}
+
+}
+
+namespace kernels {
+
+// comparison predicates for count_if and select
+template<class V>
+struct less
+{
+    V value;
+    [[nodiscard]] constexpr bool operator()(const V& element) const noexcept { return element < value; }
+};
+
+template<class V>
+less(V) -> less<V>;
+
+template<class V>
+struct less_equal
+{
+    V value;
+    [[nodiscard]] constexpr bool operator()(const V& element) const noexcept { return element <= value; }
+};
+
+template<class V>
+less_equal(V) -> less_equal<V>;
+
+template<class V>
+struct greater
+{
+    V value;
+    [[nodiscard]] constexpr bool operator()(const V& element) const noexcept { return element > value; }
+};
+
+template<class V>
+greater(V) -> greater<V>;
+
+template<class V>
+struct greater_equal
+{
+    V value;
+    [[nodiscard]] constexpr bool operator()(const V& element) const noexcept { return element >= value; }
+};
+
+template<class V>
+greater_equal(V) -> greater_equal<V>;
+
+template<class V>
+struct equal_to
+{
+    V value;
+    [[nodiscard]] constexpr bool operator()(const V& element) const noexcept { return element == value; }
+};
+
+template<class V>
+equal_to(V) -> equal_to<V>;
+
+template<class V>
+struct not_equal_to
+{
+    V value;
+    [[nodiscard]] constexpr bool operator()(const V& element) const noexcept { return element != value; }
+};
+
+template<class V>
+not_equal_to(V) -> not_equal_to<V>;
+
+template<class V>
+struct between
+{
+    V lower;
+    V upper;
+    [[nodiscard]] constexpr bool operator()(const V& element) const noexcept
+    {
+        return (element >= lower) & (element <= upper);
+    }
+};
+
+template<class V>
+between(V, V) -> between<V>;
+
+// Sums the column in double for floating point fields and in 64 bit integers otherwise.
+template<string_literal_t field, class T>
+[[nodiscard]] auto sum(const soa_vector<T>& vector) noexcept
+{
+    const auto column = vector.template column<field>();
+    using value_type = typename decltype(column)::value_type;
+    static_assert(Arithmetic<value_type>, "sum requires an arithmetic field.");
+    return detail::kernel_sum<detail::kernel_sum_t<value_type>>(column);
+}
+
+template<string_literal_t field, class T>
+[[nodiscard]] auto min(const soa_vector<T>& vector) noexcept
+{
+    const auto column = vector.template column<field>();
+    using value_type = typename decltype(column)::value_type;
+    return detail::kernel_reduce(
+        column, [](const value_type& lhs, const value_type& rhs) { return rhs < lhs ? rhs : lhs; });
+}
+
+template<string_literal_t field, class T>
+[[nodiscard]] auto max(const soa_vector<T>& vector) noexcept
+{
+    const auto column = vector.template column<field>();
+    using value_type = typename decltype(column)::value_type;
+    return detail::kernel_reduce(
+        column, [](const value_type& lhs, const value_type& rhs) { return lhs < rhs ? rhs : lhs; });
+}
+
+template<string_literal_t field, class T, class Predicate>
+[[nodiscard]] std::size_t count_if(const soa_vector<T>& vector, Predicate predicate)
+{
+    return detail::kernel_count_if(vector.template column<field>(), predicate);
+}
+
+// Returns the ascending indices of the elements whose field satisfies the predicate.
+template<string_literal_t field, class T, class Predicate>
+[[nodiscard]] std::vector<std::size_t> select(const soa_vector<T>& vector, Predicate predicate)
+{
+    return detail::kernel_select(vector.template column<field>(), predicate);
+}
+
+// Narrows a previous selection to the elements whose field satisfies the predicate as well.
+template<string_literal_t field, class T, class Predicate>
+[[nodiscard]] std::vector<std::size_t> select(const soa_vector<T>& vector,
+                                              std::span<const std::size_t> selection,
+                                              Predicate predicate)
+{
+    return detail::kernel_refine(vector.template column<field>(), selection, predicate);
+}
+
+}
+
+}
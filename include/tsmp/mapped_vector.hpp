@@ -0,0 +1,407 @@
+#pragma once
+
+#include "flat.hpp"
+#include "introspect.hpp"
+#include "reflect.hpp"
+#include "schema_hash.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A mapped vector is a file of reflected records that is accessed through mmap without parsing.
+//
+//   header: [magic][version][byte order][schema_hash<T>][slot size][count][slot offset][heap offset][heap size]
+//   slots:  count fixed size slots, one per record, 64 byte aligned
+//   heap:   strings and ranges referenced by [uint64 offset][uint64 size] from their slot, 64 byte aligned
+//
+// Fields of fixed size (arithmetic values, enums and bitwise aggregates) are stored inline in the slot at their
+// natural alignment, strings and ranges of fixed size values are stored in the heap. Values are written in host
+// byte order, files with another byte order or another schema are rejected when they are opened.
+
+namespace tsmp {
+
+namespace detail {
+
+inline constexpr std::array<char, 8> mapped_magic{'T', 'S', 'M', 'P', 'V', 'E', 'C', '\0'};
+inline constexpr std::uint32_t mapped_version = 1;
+inline constexpr std::uint32_t mapped_byte_order = 0x01020304;
+inline constexpr std::uint64_t mapped_section_alignment = 64;
+
+struct mapped_header_t
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t schema;
+    std::uint64_t slot_size;
+    std::uint64_t count;
+    std::uint64_t slot_offset;
+    std::uint64_t heap_offset;
+    std::uint64_t heap_size;
+};
+
+static_assert(sizeof(mapped_header_t) == 64 && std::is_trivially_copyable_v<mapped_header_t>);
+
+struct mapped_extent_t
+{
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+[[nodiscard]] constexpr std::uint64_t mapped_align(std::uint64_t position, std::uint64_t alignment) noexcept
+{
+    return (position + alignment - 1) / alignment * alignment;
+}
+
+inline void mapped_pad(std::ostream& stream, std::uint64_t& position, std::uint64_t alignment)
+{
+    static constexpr std::array<char, mapped_section_alignment> zeros{};
+    const auto aligned = mapped_align(position, alignment);
+    for (auto padding = aligned - position; padding > 0;) {
+        const auto chunk = std::min<std::uint64_t>(padding, zeros.size());
+        stream.write(zeros.data(), static_cast<std::streamsize>(chunk));
+        padding -= chunk;
+    }
+    position = aligned;
+}
+
+template<class T>
+struct mapped_traits_t
+{
+    static_assert(sizeof(T) == 0,
+                  "Mapped vectors support fields of fixed size, strings and ranges of fixed size values only.");
+};
+
+template<flat_inline T>
+struct mapped_traits_t<T>
+{
+    using view_type = T;
+    static constexpr std::size_t slot_size = sizeof(T);
+    static constexpr std::size_t slot_alignment = alignof(T);
+
+    static void write_slot(std::byte* slot, const T& value, std::uint64_t&) { std::memcpy(slot, &value, sizeof(T)); }
+
+    static void write_heap(std::ostream&, const T&, std::uint64_t&) {}
+
+    [[nodiscard]] static view_type read(const std::byte* slot, std::span<const std::byte>)
+    {
+        T result;
+        std::memcpy(&result, slot, sizeof(T));
+        return result;
+    }
+
+    [[nodiscard]] static T materialize(view_type value) { return value; }
+};
+
+template<std::ranges::forward_range Range>
+    requires(!flat_inline<Range> && flat_inline<std::ranges::range_value_t<Range>>)
+struct mapped_traits_t<Range>
+{
+    using element_type = std::ranges::range_value_t<Range>;
+    using view_type = std::conditional_t<std::is_same_v<Range, std::string>,
+                                         std::string_view,
+                                         std::span<const element_type>>;
+    static constexpr std::size_t slot_size = sizeof(mapped_extent_t);
+    static constexpr std::size_t slot_alignment = alignof(mapped_extent_t);
+
+    // the slots are written before the heap, so the heap position of every range is planned ahead
+    static void write_slot(std::byte* slot, const Range& range, std::uint64_t& heap_position)
+    {
+        const auto size = static_cast<std::uint64_t>(std::ranges::distance(range));
+        const mapped_extent_t extent{mapped_align(heap_position, alignof(element_type)), size};
+        heap_position = extent.offset + size * sizeof(element_type);
+        std::memcpy(slot, &extent, sizeof(extent));
+    }
+
+    static void write_heap(std::ostream& stream, const Range& range, std::uint64_t& heap_position)
+    {
+        mapped_pad(stream, heap_position, alignof(element_type));
+        if constexpr (std::ranges::contiguous_range<Range>) {
+            const auto size = static_cast<std::uint64_t>(std::ranges::size(range)) * sizeof(element_type);
+            stream.write(reinterpret_cast<const char*>(std::ranges::data(range)), static_cast<std::streamsize>(size));
+            heap_position += size;
+        } else {
+            for (const element_type element : range) {
+                stream.write(reinterpret_cast<const char*>(&element), sizeof(element_type));
+                heap_position += sizeof(element_type);
+            }
+        }
+    }
+
+    [[nodiscard]] static view_type read(const std::byte* slot, std::span<const std::byte> heap)
+    {
+        mapped_extent_t extent;
+        std::memcpy(&extent, slot, sizeof(extent));
+        if (extent.offset % alignof(element_type) != 0 || extent.offset > heap.size() ||
+            (heap.size() - extent.offset) / sizeof(element_type) < extent.size) {
+            throw std::out_of_range("Mapped vector heap access out of range.");
+        }
+        const auto* data = reinterpret_cast<const element_type*>(heap.data() + extent.offset);
+        return view_type(data, static_cast<std::size_t>(extent.size));
+    }
+
+    [[nodiscard]] static Range materialize(view_type value) { return Range(value.begin(), value.end()); }
+};
+
+template<class T>
+struct mapped_layout_t
+{
+    static constexpr std::size_t field_count = std::tuple_size_v<decltype(reflect<T>::fields())>;
+
+    std::array<std::size_t, field_count> offsets{};
+    std::size_t size = 0;
+    std::size_t alignment = 1;
+};
+
+template<class T>
+constexpr mapped_layout_t<T> mapped_layout = []() {
+    constexpr auto field_count = mapped_layout_t<T>::field_count;
+    const auto [sizes, alignments] = std::apply(
+        [](auto... decls) {
+            return std::pair{
+                std::array<std::size_t, field_count>{
+                    mapped_traits_t<typename decltype(decls)::value_type>::slot_size...},
+                std::array<std::size_t, field_count>{
+                    mapped_traits_t<typename decltype(decls)::value_type>::slot_alignment...}};
+        },
+        reflect<T>::fields());
+    mapped_layout_t<T> result;
+    for (std::size_t i = 0; i < field_count; ++i) {
+        result.size = mapped_align(result.size, alignments[i]);
+        result.offsets[i] = result.size;
+        result.size += sizes[i];
+        result.alignment = std::max(result.alignment, alignments[i]);
+    }
+    // consecutive slots have to keep every field aligned
+    result.size = mapped_align(result.size, result.alignment);
+    return result;
+}();
+
+}
+
+template<class T>
+class mapped_vector
+{
+public:
+    using value_type = T;
+
+    explicit mapped_vector(const std::filesystem::path& path)
+    {
+        const int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("Could not open mapped vector file " + path.string() + ".");
+        }
+        struct stat status;
+        if (::fstat(descriptor, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(header_t)) {
+            ::close(descriptor);
+            throw std::runtime_error("Mapped vector file " + path.string() + " is too small.");
+        }
+        const auto file_size = static_cast<std::size_t>(status.st_size);
+        void* address = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        ::close(descriptor);
+        if (address == MAP_FAILED) {
+            throw std::runtime_error("Could not map mapped vector file " + path.string() + ".");
+        }
+        mapping = std::span(static_cast<const std::byte*>(address), file_size);
+        try {
+            validate();
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    mapped_vector(const mapped_vector&) = delete;
+    mapped_vector& operator=(const mapped_vector&) = delete;
+
+    mapped_vector(mapped_vector&& other) noexcept
+        : mapping(std::exchange(other.mapping, {}))
+        , slots(std::exchange(other.slots, {}))
+        , heap(std::exchange(other.heap, {}))
+        , count(std::exchange(other.count, 0))
+    {
+    }
+
+    mapped_vector& operator=(mapped_vector&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            mapping = std::exchange(other.mapping, {});
+            slots = std::exchange(other.slots, {});
+            heap = std::exchange(other.heap, {});
+            count = std::exchange(other.count, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_vector() { unmap(); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return count; }
+
+    [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+    template<std::size_t id>
+    [[nodiscard]] auto get(std::size_t index) const
+    {
+        using field_type = typename std::tuple_element_t<id, decltype(reflect<T>::fields())>::value_type;
+        return detail::mapped_traits_t<field_type>::read(slot(index) + layout.offsets[id], heap);
+    }
+
+    template<string_literal_t name>
+    [[nodiscard]] auto get(std::size_t index) const
+    {
+        constexpr auto id = introspect<T>::field_id(name);
+        return get<id>(index);
+    }
+
+    // copies the record out of the mapping
+    [[nodiscard]] T operator[](std::size_t index) const
+    {
+        const auto* record = slot(index);
+        T result{};
+        std::apply(
+            [&](auto... decls) {
+                ((result.*(decls.ptr) = read_field<typename decltype(decls)::value_type>(record, decls.id)), ...);
+            },
+            reflect<T>::fields());
+        return result;
+    }
+
+    template<std::ranges::forward_range Range>
+    static void write(const std::filesystem::path& path, const Range& values)
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            throw std::runtime_error("Could not create mapped vector file " + path.string() + ".");
+        }
+        header_t header{detail::mapped_magic,
+                        detail::mapped_version,
+                        detail::mapped_byte_order,
+                        schema_hash<T>,
+                        layout.size,
+                        static_cast<std::uint64_t>(std::ranges::distance(values)),
+                        detail::mapped_align(sizeof(header_t), detail::mapped_section_alignment),
+                        0,
+                        0};
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::uint64_t position = sizeof(header);
+        detail::mapped_pad(stream, position, detail::mapped_section_alignment);
+
+        std::vector<std::byte> record(layout.size);
+        std::uint64_t heap_position = 0;
+        for (const auto& value : values) {
+            std::ranges::fill(record, std::byte{0});
+            std::apply(
+                [&](auto... decls) {
+                    (detail::mapped_traits_t<typename decltype(decls)::value_type>::write_slot(
+                         record.data() + layout.offsets[decls.id], value.*(decls.ptr), heap_position),
+                     ...);
+                },
+                reflect<T>::fields());
+            stream.write(reinterpret_cast<const char*>(record.data()), static_cast<std::streamsize>(record.size()));
+            position += record.size();
+        }
+        detail::mapped_pad(stream, position, detail::mapped_section_alignment);
+        header.heap_offset = position;
+        header.heap_size = heap_position;
+
+        // the heap is written in the same order as it was planned while writing the slots
+        heap_position = 0;
+        for (const auto& value : values) {
+            std::apply(
+                [&](auto... decls) {
+                    (detail::mapped_traits_t<typename decltype(decls)::value_type>::write_heap(
+                         stream, value.*(decls.ptr), heap_position),
+                     ...);
+                },
+                reflect<T>::fields());
+        }
+        stream.seekp(0);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!stream.flush()) {
+            throw std::runtime_error("Could not write mapped vector file " + path.string() + ".");
+        }
+    }
+
+private:
+    using header_t = detail::mapped_header_t;
+
+    static constexpr auto layout = detail::mapped_layout<T>;
+
+    void validate()
+    {
+        header_t header;
+        std::memcpy(&header, mapping.data(), sizeof(header));
+        if (header.magic != detail::mapped_magic || header.version != detail::mapped_version) {
+            throw std::runtime_error("File is not a mapped vector.");
+        }
+        if (header.byte_order != detail::mapped_byte_order) {
+            throw std::runtime_error("Mapped vector was written with another byte order.");
+        }
+        if (header.schema != schema_hash<T> || header.slot_size != layout.size) {
+            throw std::runtime_error("Mapped vector was written with another schema.");
+        }
+        const auto file_size = mapping.size();
+        const auto alignment = detail::mapped_section_alignment;
+        if (header.slot_offset % alignment != 0 || header.heap_offset % alignment != 0 ||
+            header.slot_offset > file_size || header.heap_offset > file_size ||
+            header.heap_offset < header.slot_offset ||
+            (layout.size != 0 && (header.heap_offset - header.slot_offset) / layout.size < header.count) ||
+            file_size - header.heap_offset < header.heap_size) {
+            throw std::runtime_error("Mapped vector file is truncated or corrupt.");
+        }
+        count = static_cast<std::size_t>(header.count);
+        slots = mapping.subspan(header.slot_offset, count * layout.size);
+        heap = mapping.subspan(header.heap_offset, header.heap_size);
+    }
+
+    void unmap() noexcept
+    {
+        if (!mapping.empty()) {
+            ::munmap(const_cast<std::byte*>(mapping.data()), mapping.size());
+        }
+        mapping = {};
+    }
+
+    [[nodiscard]] const std::byte* slot(std::size_t index) const
+    {
+        if (index >= count) {
+            throw std::out_of_range("Mapped vector index out of range.");
+        }
+        return slots.data() + index * layout.size;
+    }
+
+    template<class V>
+    [[nodiscard]] V read_field(const std::byte* record, std::size_t id) const
+    {
+        using traits_t = detail::mapped_traits_t<V>;
+        return traits_t::materialize(traits_t::read(record + layout.offsets[id], heap));
+    }
+
+    std::span<const std::byte> mapping;
+    std::span<const std::byte> slots;
+    std::span<const std::byte> heap;
+    std::size_t count = 0;
+};
+
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include "introspect.hpp"
+#include "reflect.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Memory used by reflected objects including the heap memory they own. Strings and vectors count with their
+// capacity, short strings stored inside the object with nothing. Node based containers (lists, maps, sets) count
+// an estimate of one node per element with two pointers of overhead, hash containers their buckets in addition.
+// Optionals, pairs and nested records add up the memory of their members. Views like std::span and std::string_view
+// own no heap memory. Other types count with their sizeof only.
+
+namespace tsmp {
+
+struct memory_footprint_entry_t
+{
+    // path of the field, nested fields are joined by dots
+    std::string field;
+    // bytes inside the enclosing object
+    std::size_t inline_bytes;
+    // bytes on the heap owned by the field
+    std::size_t heap_bytes;
+
+    [[nodiscard]] std::size_t total_bytes() const noexcept { return inline_bytes + heap_bytes; }
+
+    bool operator==(const memory_footprint_entry_t&) const = default;
+};
+
+namespace detail {
+
+template<class V>
+[[nodiscard]] std::size_t footprint_heap(const V& value);
+
+template<class V>
+concept footprint_string = requires(const V& value) {
+    value.c_str();
+    value.capacity();
+};
+
+template<class V>
+concept footprint_pair = requires(const V& value) {
+    value.first;
+    value.second;
+};
+
+template<class V>
+concept footprint_record = reflect<V>::reflectable;
+
+// ranges that refer to elements owned by something else
+template<class V>
+concept footprint_view = std::ranges::view<V> || std::ranges::enable_borrowed_range<V>;
+
+template<class V>
+[[nodiscard]] std::size_t footprint_range_heap(const V& range)
+{
+    using element_type = std::ranges::range_value_t<V>;
+    std::size_t result = 0;
+    std::size_t size = 0;
+    for (const auto& element : range) {
+        result += footprint_heap(element);
+        ++size;
+    }
+    if constexpr (std::is_same_v<V, std::vector<bool>>) {
+        result += range.capacity() / CHAR_BIT;
+    } else if constexpr (std::ranges::contiguous_range<V> && requires { range.capacity(); }) {
+        result += range.capacity() * sizeof(element_type);
+    } else if constexpr (!std::ranges::contiguous_range<V>) {
+        result += size * (sizeof(element_type) + 2 * sizeof(void*));
+        if constexpr (requires { range.bucket_count(); }) {
+            result += range.bucket_count() * sizeof(void*);
+        }
+    }
+    return result;
+}
+
+template<class V>
+[[nodiscard]] std::size_t footprint_heap(const V& value)
+{
+    if constexpr (Arithmetic<V> || Enum<V>) {
+        return 0;
+    } else if constexpr (footprint_string<V>) {
+        const auto* data = reinterpret_cast<const std::byte*>(value.data());
+        const auto* object = reinterpret_cast<const std::byte*>(&value);
+        const bool is_short = data >= object && data < object + sizeof(V);
+        return is_short ? 0 : (value.capacity() + 1) * sizeof(typename V::value_type);
+    } else if constexpr (is_optional<V>) {
+        return value ? footprint_heap(*value) : 0;
+    } else if constexpr (footprint_pair<V>) {
+        return footprint_heap(value.first) + footprint_heap(value.second);
+    } else if constexpr (footprint_view<V>) {
+        return 0;
+    } else if constexpr (std::ranges::range<V>) {
+        return footprint_range_heap(value);
+    } else if constexpr (footprint_record<V>) {
+        std::size_t result = 0;
+        introspect{value}.visit_fields([&](std::size_t, std::string_view, const auto& field) {
+            result += footprint_heap(field);
+        });
+        return result;
+    } else {
+        return 0;
+    }
+}
+
+template<class T>
+[[nodiscard]] constexpr std::size_t footprint_nested_entries() noexcept;
+
+// number of report entries of a record, every field and the fields of nested records
+template<class T>
+inline constexpr std::size_t footprint_entries = std::apply(
+    [](auto... decls) {
+        return (std::size_t{0} + ... + (1 + footprint_nested_entries<typename decltype(decls)::value_type>()));
+    },
+    reflect<T>::fields());
+
+template<class T>
+[[nodiscard]] constexpr std::size_t footprint_nested_entries() noexcept
+{
+    if constexpr (footprint_record<T>) {
+        return footprint_entries<T>;
+    } else {
+        return 0;
+    }
+}
+
+template<class T>
+void footprint_fields(std::string_view prefix, std::vector<memory_footprint_entry_t>& entries)
+{
+    std::apply(
+        [&](auto... decls) {
+            (
+                [&] {
+                    using value_type = typename decltype(decls)::value_type;
+                    auto path = std::string(prefix) + std::string(decls.name);
+                    entries.push_back({path, sizeof(value_type), 0});
+                    if constexpr (footprint_record<value_type>) {
+                        footprint_fields<value_type>(path + '.', entries);
+                    }
+                }(),
+                ...);
+        },
+        reflect<T>::fields());
+}
+
+// adds the heap bytes of every field in the order of footprint_fields and returns their sum
+template<class T>
+std::size_t footprint_fill(const T& value, std::size_t*& heap)
+{
+    std::size_t result = 0;
+    introspect{value}.visit_fields([&](std::size_t, std::string_view, const auto& field) {
+        auto& entry = *heap++;
+        std::size_t bytes = 0;
+        if constexpr (footprint_record<std::remove_cvref_t<decltype(field)>>) {
+            bytes = footprint_fill(field, heap);
+        } else {
+            bytes = footprint_heap(field);
+        }
+        entry += bytes;
+        result += bytes;
+    });
+    return result;
+}
+
+// below this many values per thread the work is not split
+inline constexpr std::size_t footprint_parallel_grain = 1 << 12;
+
+// calls fn(thread, first, last) for contiguous parts of [0, size) on up to threads threads
+template<class Function>
+void footprint_parallel(std::size_t size, std::size_t threads, Function&& fn)
+{
+    const auto workers = std::clamp<std::size_t>(size / footprint_parallel_grain, 1, std::max<std::size_t>(threads, 1));
+    if (workers == 1) {
+        fn(std::size_t{0}, std::size_t{0}, size);
+        return;
+    }
+    // jthreads join on destruction, so a failure to start a worker does not leave running threads behind
+    std::vector<std::jthread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t worker = 1; worker < workers; ++worker) {
+        pool.emplace_back(
+            [&fn, worker, workers, size] { fn(worker, size * worker / workers, size * (worker + 1) / workers); });
+    }
+    fn(std::size_t{0}, std::size_t{0}, size / workers);
+}
+
+[[nodiscard]] inline std::size_t footprint_default_threads() noexcept
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+}
+
+// Bytes used by the value, its sizeof and the heap memory it owns.
+template<class T>
+[[nodiscard]] std::size_t memory_footprint(const T& value)
+{
+    return sizeof(T) + detail::footprint_heap(value);
+}
+
+// Bytes used by all values, computed in parallel for large spans.
+template<class T, std::size_t Extent>
+[[nodiscard]] std::size_t memory_footprint(std::span<T, Extent> values,
+                                           std::size_t threads = detail::footprint_default_threads())
+{
+    std::vector<std::size_t> heap(threads + 1);
+    detail::footprint_parallel(values.size(), threads, [&](std::size_t worker, std::size_t first, std::size_t last) {
+        std::size_t bytes = 0;
+        for (auto i = first; i < last; ++i) {
+            bytes += detail::footprint_heap(values[i]);
+        }
+        heap[worker] = bytes;
+    });
+    std::size_t result = values.size() * sizeof(T);
+    for (const auto bytes : heap) {
+        result += bytes;
+    }
+    return result;
+}
+
+// Memory of every field of a reflected record, nested records first list their own entry and then their fields.
+template<class T, std::size_t Extent>
+[[nodiscard]] std::vector<memory_footprint_entry_t> memory_footprint_report(
+    std::span<T, Extent> values,
+    std::size_t threads = detail::footprint_default_threads())
+{
+    using value_type = std::remove_const_t<T>;
+    std::vector<memory_footprint_entry_t> entries;
+    entries.reserve(detail::footprint_entries<value_type>);
+    detail::footprint_fields<value_type>("", entries);
+
+    std::vector<std::vector<std::size_t>> heap(threads + 1);
+    detail::footprint_parallel(values.size(), threads, [&](std::size_t worker, std::size_t first, std::size_t last) {
+        auto& bytes = heap[worker];
+        bytes.assign(entries.size(), 0);
+        for (auto i = first; i < last; ++i) {
+            auto* position = bytes.data();
+            detail::footprint_fill(values[i], position);
+        }
+    });
+    for (const auto& bytes : heap) {
+        for (std::size_t i = 0; i < bytes.size(); ++i) {
+            entries[i].heap_bytes += bytes[i];
+        }
+    }
+    for (auto& entry : entries) {
+        entry.inline_bytes *= values.size();
+    }
+    return entries;
+}
+
+template<class T>
+[[nodiscard]] std::vector<memory_footprint_entry_t> memory_footprint_report(const T& value)
+{
+    return memory_footprint_report(std::span<const T>(&value, 1), 1);
+}
+
+}
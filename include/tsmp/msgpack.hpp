@@ -0,0 +1,394 @@
+#pragma once
+
+#include "tagged.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace tsmp {
+
+namespace detail {
+
+struct msgpack_writer_t
+{
+    std::vector<std::byte>& buffer;
+
+    void write_tag(std::uint8_t tag) { buffer.push_back(static_cast<std::byte>(tag)); }
+
+    void write_nil() { write_tag(0xc0); }
+
+    void write_bool(bool value) { write_tag(value ? 0xc3 : 0xc2); }
+
+    void write_unsigned(std::uint64_t value)
+    {
+        if (value < 0x80) {
+            write_tag(static_cast<std::uint8_t>(value));
+        } else if (value <= 0xff) {
+            write_tag(0xcc);
+            write_big_endian(buffer, static_cast<std::uint8_t>(value));
+        } else if (value <= 0xffff) {
+            write_tag(0xcd);
+            write_big_endian(buffer, static_cast<std::uint16_t>(value));
+        } else if (value <= 0xffffffff) {
+            write_tag(0xce);
+            write_big_endian(buffer, static_cast<std::uint32_t>(value));
+        } else {
+            write_tag(0xcf);
+            write_big_endian(buffer, value);
+        }
+    }
+
+    void write_signed(std::int64_t value)
+    {
+        if (value >= 0) {
+            write_unsigned(static_cast<std::uint64_t>(value));
+        } else if (value >= -32) {
+            write_tag(static_cast<std::uint8_t>(value));
+        } else if (value >= std::numeric_limits<std::int8_t>::min()) {
+            write_tag(0xd0);
+            write_big_endian(buffer, static_cast<std::uint8_t>(value));
+        } else if (value >= std::numeric_limits<std::int16_t>::min()) {
+            write_tag(0xd1);
+            write_big_endian(buffer, static_cast<std::uint16_t>(value));
+        } else if (value >= std::numeric_limits<std::int32_t>::min()) {
+            write_tag(0xd2);
+            write_big_endian(buffer, static_cast<std::uint32_t>(value));
+        } else {
+            write_tag(0xd3);
+            write_big_endian(buffer, static_cast<std::uint64_t>(value));
+        }
+    }
+
+    void write_float(float value)
+    {
+        write_tag(0xca);
+        write_big_endian(buffer, std::bit_cast<std::uint32_t>(value));
+    }
+
+    void write_double(double value)
+    {
+        write_tag(0xcb);
+        write_big_endian(buffer, std::bit_cast<std::uint64_t>(value));
+    }
+
+    void write_header(std::size_t size,
+                      std::uint8_t fix_tag,
+                      std::size_t fix_limit,
+                      std::uint8_t tag8,
+                      std::uint8_t tag16)
+    {
+        if (size < fix_limit) {
+            write_tag(static_cast<std::uint8_t>(fix_tag | size));
+        } else if (size <= 0xff && tag8 != 0) {
+            write_tag(tag8);
+            write_big_endian(buffer, static_cast<std::uint8_t>(size));
+        } else if (size <= 0xffff) {
+            write_tag(tag16);
+            write_big_endian(buffer, static_cast<std::uint16_t>(size));
+        } else {
+            write_tag(tag16 + 1);
+            write_big_endian(buffer, static_cast<std::uint32_t>(size));
+        }
+    }
+
+    void write_string(std::string_view value)
+    {
+        write_header(value.size(), 0xa0, 32, 0xd9, 0xda);
+        const auto* data = reinterpret_cast<const std::byte*>(value.data());
+        buffer.insert(buffer.end(), data, data + value.size());
+    }
+
+    void write_array_header(std::size_t size) { write_header(size, 0x90, 16, 0, 0xdc); }
+
+    void write_map_header(std::size_t size) { write_header(size, 0x80, 16, 0, 0xde); }
+};
+
+struct msgpack_reader_t : tagged_cursor_t
+{
+    [[nodiscard]] tagged_kind_t peek() noexcept
+    {
+        std::uint8_t tag;
+        if (!peek_byte(tag)) {
+            return tagged_kind_t::other;
+        }
+        if (tag <= 0x7f || tag >= 0xe0 || (tag >= 0xcc && tag <= 0xd3)) {
+            return tagged_kind_t::integer;
+        } else if (tag <= 0x8f || tag == 0xde || tag == 0xdf) {
+            return tagged_kind_t::map;
+        } else if (tag <= 0x9f || tag == 0xdc || tag == 0xdd) {
+            return tagged_kind_t::array;
+        } else if (tag <= 0xbf || (tag >= 0xd9 && tag <= 0xdb)) {
+            return tagged_kind_t::string;
+        } else if (tag == 0xc0) {
+            return tagged_kind_t::nil;
+        } else if (tag == 0xc2 || tag == 0xc3) {
+            return tagged_kind_t::boolean;
+        } else if (tag == 0xca || tag == 0xcb) {
+            return tagged_kind_t::floating;
+        } else if (tag >= 0xc4 && tag <= 0xc6) {
+            return tagged_kind_t::binary;
+        }
+        return tagged_kind_t::other;
+    }
+
+    [[nodiscard]] bool read_nil() noexcept
+    {
+        std::uint8_t tag;
+        if (peek_byte(tag) && tag == 0xc0) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool read_bool(bool& value) noexcept
+    {
+        std::uint8_t tag;
+        if (!read_byte(tag)) {
+            return false;
+        }
+        if (tag != 0xc2 && tag != 0xc3) {
+            return fail("Value is not a boolean.");
+        }
+        value = tag == 0xc3;
+        return true;
+    }
+
+    template<std::unsigned_integral U>
+    [[nodiscard]] bool read_unsigned(tagged_integer_t& integer) noexcept
+    {
+        U value;
+        if (!read_big_endian(value)) {
+            return false;
+        }
+        integer = {false, value};
+        return true;
+    }
+
+    template<std::unsigned_integral U>
+    [[nodiscard]] bool read_signed(tagged_integer_t& integer) noexcept
+    {
+        U value;
+        if (!read_big_endian(value)) {
+            return false;
+        }
+        const auto signed_value = static_cast<std::make_signed_t<U>>(value);
+        const auto widened = static_cast<std::uint64_t>(static_cast<std::int64_t>(signed_value));
+        integer = {signed_value < 0, signed_value < 0 ? ~widened : widened};
+        return true;
+    }
+
+    [[nodiscard]] bool read_integer(tagged_integer_t& integer) noexcept
+    {
+        std::uint8_t tag;
+        if (!read_byte(tag)) {
+            return false;
+        }
+        if (tag <= 0x7f) {
+            integer = {false, tag};
+            return true;
+        } else if (tag >= 0xe0) {
+            integer = {true, static_cast<std::uint64_t>(0xff - tag)};
+            return true;
+        }
+        switch (tag) {
+            case 0xcc:
+                return read_unsigned<std::uint8_t>(integer);
+            case 0xcd:
+                return read_unsigned<std::uint16_t>(integer);
+            case 0xce:
+                return read_unsigned<std::uint32_t>(integer);
+            case 0xcf:
+                return read_unsigned<std::uint64_t>(integer);
+            case 0xd0:
+                return read_signed<std::uint8_t>(integer);
+            case 0xd1:
+                return read_signed<std::uint16_t>(integer);
+            case 0xd2:
+                return read_signed<std::uint32_t>(integer);
+            case 0xd3:
+                return read_signed<std::uint64_t>(integer);
+            default:
+                return fail("Value is not an integer.");
+        }
+    }
+
+    [[nodiscard]] bool read_float(double& value) noexcept
+    {
+        std::uint8_t tag;
+        if (!read_byte(tag)) {
+            return false;
+        }
+        if (tag == 0xca) {
+            std::uint32_t bits;
+            if (!read_big_endian(bits)) {
+                return false;
+            }
+            value = std::bit_cast<float>(bits);
+            return true;
+        } else if (tag == 0xcb) {
+            std::uint64_t bits;
+            if (!read_big_endian(bits)) {
+                return false;
+            }
+            value = std::bit_cast<double>(bits);
+            return true;
+        }
+        return fail("Value is not a floating point number.");
+    }
+
+    template<std::unsigned_integral U>
+    [[nodiscard]] bool read_size(std::size_t& size) noexcept
+    {
+        U value;
+        if (!read_big_endian(value)) {
+            return false;
+        }
+        size = value;
+        return true;
+    }
+
+    [[nodiscard]] bool read_string(std::string_view& value) noexcept
+    {
+        std::uint8_t tag;
+        if (!read_byte(tag)) {
+            return false;
+        }
+        std::size_t size = tag & 0x1f;
+        if ((tag >= 0xa0 && tag <= 0xbf) || (tag == 0xd9 && read_size<std::uint8_t>(size)) ||
+            (tag == 0xda && read_size<std::uint16_t>(size)) || (tag == 0xdb && read_size<std::uint32_t>(size))) {
+            return read_view(size, value);
+        }
+        return fail("Value is not a string.");
+    }
+
+    [[nodiscard]] bool read_container_header(tagged_container_t& header, std::uint8_t fix_tag, std::uint8_t tag16)
+    {
+        std::uint8_t tag;
+        if (!read_byte(tag)) {
+            return false;
+        }
+        header = {static_cast<std::size_t>(tag & 0x0f), false};
+        if ((tag & 0xf0) == fix_tag || (tag == tag16 && read_size<std::uint16_t>(header.size)) ||
+            (tag == tag16 + 1 && read_size<std::uint32_t>(header.size))) {
+            return true;
+        }
+        return fail(fix_tag == 0x90 ? "Value is not an array." : "Value is not a map.");
+    }
+
+    [[nodiscard]] bool read_array_header(tagged_container_t& header)
+    {
+        return read_container_header(header, 0x90, 0xdc);
+    }
+
+    [[nodiscard]] bool read_map_header(tagged_container_t& header)
+    {
+        return read_container_header(header, 0x80, 0xde);
+    }
+
+    [[nodiscard]] bool read_break() const noexcept { return false; }
+
+    [[nodiscard]] bool skip() noexcept
+    {
+        // containers only add to the number of pending values, so nesting depth does not grow the stack
+        for (std::uint64_t pending = 1; pending > 0; --pending) {
+            std::uint8_t tag;
+            if (!read_byte(tag)) {
+                return false;
+            }
+            std::uint64_t payload = 0;
+            if (tag <= 0x7f || tag >= 0xe0 || tag == 0xc0 || tag == 0xc2 || tag == 0xc3) {
+                payload = 0;
+            } else if (tag <= 0x8f) {
+                pending += 2 * static_cast<std::uint64_t>(tag & 0x0f);
+            } else if (tag <= 0x9f) {
+                pending += tag & 0x0f;
+            } else if (tag <= 0xbf) {
+                payload = tag & 0x1f;
+            } else if (tag == 0xc4 || tag == 0xd9 || tag == 0xc7) {
+                std::uint8_t size;
+                if (!read_big_endian(size)) {
+                    return false;
+                }
+                payload = size + (tag == 0xc7 ? 1u : 0u);
+            } else if (tag == 0xc5 || tag == 0xda || tag == 0xc8) {
+                std::uint16_t size;
+                if (!read_big_endian(size)) {
+                    return false;
+                }
+                payload = size + (tag == 0xc8 ? 1u : 0u);
+            } else if (tag == 0xc6 || tag == 0xdb || tag == 0xc9) {
+                std::uint32_t size;
+                if (!read_big_endian(size)) {
+                    return false;
+                }
+                payload = std::uint64_t{size} + (tag == 0xc9 ? 1u : 0u);
+            } else if (tag == 0xca || tag == 0xce || tag == 0xd2) {
+                payload = 4;
+            } else if (tag == 0xcb || tag == 0xcf || tag == 0xd3) {
+                payload = 8;
+            } else if (tag == 0xcc || tag == 0xd0) {
+                payload = 1;
+            } else if (tag == 0xcd || tag == 0xd1) {
+                payload = 2;
+            } else if (tag >= 0xd4 && tag <= 0xd8) {
+                // fixext: one type byte followed by 1, 2, 4, 8 or 16 bytes
+                payload = 1 + (std::uint64_t{1} << (tag - 0xd4));
+            } else if (tag == 0xdc || tag == 0xde) {
+                std::uint16_t size;
+                if (!read_big_endian(size)) {
+                    return false;
+                }
+                pending += std::uint64_t{size} * (tag == 0xde ? 2 : 1);
+            } else if (tag == 0xdd || tag == 0xdf) {
+                std::uint32_t size;
+                if (!read_big_endian(size)) {
+                    return false;
+                }
+                pending += std::uint64_t{size} * (tag == 0xdf ? 2 : 1);
+            } else {
+                return fail("Invalid MessagePack tag.");
+            }
+            if (!skip_bytes(payload)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}
+
+template<class T>
+void to_msgpack(const T& value, std::vector<std::byte>& buffer)
+{
+    detail::msgpack_writer_t writer{buffer};
+    detail::tagged_codec_t<T>::encode(writer, value);
+}
+
+template<class T>
+[[nodiscard]] std::vector<std::byte> to_msgpack(const T& value)
+{
+    std::vector<std::byte> buffer;
+    to_msgpack(value, buffer);
+    return buffer;
+}
+
+template<class T, class... Validator>
+[[nodiscard]] T from_msgpack(std::span<const std::byte> buffer, Validator&&... validator)
+{
+    return detail::from_tagged<T, detail::msgpack_reader_t>(buffer, std::forward<Validator>(validator)...);
+}
+
+template<class T, class... Validator>
+[[nodiscard]] std::optional<T> try_from_msgpack(std::span<const std::byte> buffer, Validator&&... validator) noexcept
+{
+    return detail::try_from_tagged<T, detail::msgpack_reader_t>(buffer, std::forward<Validator>(validator)...);
+}
+
+}
@@ -0,0 +1,372 @@
+#pragma once
+
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bit packed representation of flat reflected records. Every field takes the smallest number of bits that can hold
+// all its values:
+//   bool                  -> 1 bit
+//   enums                 -> index into enum_values, ceil(log2(enum_values<E>.size())) bits
+//   bounded integers      -> offset from the lower bound, ceil(log2(max - min + 1)) bits
+//   other integers, floats -> all bits of the type
+//   std::optional         -> presence bit plus the bits of the value
+//   reflected records     -> the bits of all fields
+// A packed record occupies ceil(bits / 8) bytes without alignment, so arrays of them are dense.
+
+namespace tsmp {
+
+// Specialise to declare the range of an integer field, e.g.
+//   template<>
+//   struct field_bounds_t<reading_t, "celsius">
+//   {
+//       static constexpr std::int64_t min = -50;
+//       static constexpr std::int64_t max = 60;
+//   };
+template<class T, string_literal_t field>
+struct field_bounds_t;
+
+namespace detail {
+
+template<class T, std::size_t id>
+inline constexpr auto packed_field_name = [] {
+    constexpr std::string_view name = std::get<id>(reflect<T>::fields()).name;
+    return string_literal_t<name.size()>(name.data());
+}();
+
+struct packed_unbounded_t
+{};
+
+template<class T, std::size_t id>
+struct packed_bounds
+{
+    using type = packed_unbounded_t;
+};
+
+template<class T, std::size_t id>
+    requires requires { field_bounds_t<T, packed_field_name<T, id>>::min; }
+struct packed_bounds<T, id>
+{
+    using type = field_bounds_t<T, packed_field_name<T, id>>;
+};
+
+template<class T, std::size_t id>
+using packed_bounds_t = typename packed_bounds<T, id>::type;
+
+template<std::size_t N>
+using packed_words_t = std::array<std::uint64_t, N>;
+
+// offset and width are constants in every call, so the branches fold away
+template<std::size_t N>
+constexpr void packed_put(packed_words_t<N>& words, std::size_t offset, std::size_t width, std::uint64_t value) noexcept
+{
+    if (width == 0) {
+        return;
+    }
+    const auto word = offset / 64;
+    const auto shift = offset % 64;
+    words[word] |= value << shift;
+    if (shift + width > 64) {
+        words[word + 1] |= value >> (64 - shift);
+    }
+}
+
+template<std::size_t N>
+[[nodiscard]] constexpr std::uint64_t packed_get(const packed_words_t<N>& words,
+                                                 std::size_t offset,
+                                                 std::size_t width) noexcept
+{
+    if (width == 0) {
+        return 0;
+    }
+    const auto word = offset / 64;
+    const auto shift = offset % 64;
+    auto value = words[word] >> shift;
+    if (shift + width > 64) {
+        value |= words[word + 1] << (64 - shift);
+    }
+    return width == 64 ? value : value & ((std::uint64_t{1} << width) - 1);
+}
+
+template<class T, class Bounds = packed_unbounded_t>
+struct packed_codec_t;
+
+template<class Bounds>
+struct packed_codec_t<bool, Bounds>
+{
+    static constexpr std::size_t bits = 1;
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void pack(packed_words_t<N>& words, bool value) noexcept
+    {
+        packed_put(words, offset, bits, value ? 1 : 0);
+    }
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void unpack(const packed_words_t<N>& words, bool& value) noexcept
+    {
+        value = packed_get(words, offset, bits) != 0;
+    }
+};
+
+template<Enum T, class Bounds>
+struct packed_codec_t<T, Bounds>
+{
+    static constexpr auto size = enum_values<T>.size();
+    static constexpr std::size_t bits = size <= 1 ? 0 : static_cast<std::size_t>(std::bit_width(size - 1));
+
+    // enumerations numbered 0, 1, 2, ... use their value as index
+    static constexpr bool sequential = [] {
+        for (std::size_t i = 0; i < size; ++i) {
+            if (static_cast<std::uint64_t>(enum_values<T>[i]) != i) {
+                return false;
+            }
+        }
+        return true;
+    }();
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void pack(packed_words_t<N>& words, T value)
+    {
+        std::uint64_t index;
+        if constexpr (sequential) {
+            index = static_cast<std::uint64_t>(value);
+        } else {
+            index = static_cast<std::uint64_t>(std::ranges::find(enum_values<T>, value) - enum_values<T>.begin());
+        }
+        if (index >= size) {
+            throw std::out_of_range("Value is not part of enumeration.");
+        }
+        packed_put(words, offset, bits, index);
+    }
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void unpack(const packed_words_t<N>& words, T& value)
+    {
+        const auto index = packed_get(words, offset, bits);
+        if (index >= size) {
+            throw std::runtime_error("Packed enum index out of range.");
+        }
+        value = enum_values<T>[index];
+    }
+};
+
+template<Arithmetic T, class Bounds>
+    requires(!std::is_same_v<T, bool>)
+struct packed_codec_t<T, Bounds>
+{
+    static constexpr bool bounded = !std::is_same_v<Bounds, packed_unbounded_t>;
+    static_assert(!bounded || std::integral<T>, "Only integer fields can have bounds.");
+    static_assert(sizeof(T) <= 8, "Only arithmetic types up to 64 bit are supported.");
+
+    using bits_t = std::conditional_t<sizeof(T) <= 4, std::uint32_t, std::uint64_t>;
+
+    static constexpr std::size_t bits = [] {
+        if constexpr (bounded) {
+            static_assert(Bounds::min <= Bounds::max, "The lower field bound exceeds the upper one.");
+            static_assert(std::in_range<T>(Bounds::min) && std::in_range<T>(Bounds::max),
+                          "The field bounds exceed the range of the field type.");
+            return static_cast<std::size_t>(
+                std::bit_width(static_cast<std::uint64_t>(Bounds::max) - static_cast<std::uint64_t>(Bounds::min)));
+        } else {
+            return 8 * sizeof(T);
+        }
+    }();
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void pack(packed_words_t<N>& words, T value)
+    {
+        if constexpr (bounded) {
+            if (std::cmp_less(value, Bounds::min) || std::cmp_greater(value, Bounds::max)) {
+                throw std::out_of_range("Value exceeds the declared field bounds.");
+            }
+            packed_put(
+                words, offset, bits, static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(Bounds::min));
+        } else if constexpr (std::floating_point<T>) {
+            packed_put(words, offset, bits, std::bit_cast<bits_t>(value));
+        } else {
+            packed_put(words, offset, bits, static_cast<std::make_unsigned_t<T>>(value));
+        }
+    }
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void unpack(const packed_words_t<N>& words, T& value)
+    {
+        const auto raw = packed_get(words, offset, bits);
+        if constexpr (bounded) {
+            if (raw > static_cast<std::uint64_t>(Bounds::max) - static_cast<std::uint64_t>(Bounds::min)) {
+                throw std::runtime_error("Packed value exceeds the declared field bounds.");
+            }
+            value = static_cast<T>(raw + static_cast<std::uint64_t>(Bounds::min));
+        } else if constexpr (std::floating_point<T>) {
+            value = std::bit_cast<T>(static_cast<bits_t>(raw));
+        } else {
+            value = static_cast<T>(raw);
+        }
+    }
+};
+
+template<is_optional T, class Bounds>
+struct packed_codec_t<T, Bounds>
+{
+    using value_codec = packed_codec_t<typename T::value_type, Bounds>;
+    static constexpr std::size_t bits = 1 + value_codec::bits;
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void pack(packed_words_t<N>& words, const T& value)
+    {
+        if (value) {
+            packed_put(words, offset, 1, 1);
+            value_codec::template pack<offset + 1>(words, *value);
+        }
+    }
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void unpack(const packed_words_t<N>& words, T& value)
+    {
+        if (packed_get(words, offset, 1) != 0) {
+            value_codec::template unpack<offset + 1>(words, value.emplace());
+        } else {
+            value.reset();
+        }
+    }
+};
+
+template<class T, class Bounds>
+struct packed_codec_t
+{
+    static_assert(!std::ranges::range<T>, "Packed records hold fixed size fields only.");
+
+    using fields_t = decltype(reflect<T>::fields());
+    static constexpr std::size_t field_count = std::tuple_size_v<fields_t>;
+
+    template<std::size_t id>
+    using field_codec = packed_codec_t<typename std::tuple_element_t<id, fields_t>::value_type, packed_bounds_t<T, id>>;
+
+    // bit offset of every field and the total width in the last entry
+    static constexpr auto offsets = []<std::size_t... id>(std::index_sequence<id...>) {
+        std::array<std::size_t, field_count + 1> result{};
+        std::size_t position = 0;
+        ((result[id] = position, position += field_codec<id>::bits), ...);
+        result[field_count] = position;
+        return result;
+    }(std::make_index_sequence<field_count>{});
+
+    static constexpr std::size_t bits = offsets[field_count];
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void pack(packed_words_t<N>& words, const T& value)
+    {
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            (field_codec<id>::template pack<offset + offsets[id]>(words,
+                                                                 value.*std::get<id>(reflect<T>::fields()).ptr),
+             ...);
+        }(std::make_index_sequence<field_count>{});
+    }
+
+    template<std::size_t offset, std::size_t N>
+    static constexpr void unpack(const packed_words_t<N>& words, T& value)
+    {
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            (field_codec<id>::template unpack<offset + offsets[id]>(words,
+                                                                   value.*std::get<id>(reflect<T>::fields()).ptr),
+             ...);
+        }(std::make_index_sequence<field_count>{});
+    }
+};
+
+}
+
+template<class T>
+class packed
+{
+public:
+    using value_type = T;
+
+    static constexpr std::size_t bits = detail::packed_codec_t<T>::bits;
+    static constexpr std::size_t bytes = (bits + 7) / 8;
+
+    packed() = default;
+
+    explicit packed(const T& value)
+    {
+        words_t words{};
+        detail::packed_codec_t<T>::template pack<0>(words, value);
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(storage.data(), words.data(), bytes);
+        } else {
+            for (std::size_t i = 0; i < bytes; ++i) {
+                storage[i] = static_cast<std::byte>(words[i / 8] >> (8 * (i % 8)));
+            }
+        }
+    }
+
+    [[nodiscard]] T unpack() const
+    {
+        words_t words{};
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(words.data(), storage.data(), bytes);
+        } else {
+            for (std::size_t i = 0; i < bytes; ++i) {
+                words[i / 8] |= std::to_integer<std::uint64_t>(storage[i]) << (8 * (i % 8));
+            }
+        }
+        T result{};
+        detail::packed_codec_t<T>::template unpack<0>(words, result);
+        return result;
+    }
+
+    [[nodiscard]] std::span<const std::byte, bytes> data() const noexcept { return storage; }
+
+    [[nodiscard]] friend bool operator==(const packed&, const packed&) noexcept = default;
+
+private:
+    using words_t = detail::packed_words_t<(bits + 63) / 64 + 1>;
+
+    std::array<std::byte, bytes> storage{};
+};
+
+template<std::ranges::input_range Range>
+[[nodiscard]] std::vector<packed<std::ranges::range_value_t<Range>>> pack(const Range& values)
+{
+    std::vector<packed<std::ranges::range_value_t<Range>>> result;
+    if constexpr (std::ranges::sized_range<Range>) {
+        result.reserve(std::ranges::size(values));
+    }
+    for (const auto& value : values) {
+        result.emplace_back(value);
+    }
+    return result;
+}
+
+template<std::ranges::input_range Range>
+[[nodiscard]] std::vector<typename std::ranges::range_value_t<Range>::value_type> unpack(const Range& values)
+{
+    std::vector<typename std::ranges::range_value_t<Range>::value_type> result;
+    if constexpr (std::ranges::sized_range<Range>) {
+        result.reserve(std::ranges::size(values));
+    }
+    for (const auto& value : values) {
+        result.push_back(value.unpack());
+    }
+    return result;
+}
+
+}
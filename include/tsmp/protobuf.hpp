@@ -0,0 +1,802 @@
+#pragma once
+
+#include "binary.hpp"
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Protocol Buffers wire format for reflected types. Every reflected struct is a message, its fields are numbered in
+// declaration order starting at 1 unless protobuf_field_numbers_t is specialised. The scalar types map to
+//   bool, unsigned integers -> varint (bool, uint32, uint64)
+//   signed integers         -> varint of the sign extended value (int32, int64)
+//   float, double           -> fixed32, fixed64
+//   enums                   -> varint of the underlying value (open enums)
+//   std::string             -> length delimited
+// Integer fields can be switched to the sint and fixed types of protobuf with protobuf_field_encodings_t.
+// std::optional marks explicit presence, ranges are repeated fields and packed if their elements are scalar numbers.
+// Scalars with their default value and empty ranges are omitted like proto3 does.
+
+namespace tsmp {
+
+// Specialise to match the field numbers of an existing .proto definition, e.g.
+//   template<>
+//   struct protobuf_field_numbers_t<foo_t>
+//   {
+//       static constexpr std::array<std::uint32_t, 2> value{1, 7};
+//   };
+template<class T>
+struct protobuf_field_numbers_t
+{
+    static constexpr auto value = [] {
+        std::array<std::uint32_t, std::tuple_size_v<decltype(reflect<T>::fields())>> numbers{};
+        for (std::size_t i = 0; i < numbers.size(); ++i) {
+            numbers[i] = static_cast<std::uint32_t>(i + 1);
+        }
+        return numbers;
+    }();
+};
+
+enum class protobuf_encoding_t
+{
+    standard, // int32, int64, uint32, uint64
+    zigzag,   // sint32, sint64
+    fixed     // fixed32, fixed64, sfixed32, sfixed64
+};
+
+// Specialise to select the encoding of integer fields, including the elements of optional and repeated fields, e.g.
+//   template<>
+//   struct protobuf_field_encodings_t<foo_t>
+//   {
+//       static constexpr std::array<protobuf_encoding_t, 2> value{protobuf_encoding_t::standard,
+//                                                                 protobuf_encoding_t::zigzag};
+//   };
+template<class T>
+struct protobuf_field_encodings_t
+{
+    static constexpr std::array<protobuf_encoding_t, std::tuple_size_v<decltype(reflect<T>::fields())>> value{};
+};
+
+namespace detail {
+
+enum class protobuf_wire_t : std::uint8_t
+{
+    varint = 0,
+    fixed64 = 1,
+    length_delimited = 2,
+    start_group = 3,
+    end_group = 4,
+    fixed32 = 5
+};
+
+inline constexpr std::uint32_t protobuf_max_field_number = (1u << 29) - 1;
+inline constexpr std::size_t protobuf_max_group_depth = 100;
+
+[[nodiscard]] constexpr std::uint64_t protobuf_key(std::uint32_t number, protobuf_wire_t wire) noexcept
+{
+    return (static_cast<std::uint64_t>(number) << 3) | static_cast<std::uint64_t>(wire);
+}
+
+template<std::size_t N>
+[[nodiscard]] constexpr bool protobuf_valid_field_numbers(const std::array<std::uint32_t, N>& numbers) noexcept
+{
+    for (std::size_t i = 0; i < N; ++i) {
+        // 19000 to 19999 are reserved for the protobuf implementation
+        if (numbers[i] == 0 || numbers[i] > protobuf_max_field_number ||
+            (numbers[i] >= 19000 && numbers[i] <= 19999)) {
+            return false;
+        }
+        for (std::size_t j = 0; j < i; ++j) {
+            if (numbers[i] == numbers[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+[[nodiscard]] inline binary_reader_t protobuf_read_length_delimited(binary_reader_t& reader)
+{
+    const auto size = reader.read_size();
+    reader.require(size);
+    binary_reader_t nested{reader.buffer.subspan(reader.position, size)};
+    reader.position += size;
+    return nested;
+}
+
+inline void protobuf_skip_field(binary_reader_t& reader,
+                                std::uint64_t number,
+                                protobuf_wire_t wire,
+                                std::size_t depth = 0)
+{
+    switch (wire) {
+        case protobuf_wire_t::varint: {
+            // unknown varints are not decoded, only their terminating byte is searched
+            const auto window = reader.buffer.subspan(reader.position, std::min<std::size_t>(reader.remaining(), 10));
+            const auto last =
+                std::ranges::find_if(window, [](std::byte byte) { return (byte & std::byte{0x80}) == std::byte{0}; });
+            if (last == window.end()) {
+                throw std::runtime_error("Invalid varint in protobuf input.");
+            }
+            reader.position += static_cast<std::size_t>(last - window.begin()) + 1;
+            return;
+        }
+        case protobuf_wire_t::fixed64:
+            reader.require(8);
+            reader.position += 8;
+            return;
+        case protobuf_wire_t::length_delimited: {
+            const auto size = reader.read_size();
+            reader.require(size);
+            reader.position += size;
+            return;
+        }
+        case protobuf_wire_t::fixed32:
+            reader.require(4);
+            reader.position += 4;
+            return;
+        case protobuf_wire_t::start_group:
+            // groups are deprecated, but still have to be skipped up to their matching end tag
+            if (depth >= protobuf_max_group_depth) {
+                throw std::runtime_error("Protobuf groups are nested too deeply.");
+            }
+            while (true) {
+                const auto key = reader.read_varint();
+                const auto nested_wire = static_cast<protobuf_wire_t>(key & 7);
+                if (nested_wire == protobuf_wire_t::end_group) {
+                    if ((key >> 3) != number) {
+                        throw std::runtime_error("Mismatched protobuf group end.");
+                    }
+                    return;
+                }
+                protobuf_skip_field(reader, key >> 3, nested_wire, depth + 1);
+            }
+        default:
+            throw std::runtime_error("Invalid protobuf wire type.");
+    }
+}
+
+// Sizes of the nested messages in the order they are written. The sizes are computed once before encoding, otherwise
+// every message would compute the sizes of all messages nested in it again.
+struct protobuf_sizes_t
+{
+    std::vector<std::size_t> values;
+    std::size_t next = 0;
+};
+
+// Each codec handles the payload of a single value. Length delimited codecs report the payload size without the
+// length prefix and decode from a reader that spans exactly their payload. Messages take the sizes of their nested
+// messages from protobuf_sizes_t.
+template<class T, protobuf_encoding_t Encoding = protobuf_encoding_t::standard>
+struct protobuf_codec_t;
+
+template<class T>
+concept protobuf_message = requires { protobuf_codec_t<T>::is_message; };
+
+// unsigned representation of fixed32 and fixed64 values
+template<class T>
+struct protobuf_fixed_t
+{
+    using type = std::conditional_t<sizeof(T) <= 4, std::uint32_t, std::uint64_t>;
+};
+
+template<std::floating_point T>
+struct protobuf_fixed_t<T> : bitwise_float_t<T>
+{};
+
+template<Arithmetic T, protobuf_encoding_t Encoding>
+struct protobuf_codec_t<T, Encoding>
+{
+    static_assert(!std::floating_point<T> || sizeof(T) == 4 || sizeof(T) == 8,
+                  "Only 32 and 64 bit floating point types are supported.");
+    static_assert(Encoding != protobuf_encoding_t::zigzag || (std::is_signed_v<T> && std::integral<T>),
+                  "Only signed integers can be zigzag encoded.");
+    static_assert(Encoding != protobuf_encoding_t::fixed || !std::is_same_v<T, bool>, "bool can not be fixed encoded.");
+
+    static constexpr bool fixed = std::floating_point<T> || Encoding == protobuf_encoding_t::fixed;
+    using fixed_type = typename protobuf_fixed_t<T>::type;
+    using signed_fixed_type = std::make_signed_t<fixed_type>;
+
+    static constexpr protobuf_wire_t wire = !fixed                    ? protobuf_wire_t::varint
+                                            : sizeof(fixed_type) == 4 ? protobuf_wire_t::fixed32
+                                                                      : protobuf_wire_t::fixed64;
+
+    template<class V>
+    [[nodiscard]] static T narrow(V decoded)
+    {
+        if (decoded < std::numeric_limits<T>::min() || decoded > std::numeric_limits<T>::max()) {
+            throw std::runtime_error("Integer out of range.");
+        }
+        return static_cast<T>(decoded);
+    }
+
+    [[nodiscard]] static bool is_default(const T& value) noexcept
+    {
+        if constexpr (std::floating_point<T>) {
+            // -0.0 is not the default value and has to be transmitted
+            return std::bit_cast<typename bitwise_float_t<T>::type>(value) == 0;
+        } else {
+            return value == T{};
+        }
+    }
+
+    [[nodiscard]] static std::uint64_t raw(const T& value) noexcept
+    {
+        if constexpr (Encoding == protobuf_encoding_t::zigzag) {
+            return zigzag_encode(value);
+        } else if constexpr (std::is_signed_v<T> && !std::is_same_v<T, bool>) {
+            // negative values are sign extended to ten bytes like protobuf does for int32 and int64
+            return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+        } else {
+            return static_cast<std::uint64_t>(value);
+        }
+    }
+
+    [[nodiscard]] static std::size_t size(const T& value) noexcept
+    {
+        if constexpr (fixed) {
+            return sizeof(fixed_type);
+        } else {
+            return varint_size(raw(value));
+        }
+    }
+
+    static void encode(binary_writer_t& writer, const T& value)
+    {
+        if constexpr (std::floating_point<T>) {
+            writer.write_little_endian(std::bit_cast<fixed_type>(value));
+        } else if constexpr (fixed && std::is_signed_v<T>) {
+            writer.write_little_endian(static_cast<fixed_type>(static_cast<signed_fixed_type>(value)));
+        } else if constexpr (fixed) {
+            writer.write_little_endian(static_cast<fixed_type>(value));
+        } else {
+            writer.write_varint(raw(value));
+        }
+    }
+
+    static void decode(binary_reader_t& reader, T& value)
+    {
+        if constexpr (std::floating_point<T>) {
+            value = std::bit_cast<T>(reader.read_little_endian<fixed_type>());
+        } else if constexpr (fixed && std::is_signed_v<T>) {
+            value = narrow(static_cast<signed_fixed_type>(reader.read_little_endian<fixed_type>()));
+        } else if constexpr (fixed) {
+            value = narrow(reader.read_little_endian<fixed_type>());
+        } else if constexpr (std::is_same_v<T, bool>) {
+            value = reader.read_varint() != 0;
+        } else if constexpr (Encoding == protobuf_encoding_t::zigzag) {
+            value = narrow(zigzag_decode(reader.read_varint()));
+        } else if constexpr (std::is_signed_v<T>) {
+            value = narrow(static_cast<std::int64_t>(reader.read_varint()));
+        } else {
+            value = narrow(reader.read_varint());
+        }
+    }
+};
+
+template<Enum T>
+struct protobuf_codec_t<T>
+{
+    using underlying_type = std::underlying_type_t<T>;
+
+    static constexpr protobuf_wire_t wire = protobuf_wire_t::varint;
+
+    [[nodiscard]] static bool is_default(const T& value) noexcept { return static_cast<underlying_type>(value) == 0; }
+
+    [[nodiscard]] static std::uint64_t raw(const T& value) noexcept
+    {
+        // negative values are sign extended to 64 bit like protobuf does for int32
+        if constexpr (std::is_signed_v<underlying_type>) {
+            return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+        } else {
+            return static_cast<std::uint64_t>(value);
+        }
+    }
+
+    [[nodiscard]] static std::size_t size(const T& value) noexcept { return varint_size(raw(value)); }
+
+    static void encode(binary_writer_t& writer, const T& value) { writer.write_varint(raw(value)); }
+
+    static void decode(binary_reader_t& reader, T& value)
+    {
+        const auto decoded = reader.read_varint();
+        if constexpr (std::is_signed_v<underlying_type>) {
+            const auto signed_value = static_cast<std::int64_t>(decoded);
+            if (signed_value < std::numeric_limits<underlying_type>::min() ||
+                signed_value > std::numeric_limits<underlying_type>::max()) {
+                throw std::runtime_error("Enum value out of range.");
+            }
+            value = static_cast<T>(signed_value);
+        } else {
+            if (decoded > std::numeric_limits<underlying_type>::max()) {
+                throw std::runtime_error("Enum value out of range.");
+            }
+            value = static_cast<T>(decoded);
+        }
+    }
+};
+
+template<>
+struct protobuf_codec_t<std::string>
+{
+    static constexpr protobuf_wire_t wire = protobuf_wire_t::length_delimited;
+
+    [[nodiscard]] static bool is_default(const std::string& value) noexcept { return value.empty(); }
+
+    [[nodiscard]] static std::size_t size(const std::string& value) noexcept { return value.size(); }
+
+    static void encode(binary_writer_t& writer, const std::string& value)
+    {
+        writer.write_bytes(value.data(), value.size());
+    }
+
+    static void decode(binary_reader_t& reader, std::string& value)
+    {
+        value.assign(reinterpret_cast<const char*>(reader.buffer.data() + reader.position), reader.remaining());
+        reader.position = reader.buffer.size();
+    }
+};
+
+template<std::size_t N>
+struct protobuf_codec_t<string_literal_t<N>>
+{
+    static constexpr protobuf_wire_t wire = protobuf_wire_t::length_delimited;
+
+    [[nodiscard]] static std::string_view view(const string_literal_t<N>& value) noexcept
+    {
+        const std::string_view view = value;
+        return view.substr(0, view.find('\0'));
+    }
+
+    [[nodiscard]] static bool is_default(const string_literal_t<N>& value) noexcept { return view(value).empty(); }
+
+    [[nodiscard]] static std::size_t size(const string_literal_t<N>& value) noexcept { return view(value).size(); }
+
+    static void encode(binary_writer_t& writer, const string_literal_t<N>& value)
+    {
+        const auto content = view(value);
+        writer.write_bytes(content.data(), content.size());
+    }
+
+    static void decode(binary_reader_t& reader, string_literal_t<N>& value)
+    {
+        const auto size = reader.remaining();
+        if (size > N) {
+            throw std::runtime_error("String is bigger than the requested size.");
+        }
+        std::fill(value.begin(), value.end(), '\0');
+        reader.read_bytes(value.data(), size);
+    }
+};
+
+template<class... Ts>
+struct protobuf_codec_t<std::variant<Ts...>>
+{
+    static_assert(sizeof...(Ts) == 0, "std::variant has no protobuf representation, use optional fields instead.");
+};
+
+template<class T>
+concept protobuf_packable = Arithmetic<T> || Enum<T>;
+
+template<class T>
+inline constexpr bool is_string_literal_v = false;
+
+template<std::size_t N>
+inline constexpr bool is_string_literal_v<string_literal_t<N>> = true;
+
+template<class T>
+concept protobuf_repeated =
+    std::ranges::input_range<T> && !std::is_same_v<T, std::string> && !is_string_literal_v<T>;
+
+template<class T>
+struct protobuf_scalar
+{
+    using type = T;
+};
+
+template<is_optional T>
+struct protobuf_scalar<T>
+{
+    using type = typename T::value_type;
+};
+
+template<protobuf_repeated T>
+struct protobuf_scalar<T>
+{
+    using type = std::ranges::range_value_t<T>;
+};
+
+// only integer and floating point fields have alternative encodings
+template<class T, std::size_t... id>
+[[nodiscard]] constexpr bool protobuf_valid_encodings(std::index_sequence<id...>) noexcept
+{
+    constexpr auto encodings = protobuf_field_encodings_t<T>::value;
+    return ((encodings[id] == protobuf_encoding_t::standard ||
+             Arithmetic<typename protobuf_scalar<
+                 typename std::tuple_element_t<id, decltype(reflect<T>::fields())>::value_type>::type>) &&
+            ... && true);
+}
+
+template<class T, protobuf_encoding_t Encoding>
+[[nodiscard]] std::size_t protobuf_element_size(std::uint32_t number, const T& value, protobuf_sizes_t& sizes)
+{
+    using codec = protobuf_codec_t<T, Encoding>;
+    const auto key = varint_size(protobuf_key(number, codec::wire));
+    if constexpr (protobuf_message<T>) {
+        // the slot is taken before the nested messages take theirs, which is the order they are written in
+        const auto slot = sizes.values.size();
+        sizes.values.push_back(0);
+        const auto size = codec::size(value, sizes);
+        sizes.values[slot] = size;
+        return key + varint_size(size) + size;
+    } else {
+        const auto size = codec::size(value);
+        const auto prefix = codec::wire == protobuf_wire_t::length_delimited ? varint_size(size) : 0;
+        return key + prefix + size;
+    }
+}
+
+template<class T, protobuf_encoding_t Encoding>
+void protobuf_write_element(binary_writer_t& writer, std::uint32_t number, const T& value, protobuf_sizes_t& sizes)
+{
+    using codec = protobuf_codec_t<T, Encoding>;
+    writer.write_varint(protobuf_key(number, codec::wire));
+    if constexpr (protobuf_message<T>) {
+        writer.write_varint(sizes.values[sizes.next++]);
+        codec::encode(writer, value, sizes);
+    } else {
+        if constexpr (codec::wire == protobuf_wire_t::length_delimited) {
+            writer.write_varint(codec::size(value));
+        }
+        codec::encode(writer, value);
+    }
+}
+
+template<class T, protobuf_encoding_t Encoding>
+void protobuf_read_element(binary_reader_t& reader, protobuf_wire_t wire, T& value)
+{
+    using codec = protobuf_codec_t<T, Encoding>;
+    if (wire != codec::wire) {
+        throw std::runtime_error("Unexpected protobuf wire type.");
+    }
+    if constexpr (codec::wire == protobuf_wire_t::length_delimited) {
+        auto nested = protobuf_read_length_delimited(reader);
+        codec::decode(nested, value);
+    } else {
+        codec::decode(reader, value);
+    }
+}
+
+// Field level handling on top of the codecs: presence, repetition and packing. The count is the number of
+// elements decoded so far, it is only used by repeated fields.
+template<class T, protobuf_encoding_t Encoding>
+struct protobuf_field_t
+{
+    using codec = protobuf_codec_t<T, Encoding>;
+
+    [[nodiscard]] static std::size_t size(std::uint32_t number, const T& value, protobuf_sizes_t& sizes)
+    {
+        return codec::is_default(value) ? 0 : protobuf_element_size<T, Encoding>(number, value, sizes);
+    }
+
+    static void encode(binary_writer_t& writer, std::uint32_t number, const T& value, protobuf_sizes_t& sizes)
+    {
+        if (!codec::is_default(value)) {
+            protobuf_write_element<T, Encoding>(writer, number, value, sizes);
+        }
+    }
+
+    static void decode(binary_reader_t& reader, protobuf_wire_t wire, T& value, std::size_t&)
+    {
+        protobuf_read_element<T, Encoding>(reader, wire, value);
+    }
+};
+
+template<is_optional T, protobuf_encoding_t Encoding>
+struct protobuf_field_t<T, Encoding>
+{
+    using value_type = typename T::value_type;
+
+    static_assert(!protobuf_repeated<value_type> && !is_optional<value_type>,
+                  "Optional repeated fields have no protobuf representation.");
+
+    [[nodiscard]] static std::size_t size(std::uint32_t number, const T& value, protobuf_sizes_t& sizes)
+    {
+        return value ? protobuf_element_size<value_type, Encoding>(number, *value, sizes) : 0;
+    }
+
+    static void encode(binary_writer_t& writer, std::uint32_t number, const T& value, protobuf_sizes_t& sizes)
+    {
+        if (value) {
+            protobuf_write_element<value_type, Encoding>(writer, number, *value, sizes);
+        }
+    }
+
+    static void decode(binary_reader_t& reader, protobuf_wire_t wire, T& value, std::size_t&)
+    {
+        if (!value) {
+            value.emplace();
+        }
+        protobuf_read_element<value_type, Encoding>(reader, wire, *value);
+    }
+};
+
+template<protobuf_repeated Range, protobuf_encoding_t Encoding>
+struct protobuf_field_t<Range, Encoding>
+{
+    using value_type = std::ranges::range_value_t<Range>;
+    using codec = protobuf_codec_t<value_type, Encoding>;
+
+    static_assert(!protobuf_repeated<value_type> && !is_optional<value_type>,
+                  "Nested repeated fields have no protobuf representation, wrap the inner range in a message.");
+
+    static constexpr bool packed = protobuf_packable<value_type>;
+    static constexpr bool fixed_size = requires { std::tuple_size<Range>::value; };
+    static constexpr bool block_copy = packed && std::floating_point<value_type> &&
+                                       std::ranges::contiguous_range<Range> &&
+                                       std::endian::native == std::endian::little;
+
+    [[nodiscard]] static std::size_t packed_size(const Range& range)
+    {
+        if constexpr (codec::wire != protobuf_wire_t::varint && std::ranges::sized_range<Range>) {
+            return std::ranges::size(range) * sizeof(typename codec::fixed_type);
+        } else {
+            std::size_t size = 0;
+            for (const auto& element : range) {
+                size += codec::size(element);
+            }
+            return size;
+        }
+    }
+
+    [[nodiscard]] static std::size_t size(std::uint32_t number, const Range& range, protobuf_sizes_t& sizes)
+    {
+        if (std::ranges::empty(range)) {
+            return 0;
+        }
+        if constexpr (packed) {
+            const auto payload = packed_size(range);
+            return varint_size(protobuf_key(number, protobuf_wire_t::length_delimited)) + varint_size(payload) +
+                   payload;
+        } else {
+            std::size_t size = 0;
+            for (const auto& element : range) {
+                size += protobuf_element_size<value_type, Encoding>(number, element, sizes);
+            }
+            return size;
+        }
+    }
+
+    static void encode(binary_writer_t& writer, std::uint32_t number, const Range& range, protobuf_sizes_t& sizes)
+    {
+        if (std::ranges::empty(range)) {
+            return;
+        }
+        if constexpr (packed) {
+            writer.write_varint(protobuf_key(number, protobuf_wire_t::length_delimited));
+            writer.write_varint(packed_size(range));
+            if constexpr (block_copy) {
+                writer.write_bytes(std::ranges::data(range), std::ranges::size(range) * sizeof(value_type));
+            } else {
+                for (const auto& element : range) {
+                    codec::encode(writer, element);
+                }
+            }
+        } else {
+            for (const auto& element : range) {
+                protobuf_write_element<value_type, Encoding>(writer, number, element, sizes);
+            }
+        }
+    }
+
+    static void append(Range& range, std::size_t& count, value_type&& element)
+    {
+        if constexpr (fixed_size) {
+            if (count >= std::tuple_size_v<Range>) {
+                throw std::runtime_error("Too many elements for fixed size array.");
+            }
+            range[count] = std::move(element);
+        } else {
+            range.insert(range.end(), std::move(element));
+        }
+        ++count;
+    }
+
+    static void decode(binary_reader_t& reader, protobuf_wire_t wire, Range& range, std::size_t& count)
+    {
+        // parsers have to accept packed and unpacked encodings of packable fields
+        if (packed && wire == protobuf_wire_t::length_delimited) {
+            auto nested = protobuf_read_length_delimited(reader);
+            if constexpr (block_copy && requires(Range r) { r.resize(std::size_t{}); }) {
+                const auto elements = nested.remaining() / sizeof(value_type);
+                if (elements * sizeof(value_type) != nested.remaining()) {
+                    throw std::runtime_error("Invalid packed field size.");
+                }
+                range.resize(range.size() + elements);
+                nested.read_bytes(std::ranges::data(range) + range.size() - elements, elements * sizeof(value_type));
+                count += elements;
+            }
+            while (nested.remaining() != 0) {
+                value_type element{};
+                codec::decode(nested, element);
+                append(range, count, std::move(element));
+            }
+        } else {
+            value_type element{};
+            protobuf_read_element<value_type, Encoding>(reader, wire, element);
+            append(range, count, std::move(element));
+        }
+    }
+
+    static void finish(std::size_t count)
+    {
+        if constexpr (fixed_size) {
+            if (count != 0 && count != std::tuple_size_v<Range>) {
+                throw std::runtime_error("Too few elements for fixed size array.");
+            }
+        }
+    }
+};
+
+template<class T, protobuf_encoding_t Encoding>
+struct protobuf_codec_t
+{
+    static constexpr auto numbers = protobuf_field_numbers_t<T>::value;
+    static constexpr auto encodings = protobuf_field_encodings_t<T>::value;
+    static constexpr std::size_t field_count = std::tuple_size_v<decltype(reflect<T>::fields())>;
+
+    static_assert(Encoding == protobuf_encoding_t::standard, "Messages have no alternative encodings.");
+    static_assert(numbers.size() == field_count, "Every field needs exactly one protobuf field number.");
+    static_assert(protobuf_valid_field_numbers(numbers),
+                  "Protobuf field numbers must be unique and within [1, 2^29 - 1] excluding [19000, 19999].");
+    static_assert(encodings.size() == field_count, "Every field needs exactly one protobuf encoding.");
+    static_assert(protobuf_valid_encodings<T>(std::make_index_sequence<field_count>{}),
+                  "Only integer and floating point fields have alternative protobuf encodings.");
+
+    static constexpr bool is_message = true;
+    static constexpr protobuf_wire_t wire = protobuf_wire_t::length_delimited;
+
+    template<std::size_t id>
+    using field_t = protobuf_field_t<typename std::tuple_element_t<id, decltype(reflect<T>::fields())>::value_type,
+                                     encodings[id]>;
+
+    template<std::size_t id>
+    static constexpr auto field_pointer = std::get<id>(reflect<T>::fields()).ptr;
+
+    static constexpr std::uint32_t max_number = field_count == 0 ? 0 : std::ranges::max(numbers);
+
+    // small field numbers are resolved through a table, sparse numbering falls back to a linear search
+    static constexpr bool dense = field_count < 256 && max_number <= 2 * field_count + 16;
+    static constexpr auto index_table = [] {
+        std::array<std::uint8_t, dense ? max_number + 1 : 0> table{};
+        if constexpr (dense) {
+            std::ranges::fill(table, static_cast<std::uint8_t>(field_count));
+            for (std::size_t i = 0; i < field_count; ++i) {
+                table[numbers[i]] = static_cast<std::uint8_t>(i);
+            }
+        }
+        return table;
+    }();
+
+    [[nodiscard]] static std::size_t field_index(std::uint64_t number) noexcept
+    {
+        if constexpr (dense) {
+            return number < index_table.size() ? index_table[number] : field_count;
+        } else {
+            return static_cast<std::size_t>(std::ranges::find(numbers, number) - numbers.begin());
+        }
+    }
+
+    [[nodiscard]] static bool is_default(const T&) noexcept { return false; }
+
+    // Appends the sizes of the nested messages to sizes and returns the size of value.
+    [[nodiscard]] static std::size_t size(const T& value, protobuf_sizes_t& sizes)
+    {
+        // a comma fold, so the nested messages take their slots in declaration order
+        std::size_t size = 0;
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            ((size += field_t<id>::size(numbers[id], value.*field_pointer<id>, sizes)), ...);
+        }(std::make_index_sequence<field_count>{});
+        return size;
+    }
+
+    static void encode(binary_writer_t& writer, const T& value, protobuf_sizes_t& sizes)
+    {
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            (field_t<id>::encode(writer, numbers[id], value.*field_pointer<id>, sizes), ...);
+        }(std::make_index_sequence<field_count>{});
+    }
+
+    static void decode(binary_reader_t& reader, T& value)
+    {
+        std::array<std::size_t, field_count> counts{};
+        while (reader.remaining() != 0) {
+            const auto key = reader.read_varint();
+            const auto number = key >> 3;
+            const auto wire = static_cast<protobuf_wire_t>(key & 7);
+            if (number == 0 || number > protobuf_max_field_number) {
+                throw std::runtime_error("Invalid protobuf field number.");
+            }
+            const auto id = field_index(number);
+            if (id == field_count) {
+                protobuf_skip_field(reader, number, wire);
+                continue;
+            }
+            [&]<std::size_t... index>(std::index_sequence<index...>) {
+                ((index == id ? (field_t<index>::decode(reader, wire, value.*field_pointer<index>, counts[index]), true)
+                              : false) ||
+                 ...);
+            }(std::make_index_sequence<field_count>{});
+        }
+        [&]<std::size_t... id>(std::index_sequence<id...>) {
+            (
+                [&] {
+                    if constexpr (requires { field_t<id>::finish(std::size_t{}); }) {
+                        field_t<id>::finish(counts[id]);
+                    }
+                }(),
+                ...);
+        }(std::make_index_sequence<field_count>{});
+    }
+};
+
+}
+
+template<class T>
+void to_protobuf(const T& value, std::vector<std::byte>& buffer)
+{
+    detail::binary_writer_t writer{buffer};
+    detail::protobuf_sizes_t sizes;
+    buffer.reserve(buffer.size() + detail::protobuf_codec_t<T>::size(value, sizes));
+    detail::protobuf_codec_t<T>::encode(writer, value, sizes);
+}
+
+template<class T>
+[[nodiscard]] std::vector<std::byte> to_protobuf(const T& value)
+{
+    std::vector<std::byte> buffer;
+    to_protobuf(value, buffer);
+    return buffer;
+}
+
+template<class T, class... Validator>
+[[nodiscard]] T from_protobuf(std::span<const std::byte> buffer, Validator&&... validator)
+{
+    detail::binary_reader_t reader{buffer};
+    T result{};
+    detail::protobuf_codec_t<T>::decode(reader, result);
+    if ((true && ... && validator(result))) {
+        return result;
+    } else {
+        throw std::runtime_error("Validator was not satisfied.");
+    }
+}
+
+template<class T, class... Validator>
+[[nodiscard]] std::optional<T> try_from_protobuf(std::span<const std::byte> buffer, Validator&&... validator) noexcept
+{
+    try {
+        return from_protobuf<T>(buffer, std::forward<Validator>(validator)...);
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+}
@@ -0,0 +1,468 @@
+#pragma once
+
+#include "introspect.hpp"
+#include "kernels.hpp"
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Queries over random access ranges of reflected records, e.g.
+//   tsmp::query<job_t>()
+//       .where<"status">(tsmp::kernels::equal_to{ status_t::failed })
+//       .group_by<"region">()
+//       .aggregate(jobs, tsmp::count_of{}, tsmp::avg_of<"latency">{});
+// Field names are resolved when the query type is built, filters and aggregates are plain typed function objects.
+// The range is split into morsels, which worker threads claim one after another. Every worker keeps its own partial
+// aggregates, which are merged at the end. Selections and projections keep the order of the range.
+
+namespace tsmp {
+
+namespace detail {
+
+inline constexpr std::size_t query_morsel_size = 16 * 1024;
+
+template<class T, string_literal_t field, class Predicate>
+struct query_field_filter_t
+{
+    Predicate predicate;
+
+    [[nodiscard]] bool operator()(const T& record) const
+    {
+        return static_cast<bool>(predicate(record.*field_pointer<T, field>));
+    }
+};
+
+template<class T, class Predicate>
+struct query_record_filter_t
+{
+    Predicate predicate;
+
+    [[nodiscard]] bool operator()(const T& record) const { return static_cast<bool>(predicate(record)); }
+};
+
+// Calls function(worker, morsel, begin, end) for all morsels of [0, size). Exceptions are rethrown after all workers
+// finished.
+template<class Function>
+void query_for_each_morsel(std::size_t size, std::size_t workers, Function&& function)
+{
+    const auto morsels = (size + query_morsel_size - 1) / query_morsel_size;
+    std::atomic<std::size_t> next = 0;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    const auto work = [&](std::size_t worker) {
+        for (auto morsel = next++; morsel < morsels; morsel = next++) {
+            try {
+                const auto begin = morsel * query_morsel_size;
+                function(worker, morsel, begin, std::min(begin + query_morsel_size, size));
+            } catch (...) {
+                const std::lock_guard lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = morsels;
+            }
+        }
+    };
+    {
+        // jthreads join on destruction, so a failure to start a worker does not leave running threads behind
+        std::vector<std::jthread> threads;
+        for (std::size_t worker = 1; worker < workers; ++worker) {
+            threads.emplace_back(work, worker);
+        }
+        work(0);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+template<class... V>
+struct query_key_hash_t
+{
+    [[nodiscard]] std::size_t operator()(const std::tuple<V...>& key) const noexcept
+    {
+        return std::apply(
+            [](const auto&... value) {
+                std::size_t result = 0;
+                ((result = result * 0x9e3779b97f4a7c15 ^ std::hash<V>{}(value)), ...);
+                return result;
+            },
+            key);
+    }
+};
+
+}
+
+// aggregates for query::aggregate and grouped_query::aggregate
+struct count_of
+{
+    template<class T>
+    using state_type = std::size_t;
+
+    template<class T>
+    static void add(state_type<T>& state, const T&) noexcept
+    {
+        ++state;
+    }
+
+    template<class T>
+    static void merge(state_type<T>& state, const state_type<T>& other) noexcept
+    {
+        state += other;
+    }
+
+    template<class T>
+    [[nodiscard]] static std::size_t result(const state_type<T>& state) noexcept
+    {
+        return state;
+    }
+};
+
+// Sums in double for floating point fields and in 64 bit integers otherwise.
+template<string_literal_t field>
+struct sum_of
+{
+    template<class T>
+    using state_type = detail::kernel_sum_t<detail::field_type_t<T, field>>;
+
+    template<class T>
+    static void add(state_type<T>& state, const T& record) noexcept
+    {
+        state += static_cast<state_type<T>>(record.*detail::field_pointer<T, field>);
+    }
+
+    template<class T>
+    static void merge(state_type<T>& state, const state_type<T>& other) noexcept
+    {
+        state += other;
+    }
+
+    template<class T>
+    [[nodiscard]] static state_type<T> result(const state_type<T>& state) noexcept
+    {
+        return state;
+    }
+};
+
+// The average is NaN if no record matched.
+template<string_literal_t field>
+struct avg_of
+{
+    template<class T>
+    struct state_type
+    {
+        double sum = 0;
+        std::size_t count = 0;
+    };
+
+    template<class T>
+    static void add(state_type<T>& state, const T& record) noexcept
+    {
+        state.sum += static_cast<double>(record.*detail::field_pointer<T, field>);
+        ++state.count;
+    }
+
+    template<class T>
+    static void merge(state_type<T>& state, const state_type<T>& other) noexcept
+    {
+        state.sum += other.sum;
+        state.count += other.count;
+    }
+
+    template<class T>
+    [[nodiscard]] static double result(const state_type<T>& state) noexcept
+    {
+        return state.count == 0 ? std::numeric_limits<double>::quiet_NaN()
+                                : state.sum / static_cast<double>(state.count);
+    }
+};
+
+template<string_literal_t field>
+struct min_of
+{
+    template<class T>
+    using state_type = std::optional<detail::field_type_t<T, field>>;
+
+    template<class T>
+    static void add(state_type<T>& state, const T& record)
+    {
+        const auto& value = record.*detail::field_pointer<T, field>;
+        if (!state || value < *state) {
+            state = value;
+        }
+    }
+
+    template<class T>
+    static void merge(state_type<T>& state, const state_type<T>& other)
+    {
+        if (other && (!state || *other < *state)) {
+            state = other;
+        }
+    }
+
+    template<class T>
+    [[nodiscard]] static state_type<T> result(const state_type<T>& state)
+    {
+        return state;
+    }
+};
+
+template<string_literal_t field>
+struct max_of
+{
+    template<class T>
+    using state_type = std::optional<detail::field_type_t<T, field>>;
+
+    template<class T>
+    static void add(state_type<T>& state, const T& record)
+    {
+        const auto& value = record.*detail::field_pointer<T, field>;
+        if (!state || *state < value) {
+            state = value;
+        }
+    }
+
+    template<class T>
+    static void merge(state_type<T>& state, const state_type<T>& other)
+    {
+        if (other && (!state || *state < *other)) {
+            state = other;
+        }
+    }
+
+    template<class T>
+    [[nodiscard]] static state_type<T> result(const state_type<T>& state)
+    {
+        return state;
+    }
+};
+
+template<class T, class Query, string_literal_t... keys>
+class grouped_query;
+
+// Filters records of type T. Every where() returns a new query with one more filter.
+template<class T, class... Filters>
+class query
+{
+public:
+    query() = default;
+
+    query(std::tuple<Filters...> filters, std::size_t workers)
+        : filters(std::move(filters))
+        , workers(workers)
+    {
+    }
+
+    // Keeps the records whose field satisfies the predicate.
+    template<string_literal_t field, class Predicate>
+    [[nodiscard]] auto where(Predicate predicate) const
+    {
+        using filter_t = detail::query_field_filter_t<T, field, Predicate>;
+        return query<T, Filters..., filter_t>(std::tuple_cat(filters, std::tuple<filter_t>{std::move(predicate)}),
+                                              workers);
+    }
+
+    // Keeps the records that satisfy the predicate.
+    template<class Predicate>
+    [[nodiscard]] auto where(Predicate predicate) const
+    {
+        using filter_t = detail::query_record_filter_t<T, Predicate>;
+        return query<T, Filters..., filter_t>(std::tuple_cat(filters, std::tuple<filter_t>{std::move(predicate)}),
+                                              workers);
+    }
+
+    // Limits the number of worker threads, 1 runs the query on the calling thread.
+    [[nodiscard]] query threads(std::size_t count) const
+    {
+        auto result = *this;
+        result.workers = std::max<std::size_t>(count, 1);
+        return result;
+    }
+
+    template<string_literal_t... keys>
+    [[nodiscard]] grouped_query<T, query, keys...> group_by() const
+    {
+        return grouped_query<T, query, keys...>(*this);
+    }
+
+    [[nodiscard]] bool matches(const T& record) const
+    {
+        return std::apply([&](const auto&... filter) { return (true && ... && filter(record)); }, filters);
+    }
+
+    template<std::ranges::random_access_range Range>
+        requires std::ranges::sized_range<const Range>
+    [[nodiscard]] std::size_t count(const Range& range) const
+    {
+        return std::get<0>(aggregate(range, count_of{}));
+    }
+
+    // The matching records in their original order.
+    template<std::ranges::random_access_range Range>
+        requires std::ranges::sized_range<const Range>
+    [[nodiscard]] std::vector<T> select(const Range& range) const
+    {
+        return collect(range, [](const T& record) { return record; });
+    }
+
+    // The given fields of the matching records in their original order.
+    template<string_literal_t... fields, std::ranges::random_access_range Range>
+        requires std::ranges::sized_range<const Range>
+    [[nodiscard]] std::vector<std::tuple<detail::field_type_t<T, fields>...>> project(const Range& range) const
+    {
+        return collect(range, [](const T& record) {
+            return std::tuple<detail::field_type_t<T, fields>...>(record.*detail::field_pointer<T, fields>...);
+        });
+    }
+
+    // Returns the results of all aggregates over the matching records.
+    template<std::ranges::random_access_range Range, class... Aggregates>
+        requires std::ranges::sized_range<const Range>
+    [[nodiscard]] auto aggregate(const Range& range, Aggregates...) const
+    {
+        using state_t = std::tuple<typename Aggregates::template state_type<T>...>;
+        std::vector<state_t> states(worker_count(range));
+        run(range, [&](std::size_t worker, std::size_t, const T& record) {
+            std::apply([&](auto&... state) { (Aggregates::template add<T>(state, record), ...); }, states[worker]);
+        });
+        auto& result = states.front();
+        for (std::size_t worker = 1; worker < states.size(); ++worker) {
+            merge<Aggregates...>(result, states[worker]);
+        }
+        return std::apply([](const auto&... state) { return std::tuple(Aggregates::template result<T>(state)...); },
+                          result);
+    }
+
+private:
+    template<class, class, string_literal_t...>
+    friend class grouped_query;
+
+    template<class... Aggregates, class State>
+    static void merge(State& state, const State& other)
+    {
+        [&]<std::size_t... index>(std::index_sequence<index...>) {
+            (Aggregates::template merge<T>(std::get<index>(state), std::get<index>(other)), ...);
+        }(std::index_sequence_for<Aggregates...>{});
+    }
+
+    template<class Range>
+    [[nodiscard]] std::size_t worker_count(const Range& range) const
+    {
+        const auto morsels = (std::ranges::size(range) + detail::query_morsel_size - 1) / detail::query_morsel_size;
+        return std::clamp<std::size_t>(morsels, 1, workers);
+    }
+
+    // calls function(worker, morsel, record) for all matching records
+    template<class Range, class Function>
+    void run(const Range& range, Function&& function) const
+    {
+        const auto first = std::ranges::begin(range);
+        detail::query_for_each_morsel(
+            std::ranges::size(range), worker_count(range), [&](auto worker, auto morsel, auto begin, auto end) {
+                for (auto i = begin; i < end; ++i) {
+                    const T& record = first[static_cast<std::ptrdiff_t>(i)];
+                    if (matches(record)) {
+                        function(worker, morsel, record);
+                    }
+                }
+            });
+    }
+
+    template<class Range, class Projection>
+    [[nodiscard]] auto collect(const Range& range, Projection projection) const
+    {
+        using value_type = std::invoke_result_t<Projection, const T&>;
+        const auto size = static_cast<std::size_t>(std::ranges::size(range));
+        const auto morsel_count = (size + detail::query_morsel_size - 1) / detail::query_morsel_size;
+        std::vector<std::vector<value_type>> morsels(morsel_count);
+        run(range, [&](std::size_t, std::size_t morsel, const T& record) {
+            morsels[morsel].push_back(projection(record));
+        });
+        std::vector<value_type> result;
+        for (auto& morsel : morsels) {
+            std::ranges::move(morsel, std::back_inserter(result));
+        }
+        return result;
+    }
+
+    std::tuple<Filters...> filters;
+    std::size_t workers = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+};
+
+// A query whose matching records are aggregated per distinct combination of the key fields.
+template<class T, class Query, string_literal_t... keys>
+class grouped_query
+{
+public:
+    using key_type = std::tuple<detail::field_type_t<T, keys>...>;
+
+    explicit grouped_query(Query query)
+        : filter(std::move(query))
+    {
+    }
+
+    // Returns one tuple of the keys followed by the aggregate results per group, ordered by the keys.
+    template<std::ranges::random_access_range Range, class... Aggregates>
+        requires std::ranges::sized_range<const Range>
+    [[nodiscard]] auto aggregate(const Range& range, Aggregates...) const
+    {
+        using state_t = std::tuple<typename Aggregates::template state_type<T>...>;
+        using hash_t = detail::query_key_hash_t<detail::field_type_t<T, keys>...>;
+        using groups_t = std::unordered_map<key_type, state_t, hash_t>;
+        std::vector<groups_t> groups(filter.worker_count(range));
+        filter.run(range, [&](std::size_t worker, std::size_t, const T& record) {
+            auto& state = groups[worker][key_type(record.*detail::field_pointer<T, keys>...)];
+            std::apply([&](auto&... value) { (Aggregates::template add<T>(value, record), ...); }, state);
+        });
+        auto& merged = groups.front();
+        for (std::size_t worker = 1; worker < groups.size(); ++worker) {
+            for (auto& [key, state] : groups[worker]) {
+                const auto [position, inserted] = merged.try_emplace(key, std::move(state));
+                if (!inserted) {
+                    Query::template merge<Aggregates...>(position->second, state);
+                }
+            }
+        }
+
+        using row_t = decltype(std::tuple_cat(std::declval<key_type>(), std::declval<result_t<Aggregates...>>()));
+        std::vector<row_t> result;
+        result.reserve(merged.size());
+        for (const auto& [key, state] : merged) {
+            result.push_back(std::tuple_cat(key, std::apply([](const auto&... value) {
+                return result_t<Aggregates...>(Aggregates::template result<T>(value)...);
+            }, state)));
+        }
+        std::ranges::sort(result, [](const row_t& lhs, const row_t& rhs) {
+            return [&]<std::size_t... index>(std::index_sequence<index...>) {
+                return std::forward_as_tuple(std::get<index>(lhs)...) < std::forward_as_tuple(std::get<index>(rhs)...);
+            }(std::index_sequence_for<decltype(keys)...>{});
+        });
+        return result;
+    }
+
+private:
+    template<class... Aggregates>
+    using result_t = std::tuple<decltype(Aggregates::template result<T>(
+        std::declval<const typename Aggregates::template state_type<T>&>()))...>;
+
+    Query filter;
+};
+
+}
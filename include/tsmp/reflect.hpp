@@ -1,5 +1,7 @@
 #pragma once
+#include <concepts>
 #include <cstdint>
+#include <optional>
 #include <range/v3/algorithm/find.hpp>
 #include <range/v3/algorithm/transform.hpp>
 #include <string_view>
@@ -32,6 +34,12 @@ function_description_t(size_t, std::string_view, T) -> function_description_t<T>
 template<class T>
 concept Enum = std::is_enum_v<T>;
 
+template<class T>
+concept Arithmetic = std::floating_point<T> || std::integral<T>;
+
+template<class T>
+concept is_optional = std::is_same_v<T, std::optional<typename T::value_type>>;
+
 template<Enum E>
 struct enum_entry_description_t
 {
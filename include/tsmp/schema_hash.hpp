@@ -0,0 +1,160 @@
+#pragma once
+
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+namespace tsmp {
+
+namespace detail {
+
+inline constexpr std::uint64_t fnv1a_offset_basis = 14695981039346656037ull;
+inline constexpr std::uint64_t fnv1a_prime = 1099511628211ull;
+
+[[nodiscard]] constexpr std::uint64_t fnv1a(std::uint64_t hash, std::uint64_t value) noexcept
+{
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        hash = (hash ^ ((value >> (8 * i)) & 0xff)) * fnv1a_prime;
+    }
+    return hash;
+}
+
+[[nodiscard]] constexpr std::uint64_t fnv1a(std::uint64_t hash, std::string_view value) noexcept
+{
+    // the length prefix keeps adjacent names from running into each other
+    hash = fnv1a(hash, value.size());
+    for (const char c : value) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * fnv1a_prime;
+    }
+    return hash;
+}
+
+// Each specialisation folds a description of its type into the running hash. Visiting holds the records currently
+// being hashed, so self referencing types like a node with a vector of children terminate.
+template<class T, class... Visiting>
+struct schema_hash_t;
+
+template<Arithmetic T, class... Visiting>
+struct schema_hash_t<T, Visiting...>
+{
+    [[nodiscard]] static constexpr std::uint64_t combine(std::uint64_t hash) noexcept
+    {
+        const std::string_view kind = std::is_same_v<T, bool> ? "bool"
+                                      : std::floating_point<T> ? "float"
+                                      : std::is_signed_v<T>    ? "int"
+                                                               : "uint";
+        return fnv1a(fnv1a(hash, kind), sizeof(T));
+    }
+};
+
+template<Enum T, class... Visiting>
+struct schema_hash_t<T, Visiting...>
+{
+    [[nodiscard]] static constexpr std::uint64_t combine(std::uint64_t hash) noexcept
+    {
+        hash = schema_hash_t<std::underlying_type_t<T>>::combine(fnv1a(hash, "enum"));
+        hash = fnv1a(hash, enum_values<T>.size());
+        for (std::size_t i = 0; i < enum_values<T>.size(); ++i) {
+            hash = fnv1a(fnv1a(hash, enum_names<T>[i]), static_cast<std::uint64_t>(enum_values<T>[i]));
+        }
+        return hash;
+    }
+};
+
+template<class... Visiting>
+struct schema_hash_t<std::string, Visiting...>
+{
+    [[nodiscard]] static constexpr std::uint64_t combine(std::uint64_t hash) noexcept { return fnv1a(hash, "string"); }
+};
+
+template<std::size_t N, class... Visiting>
+struct schema_hash_t<string_literal_t<N>, Visiting...>
+{
+    [[nodiscard]] static constexpr std::uint64_t combine(std::uint64_t hash) noexcept
+    {
+        return fnv1a(fnv1a(hash, "string_literal"), N);
+    }
+};
+
+template<is_optional T, class... Visiting>
+struct schema_hash_t<T, Visiting...>
+{
+    [[nodiscard]] static constexpr std::uint64_t combine(std::uint64_t hash) noexcept
+    {
+        return schema_hash_t<typename T::value_type, Visiting...>::combine(fnv1a(hash, "optional"));
+    }
+};
+
+template<class... Ts, class... Visiting>
+struct schema_hash_t<std::variant<Ts...>, Visiting...>
+{
+    [[nodiscard]] static constexpr std::uint64_t combine(std::uint64_t hash) noexcept
+    {
+        hash = fnv1a(fnv1a(hash, "variant"), sizeof...(Ts));
+        ((hash = schema_hash_t<Ts, Visiting...>::combine(hash)), ...);
+        return hash;
+    }
+};
+
+template<std::ranges::input_range Range, class... Visiting>
+    requires(!std::is_same_v<Range, std::string>)
+struct schema_hash_t<Range, Visiting...>
+{
+    [[nodiscard]] static constexpr std::uint64_t combine(std::uint64_t hash) noexcept
+    {
+        // containers with the same encoding (vector, deque, list, ...) share one description
+        if constexpr (requires { std::tuple_size<Range>::value; }) {
+            hash = fnv1a(fnv1a(hash, "array"), std::tuple_size_v<Range>);
+        } else {
+            hash = fnv1a(hash, "range");
+        }
+        return schema_hash_t<std::ranges::range_value_t<Range>, Visiting...>::combine(hash);
+    }
+};
+
+template<class T, class... Visiting>
+struct schema_hash_t
+{
+    [[nodiscard]] static constexpr std::uint64_t combine(std::uint64_t hash) noexcept
+    {
+        if constexpr ((std::is_same_v<T, Visiting> || ...)) {
+            // a back reference is identified by how many records up the type was entered
+            std::uint64_t depth = 0;
+            bool found = false;
+            ((found = found || std::is_same_v<T, Visiting>, depth += found ? 0 : 1), ...);
+            return fnv1a(fnv1a(hash, "recursion"), depth);
+        } else {
+            hash = fnv1a(fnv1a(hash, "record"), std::string_view(reflect<T>::name()));
+            return std::apply(
+                [hash](auto... decls) {
+                    auto result = fnv1a(hash, sizeof...(decls));
+                    ((result = schema_hash_t<typename decltype(decls)::value_type, T, Visiting...>::combine(
+                          fnv1a(result, decls.name))),
+                     ...);
+                    return result;
+                },
+                reflect<T>::fields());
+        }
+    }
+};
+
+}
+
+// Fingerprint of the serialized shape of T. It covers the name of every reflected record, the names, order and types
+// of their fields and the entries of enumerations, but not the memory layout of the types.
+template<class T>
+constexpr std::uint64_t schema_hash =
+    detail::schema_hash_t<std::remove_const_t<T>>::combine(detail::fnv1a_offset_basis);
+
+}
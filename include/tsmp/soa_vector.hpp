@@ -0,0 +1,497 @@
+#pragma once
+
+#include "introspect.hpp"
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tsmp {
+
+template<class T>
+class soa_vector;
+
+namespace detail {
+
+template<class T>
+using soa_fields_t = decltype(reflect<T>::fields());
+
+template<class T, std::size_t id>
+using soa_field_type_t = typename std::tuple_element_t<id, soa_fields_t<T>>::value_type;
+
+// one pointer to the first element of every column
+template<class T>
+using soa_columns_t = decltype(std::apply(
+    [](auto... decls) { return std::tuple<typename decltype(decls)::value_type*...>{}; },
+    reflect<T>::fields()));
+
+// calls function with std::integral_constant<std::size_t, id> for every field, so the id can select a column
+template<class T, class Function>
+constexpr void soa_for_each_field(Function&& function)
+{
+    [&]<std::size_t... id>(std::index_sequence<id...>) {
+        (function(std::integral_constant<std::size_t, id>{}), ...);
+    }(std::make_index_sequence<std::tuple_size_v<soa_fields_t<T>>>{});
+}
+
+template<class T, std::size_t id>
+inline constexpr auto soa_field_pointer = std::get<id>(reflect<T>::fields()).ptr;
+
+}
+
+// Stands in for T& of an element of a soa_vector. Fields are accessed by get<"name">(), the whole element is read by
+// converting to T and written by assigning a T. Assigning one reference to another copies the values.
+template<class T>
+class soa_reference
+{
+public:
+    using value_type = std::remove_const_t<T>;
+    using vector_type = std::conditional_t<std::is_const_v<T>, const soa_vector<value_type>, soa_vector<value_type>>;
+
+    soa_reference(vector_type& vector, std::size_t index) noexcept
+        : vector(&vector)
+        , index(index)
+    {
+    }
+
+    soa_reference(const soa_reference&) noexcept = default;
+
+    template<class U>
+        requires(std::is_const_v<T> && std::is_same_v<U, value_type>)
+    soa_reference(const soa_reference<U>& other) noexcept
+        : vector(other.vector)
+        , index(other.index)
+    {
+    }
+
+    template<std::size_t id>
+    [[nodiscard]] auto& get() const noexcept
+    {
+        return vector->template column<id>()[index];
+    }
+
+    template<string_literal_t name>
+    [[nodiscard]] auto& get() const noexcept
+    {
+        return vector->template column<name>()[index];
+    }
+
+    [[nodiscard]] operator value_type() const
+    {
+        value_type result{};
+        detail::soa_for_each_field<value_type>(
+            [&](auto id) { result.*detail::soa_field_pointer<value_type, id> = get<id>(); });
+        return result;
+    }
+
+    const soa_reference& operator=(const value_type& value) const
+        requires(!std::is_const_v<T>)
+    {
+        detail::soa_for_each_field<value_type>(
+            [&](auto id) { get<id>() = value.*detail::soa_field_pointer<value_type, id>; });
+        return *this;
+    }
+
+    const soa_reference& operator=(value_type&& value) const
+        requires(!std::is_const_v<T>)
+    {
+        detail::soa_for_each_field<value_type>(
+            [&](auto id) { get<id>() = std::move(value.*detail::soa_field_pointer<value_type, id>); });
+        return *this;
+    }
+
+    const soa_reference& operator=(const soa_reference& other) const
+        requires(!std::is_const_v<T>)
+    {
+        detail::soa_for_each_field<value_type>([&](auto id) { get<id>() = other.template get<id>(); });
+        return *this;
+    }
+
+    friend void swap(const soa_reference& lhs, const soa_reference& rhs)
+        requires(!std::is_const_v<T>)
+    {
+        detail::soa_for_each_field<value_type>([&](auto id) {
+            using std::swap;
+            swap(lhs.template get<id>(), rhs.template get<id>());
+        });
+    }
+
+    [[nodiscard]] std::size_t position() const noexcept { return index; }
+
+private:
+    template<class U>
+    friend class soa_reference;
+
+    vector_type* vector;
+    std::size_t index;
+};
+
+// Stores every field of T in its own contiguous column, so loops over a few fields only touch their memory.
+template<class T>
+class soa_vector
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = soa_reference<T>;
+    using const_reference = soa_reference<const T>;
+
+    template<class Reference>
+    class basic_iterator
+    {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using reference = Reference;
+        using iterator_category = std::random_access_iterator_tag;
+
+        basic_iterator() = default;
+
+        basic_iterator(typename Reference::vector_type* vector, std::size_t index) noexcept
+            : vector(vector)
+            , index(index)
+        {
+        }
+
+        [[nodiscard]] reference operator*() const noexcept { return reference(*vector, index); }
+
+        [[nodiscard]] reference operator[](difference_type offset) const noexcept
+        {
+            return reference(*vector, static_cast<std::size_t>(static_cast<difference_type>(index) + offset));
+        }
+
+        basic_iterator& operator++() noexcept
+        {
+            ++index;
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept { return basic_iterator(vector, index++); }
+
+        basic_iterator& operator--() noexcept
+        {
+            --index;
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept { return basic_iterator(vector, index--); }
+
+        basic_iterator& operator+=(difference_type offset) noexcept
+        {
+            index = static_cast<std::size_t>(static_cast<difference_type>(index) + offset);
+            return *this;
+        }
+
+        basic_iterator& operator-=(difference_type offset) noexcept { return *this += -offset; }
+
+        [[nodiscard]] friend basic_iterator operator+(basic_iterator it, difference_type offset) noexcept
+        {
+            return it += offset;
+        }
+
+        [[nodiscard]] friend basic_iterator operator+(difference_type offset, basic_iterator it) noexcept
+        {
+            return it += offset;
+        }
+
+        [[nodiscard]] friend basic_iterator operator-(basic_iterator it, difference_type offset) noexcept
+        {
+            return it -= offset;
+        }
+
+        [[nodiscard]] friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) noexcept
+        {
+            return static_cast<difference_type>(lhs.index) - static_cast<difference_type>(rhs.index);
+        }
+
+        [[nodiscard]] friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept
+        {
+            return lhs.index == rhs.index;
+        }
+
+        [[nodiscard]] friend auto operator<=>(const basic_iterator& lhs, const basic_iterator& rhs) noexcept
+        {
+            return lhs.index <=> rhs.index;
+        }
+
+    private:
+        typename Reference::vector_type* vector = nullptr;
+        std::size_t index = 0;
+    };
+
+    using iterator = basic_iterator<reference>;
+    using const_iterator = basic_iterator<const_reference>;
+
+    soa_vector() = default;
+
+    soa_vector(const soa_vector& other)
+    {
+        if (other.count == 0) {
+            return;
+        }
+        auto copied = allocate(other.count);
+        fill_columns(copied, other.count, other.count, [&](auto id, auto* column) {
+            std::uninitialized_copy_n(other.template column_data<id>(), other.count, column);
+        });
+        columns = copied;
+        count = other.count;
+        reserved = other.count;
+    }
+
+    soa_vector(soa_vector&& other) noexcept
+        : columns(std::exchange(other.columns, {}))
+        , count(std::exchange(other.count, 0))
+        , reserved(std::exchange(other.reserved, 0))
+    {
+    }
+
+    soa_vector& operator=(soa_vector other) noexcept
+    {
+        std::swap(columns, other.columns);
+        std::swap(count, other.count);
+        std::swap(reserved, other.reserved);
+        return *this;
+    }
+
+    ~soa_vector()
+    {
+        clear();
+        deallocate(columns, reserved);
+    }
+
+    [[nodiscard]] size_type size() const noexcept { return count; }
+
+    [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+    [[nodiscard]] size_type capacity() const noexcept { return reserved; }
+
+    void reserve(size_type capacity)
+    {
+        if (capacity <= reserved) {
+            return;
+        }
+        // like std::vector, the elements are copied if a field may throw while moving, so that a failure leaves the
+        // vector unchanged
+        constexpr bool nothrow_move = [] {
+            bool result = true;
+            detail::soa_for_each_field<T>([&](auto id) {
+                result = result && std::is_nothrow_move_constructible_v<detail::soa_field_type_t<T, id>>;
+            });
+            return result;
+        }();
+        auto grown = allocate(capacity);
+        fill_columns(grown, capacity, count, [&](auto id, auto* column) {
+            if constexpr (nothrow_move || !std::is_copy_constructible_v<detail::soa_field_type_t<T, id>>) {
+                std::uninitialized_move_n(column_data<id>(), count, column);
+            } else {
+                std::uninitialized_copy_n(column_data<id>(), count, column);
+            }
+        });
+        destroy(0, count);
+        deallocate(columns, reserved);
+        columns = grown;
+        reserved = capacity;
+    }
+
+    void push_back(const T& value)
+    {
+        grow_for_one();
+        construct_back([&](auto id) -> const auto& { return value.*detail::soa_field_pointer<T, id>; });
+    }
+
+    void push_back(T&& value)
+    {
+        grow_for_one();
+        construct_back([&](auto id) -> auto&& { return std::move(value.*detail::soa_field_pointer<T, id>); });
+    }
+
+    void pop_back()
+    {
+        destroy(count - 1, count);
+        --count;
+    }
+
+    void clear() noexcept
+    {
+        destroy(0, count);
+        count = 0;
+    }
+
+    [[nodiscard]] reference operator[](size_type index) noexcept { return reference(*this, index); }
+
+    [[nodiscard]] const_reference operator[](size_type index) const noexcept { return const_reference(*this, index); }
+
+    [[nodiscard]] reference at(size_type index)
+    {
+        check(index);
+        return (*this)[index];
+    }
+
+    [[nodiscard]] const_reference at(size_type index) const
+    {
+        check(index);
+        return (*this)[index];
+    }
+
+    [[nodiscard]] reference front() noexcept { return (*this)[0]; }
+
+    [[nodiscard]] const_reference front() const noexcept { return (*this)[0]; }
+
+    [[nodiscard]] reference back() noexcept { return (*this)[count - 1]; }
+
+    [[nodiscard]] const_reference back() const noexcept { return (*this)[count - 1]; }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator(this, 0); }
+
+    [[nodiscard]] iterator end() noexcept { return iterator(this, count); }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+    [[nodiscard]] const_iterator end() const noexcept { return const_iterator(this, count); }
+
+    template<std::size_t id>
+    [[nodiscard]] std::span<detail::soa_field_type_t<T, id>> column() noexcept
+    {
+        return {column_data<id>(), count};
+    }
+
+    template<std::size_t id>
+    [[nodiscard]] std::span<const detail::soa_field_type_t<T, id>> column() const noexcept
+    {
+        return {column_data<id>(), count};
+    }
+
+    template<string_literal_t name>
+    [[nodiscard]] auto column() noexcept
+    {
+        return column<introspect<T>::field_id(name)>();
+    }
+
+    template<string_literal_t name>
+    [[nodiscard]] auto column() const noexcept
+    {
+        return column<introspect<T>::field_id(name)>();
+    }
+
+private:
+    using columns_t = detail::soa_columns_t<T>;
+
+    template<std::size_t id>
+    [[nodiscard]] auto* column_data() const noexcept
+    {
+        return std::get<id>(columns);
+    }
+
+    [[nodiscard]] static columns_t allocate(size_type capacity)
+    {
+        columns_t result{};
+        try {
+            std::apply(
+                [&](auto*&... column) {
+                    ((column = std::allocator<std::remove_pointer_t<std::remove_reference_t<decltype(column)>>>{}
+                                   .allocate(capacity)),
+                     ...);
+                },
+                result);
+        } catch (...) {
+            deallocate(result, capacity);
+            throw;
+        }
+        return result;
+    }
+
+    static void deallocate(columns_t& columns, size_type capacity) noexcept
+    {
+        std::apply(
+            [&](auto*&... column) {
+                (
+                    [&] {
+                        if (column != nullptr) {
+                            std::allocator<std::remove_pointer_t<std::remove_reference_t<decltype(column)>>>{}
+                                .deallocate(column, capacity);
+                            column = nullptr;
+                        }
+                    }(),
+                    ...);
+            },
+            columns);
+    }
+
+    // fill(id, column) constructs size elements in the column id of the newly allocated target. If it throws, the
+    // columns filled before are destroyed and target is deallocated, the throwing column cleans up after itself.
+    template<class Fill>
+    static void fill_columns(columns_t& target, size_type capacity, size_type size, Fill&& fill)
+    {
+        std::size_t filled = 0;
+        try {
+            detail::soa_for_each_field<T>([&](auto id) {
+                fill(id, std::get<id>(target));
+                ++filled;
+            });
+        } catch (...) {
+            detail::soa_for_each_field<T>([&](auto id) {
+                if (id < filled) {
+                    std::destroy_n(std::get<id>(target), size);
+                }
+            });
+            deallocate(target, capacity);
+            throw;
+        }
+    }
+
+    void destroy(size_type first, size_type last) noexcept
+    {
+        std::apply([&](auto*... column) { (std::destroy(column + first, column + last), ...); }, columns);
+    }
+
+    void grow_for_one()
+    {
+        if (count == reserved) {
+            reserve(std::max<size_type>(2 * reserved, 8));
+        }
+    }
+
+    // constructs the new element field by field, a throwing constructor rolls back the fields constructed before
+    template<class Source>
+    void construct_back(Source&& source)
+    {
+        std::size_t constructed = 0;
+        try {
+            detail::soa_for_each_field<T>([&](auto id) {
+                std::construct_at(column_data<id>() + count, source(id));
+                ++constructed;
+            });
+        } catch (...) {
+            detail::soa_for_each_field<T>([&](auto id) {
+                if (id < constructed) {
+                    std::destroy_at(column_data<id>() + count);
+                }
+            });
+            throw;
+        }
+        ++count;
+    }
+
+    void check(size_type index) const
+    {
+        if (index >= count) {
+            throw std::out_of_range("soa_vector index out of range.");
+        }
+    }
+
+    columns_t columns{};
+    size_type count = 0;
+    size_type reserved = 0;
+};
+
+}
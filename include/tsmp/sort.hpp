@@ -0,0 +1,247 @@
+#pragma once
+
+#include "introspect.hpp"
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Sorting of records by reflected fields. Arithmetic and enum fields are mapped to unsigned keys that compare like
+// the field values, enums by their position in enum_values. The index of every record is sorted by these keys with
+// a least significant digit radix sort, then the records are moved into place once. Digits in which all keys
+// agree are skipped. Fields without a radix key, e.g. strings, fall back to a comparison sort.
+
+namespace tsmp {
+
+namespace detail {
+
+template<class V>
+struct sort_key_t;
+
+template<std::unsigned_integral V>
+struct sort_key_t<V>
+{
+    static constexpr std::size_t bytes = sizeof(V);
+    [[nodiscard]] static constexpr std::uint64_t key(V value) noexcept { return value; }
+};
+
+template<std::signed_integral V>
+struct sort_key_t<V>
+{
+    static constexpr std::size_t bytes = sizeof(V);
+    [[nodiscard]] static constexpr std::uint64_t key(V value) noexcept
+    {
+        using unsigned_t = std::make_unsigned_t<V>;
+        return static_cast<unsigned_t>(static_cast<unsigned_t>(value) ^ (unsigned_t{1} << (8 * sizeof(V) - 1)));
+    }
+};
+
+// negative numbers have their bits inverted, positive ones their sign bit set
+template<std::floating_point V>
+    requires(sizeof(V) == 4 || sizeof(V) == 8)
+struct sort_key_t<V>
+{
+    static constexpr std::size_t bytes = sizeof(V);
+    [[nodiscard]] static constexpr std::uint64_t key(V value) noexcept
+    {
+        using bits_t = std::conditional_t<sizeof(V) == 4, std::uint32_t, std::uint64_t>;
+        constexpr auto sign = bits_t{1} << (8 * sizeof(V) - 1);
+        const auto bits = std::bit_cast<bits_t>(value);
+        return (bits & sign) != 0 ? static_cast<bits_t>(~bits) : static_cast<bits_t>(bits | sign);
+    }
+};
+
+template<Enum V>
+struct sort_key_t<V>
+{
+    static constexpr auto size = enum_values<V>.size();
+    static constexpr std::size_t bytes = size < 0x100 ? 1 : size < 0x10000 ? 2 : 4;
+
+    static constexpr bool sequential = [] {
+        for (std::size_t i = 0; i < size; ++i) {
+            if (static_cast<std::uint64_t>(enum_values<V>[i]) != i) {
+                return false;
+            }
+        }
+        return true;
+    }();
+
+    // values outside of the enumeration sort last
+    [[nodiscard]] static constexpr std::uint64_t key(V value) noexcept
+    {
+        if constexpr (sequential) {
+            return std::min(static_cast<std::uint64_t>(value), std::uint64_t{size});
+        } else {
+            return static_cast<std::uint64_t>(std::ranges::find(enum_values<V>, value) - enum_values<V>.begin());
+        }
+    }
+};
+
+template<class V>
+concept sort_radix_key = requires(V value) {
+    {
+        sort_key_t<V>::key(value)
+    } -> std::same_as<std::uint64_t>;
+};
+
+template<class T, string_literal_t field>
+[[nodiscard]] constexpr decltype(auto) sort_compare_value(const T& record)
+{
+    using value_type = field_type_t<T, field>;
+    if constexpr (sort_radix_key<value_type>) {
+        return sort_key_t<value_type>::key(record.*field_pointer<T, field>);
+    } else {
+        return (record.*field_pointer<T, field>);
+    }
+}
+
+template<string_literal_t... fields, class T>
+[[nodiscard]] constexpr bool sort_less(const T& lhs, const T& rhs)
+{
+    return std::forward_as_tuple(sort_compare_value<T, fields>(lhs)...) <
+           std::forward_as_tuple(sort_compare_value<T, fields>(rhs)...);
+}
+
+template<class Index>
+struct sort_item_t
+{
+    std::uint64_t key;
+    Index index;
+};
+
+// 11 bit digits need fewer scatter passes than bytes, while the histograms still fit into the L1 cache
+inline constexpr std::size_t sort_digit_bits = 11;
+
+// sorts the items by their keys, which have the given number of significant bits
+template<class Index>
+void sort_radix_pass(std::vector<sort_item_t<Index>>& items, std::vector<sort_item_t<Index>>& buffer, std::size_t bits)
+{
+    constexpr std::uint64_t mask = (std::uint64_t{1} << sort_digit_bits) - 1;
+    const auto size = items.size();
+    const auto digits = (bits + sort_digit_bits - 1) / sort_digit_bits;
+    std::vector<std::array<Index, mask + 1>> histograms(digits);
+    for (const auto& item : items) {
+        for (std::size_t digit = 0; digit < digits; ++digit) {
+            ++histograms[digit][(item.key >> (sort_digit_bits * digit)) & mask];
+        }
+    }
+    for (std::size_t digit = 0; digit < digits; ++digit) {
+        auto& histogram = histograms[digit];
+        if (std::ranges::find(histogram, size) != histogram.end()) {
+            continue;
+        }
+        Index position = 0;
+        for (auto& count : histogram) {
+            position += std::exchange(count, position);
+        }
+        for (const auto& item : items) {
+            buffer[histogram[(item.key >> (sort_digit_bits * digit)) & mask]++] = item;
+        }
+        items.swap(buffer);
+    }
+}
+
+// sorts by the last field first, so that the more significant fields decide in the end
+template<class T, class Index, string_literal_t field, string_literal_t... rest, class Iterator>
+void sort_radix_fields(Iterator first, std::vector<sort_item_t<Index>>& items, std::vector<sort_item_t<Index>>& buffer)
+{
+    if constexpr (sizeof...(rest) > 0) {
+        sort_radix_fields<T, Index, rest...>(first, items, buffer);
+    }
+    using field_type = field_type_t<T, field>;
+    for (auto& item : items) {
+        const auto& record = first[static_cast<std::ptrdiff_t>(item.index)];
+        item.key = sort_key_t<field_type>::key(record.*field_pointer<T, field>);
+    }
+    sort_radix_pass(items, buffer, 8 * sort_key_t<field_type>::bytes);
+}
+
+template<class T, string_literal_t... fields>
+inline constexpr std::size_t sort_key_bytes = (sort_key_t<field_type_t<T, fields>>::bytes + ...);
+
+template<class V>
+[[nodiscard]] constexpr std::uint64_t sort_append_key(std::uint64_t key, const V& value) noexcept
+{
+    if constexpr (sort_key_t<V>::bytes == 8) {
+        return sort_key_t<V>::key(value);
+    } else {
+        return key << (8 * sort_key_t<V>::bytes) | sort_key_t<V>::key(value);
+    }
+}
+
+// keys of fields that fit into 64 bits together are combined, the first field takes the highest bits
+template<class T, string_literal_t... fields>
+[[nodiscard]] constexpr std::uint64_t sort_combined_key(const T& record) noexcept
+{
+    std::uint64_t key = 0;
+    ((key = sort_append_key(key, record.*field_pointer<T, fields>)), ...);
+    return key;
+}
+
+template<class T, class Index, string_literal_t... fields, class Iterator>
+void sort_radix(Iterator first, std::size_t size)
+{
+    std::vector<sort_item_t<Index>> items(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        items[i].index = static_cast<Index>(i);
+    }
+    std::vector<sort_item_t<Index>> buffer(size);
+    if constexpr (sort_key_bytes<T, fields...> <= 8) {
+        for (std::size_t i = 0; i < size; ++i) {
+            items[i].key = sort_combined_key<T, fields...>(first[static_cast<std::ptrdiff_t>(i)]);
+        }
+        sort_radix_pass(items, buffer, 8 * sort_key_bytes<T, fields...>);
+    } else {
+        sort_radix_fields<T, Index, fields...>(first, items, buffer);
+    }
+
+    std::vector<T> sorted;
+    sorted.reserve(size);
+    for (const auto& item : items) {
+        sorted.push_back(std::move(first[static_cast<std::ptrdiff_t>(item.index)]));
+    }
+    std::ranges::move(sorted, first);
+}
+
+inline constexpr std::size_t sort_radix_threshold = 256;
+
+}
+
+// Stable sort of a random access range of reflected records by the given fields, the first field is the most
+// significant one.
+template<string_literal_t... fields, std::ranges::random_access_range Range>
+    requires(sizeof...(fields) > 0 && std::ranges::sized_range<Range>)
+void sort_by(Range&& range)
+{
+    using value_type = std::ranges::range_value_t<Range>;
+    const auto first = std::ranges::begin(range);
+    const auto size = static_cast<std::size_t>(std::ranges::size(range));
+
+    if constexpr ((detail::sort_radix_key<detail::field_type_t<value_type, fields>> && ...)) {
+        if (size >= detail::sort_radix_threshold) {
+            if (size <= std::numeric_limits<std::uint32_t>::max()) {
+                detail::sort_radix<value_type, std::uint32_t, fields...>(first, size);
+            } else {
+                detail::sort_radix<value_type, std::size_t, fields...>(first, size);
+            }
+            return;
+        }
+    }
+    const auto less = [](const value_type& lhs, const value_type& rhs) {
+        return detail::sort_less<fields...>(lhs, rhs);
+    };
+    std::stable_sort(first, first + static_cast<std::ptrdiff_t>(size), less);
+}
+
+}
@@ -0,0 +1,467 @@
+#pragma once
+
+#include "reflect.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sqlite3.h>
+
+// SQLite tables of flat reflected records. The CREATE TABLE, INSERT and SELECT statements are generated from the
+// fields of the record, which become the columns of the table and map to
+//   bool, integers        -> INTEGER
+//   float, double         -> REAL
+//   std::string, enums    -> TEXT, enums by their names
+//   std::optional<V>      -> the column of V without NOT NULL, std::nullopt is NULL
+// Statements are prepared once per table and reused. Values are bound by column index, so no SQL is formatted per row.
+// The bulk insert wraps batches of rows into transactions, which saves a journal sync per row.
+
+namespace tsmp {
+
+class sqlite_statement
+{
+public:
+    sqlite_statement(sqlite3* connection, std::string_view sql)
+    {
+        if (sqlite3_prepare_v3(connection,
+                               sql.data(),
+                               static_cast<int>(sql.size()),
+                               SQLITE_PREPARE_PERSISTENT,
+                               &statement,
+                               nullptr) != SQLITE_OK) {
+            throw std::runtime_error(std::string("Could not prepare statement: ") + sqlite3_errmsg(connection));
+        }
+    }
+
+    sqlite_statement(sqlite_statement&& other) noexcept
+        : statement(std::exchange(other.statement, nullptr))
+    {}
+
+    sqlite_statement& operator=(sqlite_statement&& other) noexcept
+    {
+        std::swap(statement, other.statement);
+        return *this;
+    }
+
+    ~sqlite_statement() { sqlite3_finalize(statement); }
+
+    [[nodiscard]] sqlite3_stmt* handle() const noexcept { return statement; }
+
+    // Returns true if a row is available and false if the statement has finished.
+    bool step()
+    {
+        const auto result = sqlite3_step(statement);
+        if (result == SQLITE_ROW) {
+            return true;
+        }
+        if (result == SQLITE_DONE) {
+            return false;
+        }
+        const std::string message = sqlite3_errmsg(sqlite3_db_handle(statement));
+        sqlite3_reset(statement);
+        throw std::runtime_error("Could not execute statement: " + message);
+    }
+
+    void reset() noexcept { sqlite3_reset(statement); }
+
+private:
+    sqlite3_stmt* statement = nullptr;
+};
+
+class sqlite_database
+{
+public:
+    explicit sqlite_database(const std::string& path, int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)
+    {
+        if (sqlite3_open_v2(path.c_str(), &connection, flags, nullptr) != SQLITE_OK) {
+            const std::string message = connection ? sqlite3_errmsg(connection) : "out of memory";
+            sqlite3_close(connection);
+            throw std::runtime_error("Could not open database " + path + ": " + message);
+        }
+    }
+
+    sqlite_database(sqlite_database&& other) noexcept
+        : connection(std::exchange(other.connection, nullptr))
+    {}
+
+    sqlite_database& operator=(sqlite_database&& other) noexcept
+    {
+        std::swap(connection, other.connection);
+        return *this;
+    }
+
+    ~sqlite_database() { sqlite3_close(connection); }
+
+    [[nodiscard]] sqlite3* handle() const noexcept { return connection; }
+
+    void execute(const std::string& sql)
+    {
+        char* error = nullptr;
+        if (sqlite3_exec(connection, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+            const std::string message = error ? error : sqlite3_errmsg(connection);
+            sqlite3_free(error);
+            throw std::runtime_error("Could not execute " + sql + ": " + message);
+        }
+    }
+
+    [[nodiscard]] bool in_transaction() const noexcept { return sqlite3_get_autocommit(connection) == 0; }
+
+private:
+    sqlite3* connection = nullptr;
+};
+
+namespace detail {
+
+inline void sqlite_check_bind(sqlite3_stmt* statement, int result)
+{
+    if (result != SQLITE_OK) {
+        throw std::runtime_error(std::string("Could not bind value: ") + sqlite3_errmsg(sqlite3_db_handle(statement)));
+    }
+}
+
+template<class V>
+struct sqlite_column_t;
+
+template<std::integral V>
+struct sqlite_column_t<V>
+{
+    static constexpr std::string_view type = "INTEGER";
+
+    static void bind(sqlite3_stmt* statement, int index, V value)
+    {
+        if (!std::in_range<sqlite3_int64>(value)) {
+            throw std::out_of_range("Integer does not fit into a SQLite INTEGER.");
+        }
+        sqlite_check_bind(statement, sqlite3_bind_int64(statement, index, static_cast<sqlite3_int64>(value)));
+    }
+
+    [[nodiscard]] static V read(sqlite3_stmt* statement, int index)
+    {
+        const auto value = sqlite3_column_int64(statement, index);
+        if (!std::in_range<V>(value)) {
+            throw std::runtime_error("Integer in the database does not fit into the field.");
+        }
+        return static_cast<V>(value);
+    }
+};
+
+template<>
+struct sqlite_column_t<bool>
+{
+    static constexpr std::string_view type = "INTEGER";
+
+    static void bind(sqlite3_stmt* statement, int index, bool value)
+    {
+        sqlite_check_bind(statement, sqlite3_bind_int(statement, index, value ? 1 : 0));
+    }
+
+    [[nodiscard]] static bool read(sqlite3_stmt* statement, int index)
+    {
+        return sqlite3_column_int64(statement, index) != 0;
+    }
+};
+
+template<std::floating_point V>
+struct sqlite_column_t<V>
+{
+    static constexpr std::string_view type = "REAL";
+
+    static void bind(sqlite3_stmt* statement, int index, V value)
+    {
+        sqlite_check_bind(statement, sqlite3_bind_double(statement, index, static_cast<double>(value)));
+    }
+
+    [[nodiscard]] static V read(sqlite3_stmt* statement, int index)
+    {
+        return static_cast<V>(sqlite3_column_double(statement, index));
+    }
+};
+
+[[nodiscard]] inline std::string_view sqlite_read_text(sqlite3_stmt* statement, int index)
+{
+    const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(statement, index));
+    return text ? std::string_view(text, static_cast<std::size_t>(sqlite3_column_bytes(statement, index)))
+                : std::string_view();
+}
+
+// the text is bound as SQLITE_STATIC, it has to stay alive until the statement is reset
+template<>
+struct sqlite_column_t<std::string>
+{
+    static constexpr std::string_view type = "TEXT";
+
+    static void bind(sqlite3_stmt* statement, int index, const std::string& value)
+    {
+        sqlite_check_bind(
+            statement,
+            sqlite3_bind_text64(statement, index, value.data(), value.size(), SQLITE_STATIC, SQLITE_UTF8));
+    }
+
+    [[nodiscard]] static std::string read(sqlite3_stmt* statement, int index)
+    {
+        return std::string(sqlite_read_text(statement, index));
+    }
+};
+
+template<Enum V>
+struct sqlite_column_t<V>
+{
+    static constexpr std::string_view type = "TEXT";
+
+    static void bind(sqlite3_stmt* statement, int index, V value)
+    {
+        const auto name = enum_to_string(value);
+        sqlite_check_bind(statement,
+                          sqlite3_bind_text64(statement, index, name.data(), name.size(), SQLITE_STATIC, SQLITE_UTF8));
+    }
+
+    [[nodiscard]] static V read(sqlite3_stmt* statement, int index)
+    {
+        return enum_from_string<V>(sqlite_read_text(statement, index));
+    }
+};
+
+template<class V>
+struct sqlite_column_t<std::optional<V>>
+{
+    static constexpr std::string_view type = sqlite_column_t<V>::type;
+
+    static void bind(sqlite3_stmt* statement, int index, const std::optional<V>& value)
+    {
+        if (value) {
+            sqlite_column_t<V>::bind(statement, index, *value);
+        } else {
+            sqlite_check_bind(statement, sqlite3_bind_null(statement, index));
+        }
+    }
+
+    [[nodiscard]] static std::optional<V> read(sqlite3_stmt* statement, int index)
+    {
+        if (sqlite3_column_type(statement, index) == SQLITE_NULL) {
+            return std::nullopt;
+        }
+        return sqlite_column_t<V>::read(statement, index);
+    }
+};
+
+template<class T>
+using sqlite_fields_t = decltype(reflect<T>::fields());
+
+template<class T>
+inline constexpr std::size_t sqlite_field_count = std::tuple_size_v<sqlite_fields_t<T>>;
+
+template<class T, std::size_t id>
+using sqlite_field_t = typename std::tuple_element_t<id, sqlite_fields_t<T>>::value_type;
+
+[[nodiscard]] inline std::string sqlite_quote(std::string_view identifier)
+{
+    std::string result = "\"";
+    for (const auto c : identifier) {
+        result += c;
+        if (c == '"') {
+            result += '"';
+        }
+    }
+    return result + '"';
+}
+
+[[nodiscard]] inline std::string sqlite_join(const std::vector<std::string>& parts)
+{
+    std::string result;
+    for (const auto& part : parts) {
+        if (!result.empty()) {
+            result += ", ";
+        }
+        result += part;
+    }
+    return result;
+}
+
+template<class T>
+[[nodiscard]] std::vector<std::string> sqlite_columns(bool with_types)
+{
+    std::vector<std::string> columns;
+    [&]<std::size_t... id>(std::index_sequence<id...>) {
+        (
+            [&] {
+                using value_type = sqlite_field_t<T, id>;
+                auto column = sqlite_quote(std::get<id>(reflect<T>::fields()).name);
+                if (with_types) {
+                    column += ' ';
+                    column += sqlite_column_t<value_type>::type;
+                    if constexpr (!is_optional<value_type>) {
+                        column += " NOT NULL";
+                    }
+                }
+                columns.push_back(std::move(column));
+            }(),
+            ...);
+    }(std::make_index_sequence<sqlite_field_count<T>>{});
+    return columns;
+}
+
+}
+
+template<class T>
+[[nodiscard]] std::string sqlite_create_table_sql(std::string_view table)
+{
+    return "CREATE TABLE IF NOT EXISTS " + detail::sqlite_quote(table) + " (" +
+           detail::sqlite_join(detail::sqlite_columns<T>(true)) + ")";
+}
+
+template<class T>
+[[nodiscard]] std::string sqlite_insert_sql(std::string_view table)
+{
+    std::string parameters;
+    for (std::size_t i = 1; i <= detail::sqlite_field_count<T>; ++i) {
+        parameters += (i == 1 ? "?" : ", ?") + std::to_string(i);
+    }
+    return "INSERT INTO " + detail::sqlite_quote(table) + " (" + detail::sqlite_join(detail::sqlite_columns<T>(false)) +
+           ") VALUES (" + parameters + ")";
+}
+
+template<class T>
+[[nodiscard]] std::string sqlite_select_sql(std::string_view table)
+{
+    return "SELECT " + detail::sqlite_join(detail::sqlite_columns<T>(false)) + " FROM " + detail::sqlite_quote(table);
+}
+
+// Binds the fields of the record to the parameters ?1 to ?N of the statement.
+template<class T>
+void sqlite_bind(sqlite3_stmt* statement, const T& record)
+{
+    [&]<std::size_t... id>(std::index_sequence<id...>) {
+        (detail::sqlite_column_t<detail::sqlite_field_t<T, id>>::bind(
+             statement, static_cast<int>(id + 1), record.*std::get<id>(reflect<T>::fields()).ptr),
+         ...);
+    }(std::make_index_sequence<detail::sqlite_field_count<T>>{});
+}
+
+// Reads the record from the columns 0 to N-1 of the current row.
+template<class T>
+[[nodiscard]] T sqlite_read(sqlite3_stmt* statement)
+{
+    T record{};
+    [&]<std::size_t... id>(std::index_sequence<id...>) {
+        ((record.*std::get<id>(reflect<T>::fields()).ptr =
+              detail::sqlite_column_t<detail::sqlite_field_t<T, id>>::read(statement, static_cast<int>(id))),
+         ...);
+    }(std::make_index_sequence<detail::sqlite_field_count<T>>{});
+    return record;
+}
+
+inline constexpr std::size_t sqlite_batch_size = 1 << 14;
+
+template<class T>
+class sqlite_table
+{
+public:
+    sqlite_table(sqlite_database& database, std::string name)
+        : database(&database)
+        , name(std::move(name))
+    {}
+
+    [[nodiscard]] const std::string& table_name() const noexcept { return name; }
+
+    void create() { database->execute(sqlite_create_table_sql<T>(name)); }
+
+    void insert(const T& record)
+    {
+        auto& statement = prepared(insert_statement, sqlite_insert_sql<T>);
+        sqlite_bind(statement.handle(), record);
+        step_and_reset(statement);
+    }
+
+    // Inserts all records with one transaction per batch_size rows. If the database is already in a transaction, the
+    // rows become part of it instead.
+    template<std::ranges::input_range Range>
+        requires std::same_as<std::ranges::range_value_t<Range>, T>
+    void insert(const Range& records, std::size_t batch_size = sqlite_batch_size)
+    {
+        auto& statement = prepared(insert_statement, sqlite_insert_sql<T>);
+        if (database->in_transaction()) {
+            for (const auto& record : records) {
+                sqlite_bind(statement.handle(), record);
+                step_and_reset(statement);
+            }
+            return;
+        }
+        std::size_t pending = 0;
+        database->execute("BEGIN");
+        try {
+            for (const auto& record : records) {
+                sqlite_bind(statement.handle(), record);
+                step_and_reset(statement);
+                if (++pending == batch_size) {
+                    database->execute("COMMIT");
+                    database->execute("BEGIN");
+                    pending = 0;
+                }
+            }
+            database->execute("COMMIT");
+        } catch (...) {
+            if (database->in_transaction()) {
+                database->execute("ROLLBACK");
+            }
+            throw;
+        }
+    }
+
+    // Calls function with every record of the table.
+    template<class Function>
+    void for_each(Function&& function)
+    {
+        auto& statement = prepared(select_statement, sqlite_select_sql<T>);
+        try {
+            while (statement.step()) {
+                function(sqlite_read<T>(statement.handle()));
+            }
+        } catch (...) {
+            statement.reset();
+            throw;
+        }
+        statement.reset();
+    }
+
+    [[nodiscard]] std::vector<T> select()
+    {
+        std::vector<T> result;
+        for_each([&](T record) { result.push_back(std::move(record)); });
+        return result;
+    }
+
+private:
+    // statements are prepared on first use, because the table may not exist before
+    sqlite_statement& prepared(std::optional<sqlite_statement>& statement, std::string (*sql)(std::string_view))
+    {
+        if (!statement) {
+            statement.emplace(database->handle(), sql(name));
+        }
+        return *statement;
+    }
+
+    // step resets the statement itself if it fails
+    static void step_and_reset(sqlite_statement& statement)
+    {
+        statement.step();
+        statement.reset();
+    }
+
+    sqlite_database* database;
+    std::string name;
+    std::optional<sqlite_statement> insert_statement;
+    std::optional<sqlite_statement> select_statement;
+};
+
+}
@@ -0,0 +1,502 @@
+#pragma once
+
+#include "error_handler.hpp"
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+// Format independent encoder and decoder for self describing binary formats like MessagePack and CBOR. The mapping
+// follows the json module: records are maps keyed by field name, enums are encoded by name, ranges are arrays and
+// empty optionals are nil. The formats only need to provide a writer and a reader with the following interface:
+//
+//   writer: write_nil(), write_bool(bool), write_unsigned(uint64), write_signed(int64), write_float(float),
+//           write_double(double), write_string(string_view), write_array_header(size), write_map_header(size)
+//
+//   reader: peek(), read_nil(), read_bool(bool&), read_integer(tagged_integer_t&), read_float(double&),
+//           read_string(string_view&), read_array_header(tagged_container_t&), read_map_header(tagged_container_t&),
+//           read_break(), skip(), remaining() and the last error message in the member error
+
+namespace tsmp::detail {
+
+enum class tagged_kind_t
+{
+    nil,
+    boolean,
+    integer,
+    floating,
+    string,
+    binary,
+    array,
+    map,
+    other
+};
+
+struct tagged_integer_t
+{
+    // negative values are stored as -1 - value, which covers the full negative range of CBOR
+    bool negative;
+    std::uint64_t value;
+};
+
+struct tagged_container_t
+{
+    std::size_t size;
+    bool indefinite;
+};
+
+template<std::unsigned_integral T>
+void write_big_endian(std::vector<std::byte>& buffer, T value)
+{
+    for (std::size_t i = sizeof(T); i-- > 0;) {
+        buffer.push_back(static_cast<std::byte>(value >> (8 * i)));
+    }
+}
+
+// Shared input handling of the readers. Readers are copied to try to decode a value without consuming the input.
+struct tagged_cursor_t
+{
+    std::span<const std::byte> buffer;
+    std::size_t position = 0;
+    const char* error = "";
+
+    [[nodiscard]] std::size_t remaining() const noexcept { return buffer.size() - position; }
+
+    [[nodiscard]] bool fail(const char* message) noexcept
+    {
+        error = message;
+        return false;
+    }
+
+    [[nodiscard]] bool peek_byte(std::uint8_t& byte) noexcept
+    {
+        if (remaining() == 0) {
+            return fail("Unexpected end of input.");
+        }
+        byte = std::to_integer<std::uint8_t>(buffer[position]);
+        return true;
+    }
+
+    [[nodiscard]] bool read_byte(std::uint8_t& byte) noexcept
+    {
+        if (!peek_byte(byte)) {
+            return false;
+        }
+        ++position;
+        return true;
+    }
+
+    template<std::unsigned_integral T>
+    [[nodiscard]] bool read_big_endian(T& value) noexcept
+    {
+        if (remaining() < sizeof(T)) {
+            return fail("Unexpected end of input.");
+        }
+        value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value = static_cast<T>((value << 8) | std::to_integer<T>(buffer[position++]));
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool read_view(std::uint64_t size, std::string_view& view) noexcept
+    {
+        if (remaining() < size) {
+            return fail("Unexpected end of input.");
+        }
+        view = std::string_view(reinterpret_cast<const char*>(buffer.data() + position), size);
+        position += size;
+        return true;
+    }
+
+    [[nodiscard]] bool skip_bytes(std::uint64_t size) noexcept
+    {
+        if (remaining() < size) {
+            return fail("Unexpected end of input.");
+        }
+        position += size;
+        return true;
+    }
+};
+
+template<class T>
+struct tagged_codec_t;
+
+// decoding fills a value in place, string literals have no default state to start from
+template<class T>
+[[nodiscard]] T tagged_initial_value()
+{
+    if constexpr (std::is_default_constructible_v<T>) {
+        return T{};
+    } else {
+        return T("");
+    }
+}
+
+template<Arithmetic T>
+struct tagged_codec_t<T>
+{
+    template<class Writer>
+    static void encode(Writer& writer, const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            writer.write_bool(value);
+        } else if constexpr (std::is_same_v<T, float>) {
+            writer.write_float(value);
+        } else if constexpr (std::floating_point<T>) {
+            writer.write_double(static_cast<double>(value));
+        } else if constexpr (std::is_signed_v<T>) {
+            writer.write_signed(value);
+        } else {
+            writer.write_unsigned(value);
+        }
+    }
+
+    template<class Reader>
+    [[nodiscard]] static bool decode(Reader& reader, T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            return reader.read_bool(value);
+        } else if constexpr (std::floating_point<T>) {
+            if (reader.peek() == tagged_kind_t::integer) {
+                tagged_integer_t integer;
+                if (!reader.read_integer(integer)) {
+                    return false;
+                }
+                value = integer.negative ? -1 - static_cast<T>(integer.value) : static_cast<T>(integer.value);
+                return true;
+            }
+            double number;
+            if (!reader.read_float(number)) {
+                return false;
+            }
+            value = static_cast<T>(number);
+            return true;
+        } else {
+            tagged_integer_t integer;
+            if (!reader.read_integer(integer)) {
+                return false;
+            }
+            constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+            if (integer.value > max || (integer.negative && std::is_unsigned_v<T>)) {
+                reader.error = "Integer out of range.";
+                return false;
+            }
+            value = integer.negative ? static_cast<T>(-1 - static_cast<std::int64_t>(integer.value))
+                                     : static_cast<T>(integer.value);
+            return true;
+        }
+    }
+};
+
+template<Enum T>
+struct tagged_codec_t<T>
+{
+    template<class Writer>
+    static void encode(Writer& writer, const T& value)
+    {
+        writer.write_string(enum_to_string(value));
+    }
+
+    template<class Reader>
+    [[nodiscard]] static bool decode(Reader& reader, T& value)
+    {
+        std::string_view name;
+        if (!reader.read_string(name)) {
+            return false;
+        }
+        const auto it = std::ranges::find(enum_names<T>, name);
+        if (it == enum_names<T>.end()) {
+            reader.error = "String not in enumeration.";
+            return false;
+        }
+        value = enum_values<T>[static_cast<std::size_t>(it - enum_names<T>.begin())];
+        return true;
+    }
+};
+
+template<>
+struct tagged_codec_t<std::string>
+{
+    template<class Writer>
+    static void encode(Writer& writer, const std::string& value)
+    {
+        writer.write_string(value);
+    }
+
+    template<class Reader>
+    [[nodiscard]] static bool decode(Reader& reader, std::string& value)
+    {
+        std::string_view view;
+        if (!reader.read_string(view)) {
+            return false;
+        }
+        value.assign(view);
+        return true;
+    }
+};
+
+template<std::size_t N>
+struct tagged_codec_t<string_literal_t<N>>
+{
+    template<class Writer>
+    static void encode(Writer& writer, const string_literal_t<N>& value)
+    {
+        writer.write_string(std::string_view(value));
+    }
+
+    template<class Reader>
+    [[nodiscard]] static bool decode(Reader& reader, string_literal_t<N>& value)
+    {
+        std::string_view view;
+        if (!reader.read_string(view)) {
+            return false;
+        }
+        if (view.size() > N) {
+            reader.error = "String is bigger than the requested size.";
+            return false;
+        }
+        std::ranges::fill(std::ranges::copy(view, value.begin()).out, value.end(), '\0');
+        return true;
+    }
+};
+
+template<class T>
+struct tagged_codec_t<std::optional<T>>
+{
+    template<class Writer>
+    static void encode(Writer& writer, const std::optional<T>& value)
+    {
+        if (value) {
+            tagged_codec_t<T>::encode(writer, *value);
+        } else {
+            writer.write_nil();
+        }
+    }
+
+    template<class Reader>
+    [[nodiscard]] static bool decode(Reader& reader, std::optional<T>& value)
+    {
+        if (reader.read_nil()) {
+            value.reset();
+            return true;
+        }
+        return tagged_codec_t<T>::decode(reader, value.emplace());
+    }
+};
+
+template<class... Ts>
+struct tagged_codec_t<std::variant<Ts...>>
+{
+    template<class Writer>
+    static void encode(Writer& writer, const std::variant<Ts...>& value)
+    {
+        std::visit(
+            [&writer](const auto& alternative) {
+                tagged_codec_t<std::remove_cvref_t<decltype(alternative)>>::encode(writer, alternative);
+            },
+            value);
+    }
+
+    template<class T, class Reader>
+    [[nodiscard]] static bool try_decode(Reader& reader, std::variant<Ts...>& value)
+    {
+        static_assert(std::is_default_constructible_v<T>,
+                      "Alternatives of a decoded variant must be default constructible.");
+        // the reader is a cheap cursor, failed attempts are rolled back by discarding the copy
+        auto attempt = reader;
+        T alternative{};
+        if (!tagged_codec_t<T>::decode(attempt, alternative)) {
+            return false;
+        }
+        reader = attempt;
+        value = std::move(alternative);
+        return true;
+    }
+
+    template<class Reader>
+    [[nodiscard]] static bool decode(Reader& reader, std::variant<Ts...>& value)
+    {
+        // Like JSON, the formats do not store the active alternative. The first compatible alternative is choosen.
+        if ((try_decode<Ts>(reader, value) || ...)) {
+            return true;
+        }
+        reader.error = "Could not match any alternative of the variant.";
+        return false;
+    }
+};
+
+template<std::ranges::input_range Range>
+struct tagged_codec_t<Range>
+{
+    using value_type = std::ranges::range_value_t<Range>;
+
+    template<class Writer>
+    static void encode(Writer& writer, const Range& range)
+    {
+        writer.write_array_header(static_cast<std::size_t>(std::ranges::distance(range)));
+        for (const auto& element : range) {
+            tagged_codec_t<value_type>::encode(writer, element);
+        }
+    }
+
+    template<class Reader>
+    [[nodiscard]] static bool decode(Reader& reader, Range& range)
+    {
+        tagged_container_t header;
+        if (!reader.read_array_header(header)) {
+            return false;
+        }
+        std::vector<value_type> buffer;
+        if (!header.indefinite) {
+            buffer.reserve(std::min(header.size, reader.remaining()));
+        }
+        for (std::size_t i = 0; header.indefinite ? !reader.read_break() : i < header.size; ++i) {
+            auto element = tagged_initial_value<value_type>();
+            if (!tagged_codec_t<value_type>::decode(reader, element)) {
+                return false;
+            }
+            buffer.push_back(std::move(element));
+        }
+        if constexpr (std::is_same_v<Range, std::vector<value_type>>) {
+            range = std::move(buffer);
+        } else if constexpr (requires { std::tuple_size<Range>::value; }) {
+            if (buffer.size() != std::tuple_size_v<Range>) {
+                reader.error = "Array size does not match.";
+                return false;
+            }
+            std::ranges::move(buffer, std::ranges::begin(range));
+        } else {
+            range = Range{std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end())};
+        }
+        return true;
+    }
+};
+
+template<class T>
+struct tagged_codec_t
+{
+    static constexpr std::size_t field_count = std::tuple_size_v<decltype(reflect<T>::fields())>;
+
+    template<class Writer>
+    static void encode(Writer& writer, const T& value)
+    {
+        writer.write_map_header(field_count);
+        std::apply(
+            [&](auto... decls) {
+                ((writer.write_string(decls.name),
+                  tagged_codec_t<typename decltype(decls)::value_type>::encode(writer, value.*(decls.ptr))),
+                 ...);
+            },
+            reflect<T>::fields());
+    }
+
+    template<class Reader>
+    [[nodiscard]] static bool decode_field(Reader& reader, T& value, std::string_view key, std::size_t& id)
+    {
+        return std::apply(
+            [&](auto... decls) {
+                bool success = true;
+                const bool found = ((decls.name == key
+                                         ? (id = decls.id,
+                                            success = tagged_codec_t<typename decltype(decls)::value_type>::decode(
+                                                reader, value.*(decls.ptr)),
+                                            true)
+                                         : false) ||
+                                    ...);
+                if (!found) {
+                    id = field_count;
+                    success = reader.skip();
+                }
+                return success;
+            },
+            reflect<T>::fields());
+    }
+
+    template<class Reader>
+    [[nodiscard]] static bool decode(Reader& reader, T& value)
+    {
+        tagged_container_t header;
+        if (!reader.read_map_header(header)) {
+            return false;
+        }
+        std::array<bool, field_count + 1> initialised{};
+        for (std::size_t i = 0; header.indefinite ? !reader.read_break() : i < header.size; ++i) {
+            std::string_view key;
+            std::size_t id;
+            if (!reader.read_string(key) || !decode_field(reader, value, key, id)) {
+                return false;
+            }
+            initialised[id] = true;
+        }
+        const bool complete = std::apply(
+            [&](auto... decls) {
+                return ((initialised[decls.id] || is_optional<typename decltype(decls)::value_type>) && ... && true);
+            },
+            reflect<T>::fields());
+        if (!complete) {
+            reader.error = "Required field is missing.";
+        }
+        return complete;
+    }
+};
+
+template<class T, class Reader, template<class> class ErrorHandler>
+struct from_tagged_t
+{
+    using value_type = typename ErrorHandler<T>::value_type;
+
+    [[nodiscard]] value_type operator()(std::span<const std::byte> buffer)
+    {
+        Reader reader{{buffer}};
+        auto result = tagged_initial_value<T>();
+        if (!tagged_codec_t<T>::decode(reader, result)) {
+            return ErrorHandler<T>{}(reader.error);
+        }
+        if (reader.remaining() != 0) {
+            return ErrorHandler<T>{}("Trailing bytes after input.");
+        }
+        return result;
+    }
+};
+
+template<class T, class Reader, class... Validator>
+[[nodiscard]] T from_tagged(std::span<const std::byte> buffer, Validator&&... validator)
+{
+    const auto result = from_tagged_t<T, Reader, throw_handler_t>{}(buffer);
+    if ((true && ... && validator(result))) {
+        return result;
+    } else {
+        throw std::runtime_error("Validator was not satisfied.");
+    }
+}
+
+template<class T, class Reader, class... Validator>
+[[nodiscard]] std::optional<T> try_from_tagged(std::span<const std::byte> buffer, Validator&&... validator) noexcept
+{
+    // decoding allocates and the validators may throw, both end up as nullopt
+    try {
+        const auto result = from_tagged_t<T, Reader, nullopt_handler_t>{}(buffer);
+        if (result && (true && ... && validator(*result))) {
+            return result;
+        }
+    } catch (...) {
+    }
+    return std::nullopt;
+}
+
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "binary.hpp"
+#include "introspect.hpp"
+#include "reflect.hpp"
+#include "string_literal.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Wrapper of a reflected record that knows which of its fields were written. Every mutable access to a field sets
+// its dirty bit, reading goes through const access. The serializers keep the encoding of every field and only encode
+// the fields written since they last ran, so re-serializing after a small change costs as much as encoding the
+// changed fields and copying the cached bytes. References returned by mutable access must not be written to after
+// the next serialization. Serializing updates the cache, so it is not thread safe even through const references.
+
+namespace tsmp {
+
+template<class T>
+class tracked
+{
+public:
+    static constexpr std::size_t field_count = std::tuple_size_v<decltype(reflect<T>::fields())>;
+    using value_type = T;
+    using mask_type = std::bitset<field_count>;
+
+    tracked() = default;
+
+    explicit tracked(T value)
+        : internal(std::move(value))
+    {
+        dirty_fields.set();
+    }
+
+    [[nodiscard]] const T& value() const noexcept { return internal; }
+    [[nodiscard]] const T& operator*() const noexcept { return internal; }
+    [[nodiscard]] const T* operator->() const noexcept { return &internal; }
+
+    template<string_literal_t field>
+    [[nodiscard]] const auto& get() const noexcept
+    {
+        return introspect<const T>{internal}.template get<field>();
+    }
+
+    // Mutable access to the field, which marks it as dirty.
+    template<string_literal_t field>
+    [[nodiscard]] auto& get() noexcept
+    {
+        constexpr auto id = introspect<T>::field_id(field);
+        touch(id);
+        return introspect<T>{internal}.template get<field>();
+    }
+
+    template<string_literal_t field, class V>
+    void set(V&& value)
+    {
+        get<field>() = std::forward<V>(value);
+    }
+
+    // Calls function with a mutable reference to the whole record and marks all fields as dirty.
+    template<class Function>
+    void update(Function&& function)
+    {
+        function(internal);
+        dirty_fields.set();
+        stale_all();
+    }
+
+    // Fields written since construction or the last call to clear_dirty.
+    [[nodiscard]] const mask_type& dirty() const noexcept { return dirty_fields; }
+
+    template<string_literal_t field>
+    [[nodiscard]] bool is_dirty() const noexcept
+    {
+        constexpr auto id = introspect<T>::field_id(field);
+        return dirty_fields.test(id);
+    }
+
+    void clear_dirty() noexcept { dirty_fields.reset(); }
+
+    // Cached encodings of the fields. encode(id, name, field) is called for the fields written since the last call
+    // with the same Encoding type and must return the encoding of the field.
+    template<class Encoding, class Encode>
+    [[nodiscard]] const std::array<Encoding, field_count>& encoded(Encode&& encode) const
+    {
+        auto& cache = std::get<cache_t<Encoding>>(caches);
+        if (cache.stale.any()) {
+            std::apply(
+                [&](const auto&... decls) {
+                    (
+                        [&] {
+                            if (cache.stale.test(decls.id)) {
+                                cache.fields[decls.id] = encode(decls.id, decls.name, internal.*decls.ptr);
+                            }
+                        }(),
+                        ...);
+                },
+                reflect<T>::fields());
+            cache.stale.reset();
+        }
+        return cache.fields;
+    }
+
+private:
+    template<class Encoding>
+    struct cache_t
+    {
+        std::array<Encoding, field_count> fields{};
+        mask_type stale = mask_type().set();
+    };
+
+    void touch(std::size_t id) noexcept
+    {
+        dirty_fields.set(id);
+        std::apply([id](auto&... cache) { (cache.stale.set(id), ...); }, caches);
+    }
+
+    void stale_all() noexcept
+    {
+        std::apply([](auto&... cache) { (cache.stale.set(), ...); }, caches);
+    }
+
+    T internal{};
+    mask_type dirty_fields;
+    mutable std::tuple<cache_t<std::string>, cache_t<std::vector<std::byte>>> caches;
+};
+
+// Binary encoding of the record as to_binary would produce it, fields that were not written are copied from the cache.
+// Records that to_binary copies byte by byte are encoded as a whole, which is not more expensive than the copy.
+template<class T>
+void to_binary(const tracked<T>& value, std::vector<std::byte>& buffer)
+{
+    if constexpr (detail::binary_codec_t<T>::bitwise) {
+        detail::binary_writer_t writer{buffer};
+        detail::binary_codec_t<T>::encode(writer, value.value());
+    } else {
+        const auto encode = [](std::size_t, std::string_view, const auto& field) {
+            std::vector<std::byte> result;
+            detail::binary_writer_t writer{result};
+            detail::binary_codec_t<std::remove_cvref_t<decltype(field)>>::encode(writer, field);
+            return result;
+        };
+        for (const auto& field : value.template encoded<std::vector<std::byte>>(encode)) {
+            buffer.insert(buffer.end(), field.begin(), field.end());
+        }
+    }
+}
+
+template<class T>
+[[nodiscard]] std::vector<std::byte> to_binary(const tracked<T>& value)
+{
+    std::vector<std::byte> buffer;
+    to_binary(value, buffer);
+    return buffer;
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "json.hpp"
+#include "tracked.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+namespace tsmp {
+
+// JSON encoding of the record as to_json would produce it, fields that were not written are copied from the cache.
+template<class T>
+[[nodiscard]] std::string to_json(const tracked<T>& value)
+{
+    const auto& fields = value.template encoded<std::string>([](std::size_t, std::string_view name, const auto& field) {
+        return fmt::format("\"{}\":{}", name, to_json(field));
+    });
+    return fmt::format("{{{}}}", fmt::join(fields, ","));
+}
+
+}
@@ -0,0 +1,125 @@
+#include "tsmp/arith.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+struct float4_t
+{
+    float x;
+    float y;
+    float z;
+    float w;
+};
+
+struct segment_t
+{
+    float4_t from;
+    float4_t to;
+};
+
+struct sample_t
+{
+    double value;
+    std::int32_t count;
+    float weight;
+};
+
+bool operator==(const float4_t& lhs, const float4_t& rhs)
+{
+    return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z && lhs.w == rhs.w;
+}
+
+bool operator==(const sample_t& lhs, const sample_t& rhs)
+{
+    return lhs.value == rhs.value && lhs.count == rhs.count && lhs.weight == rhs.weight;
+}
+
+TEST_CASE("arith layout test", "[core][unit]")
+{
+    STATIC_REQUIRE(tsmp::detail::arith_flat<float4_t>);
+    STATIC_REQUIRE(tsmp::detail::arith_flat<segment_t>);
+    STATIC_REQUIRE(tsmp::detail::arith_leaves<segment_t>::count == 8);
+    STATIC_REQUIRE(!tsmp::detail::arith_flat<sample_t>);
+}
+
+TEST_CASE("arith value test", "[core][unit]")
+{
+    const float4_t a{1, 2, 3, 4};
+    const float4_t b{10, 20, 30, 40};
+    REQUIRE(tsmp::arith::add(a, b) == float4_t{11, 22, 33, 44});
+    REQUIRE(tsmp::arith::sub(b, a) == float4_t{9, 18, 27, 36});
+    REQUIRE(tsmp::arith::scale(a, 2) == float4_t{2, 4, 6, 8});
+    REQUIRE(tsmp::arith::fma(a, b, 0.5) == float4_t{6, 12, 18, 24});
+    REQUIRE(tsmp::arith::lerp(a, b, 0.0) == a);
+    REQUIRE(tsmp::arith::lerp(a, b, 1.0) == b);
+
+    const segment_t segment{a, b};
+    const auto doubled = tsmp::arith::add(segment, segment);
+    REQUIRE(doubled.from == float4_t{2, 4, 6, 8});
+    REQUIRE(doubled.to == float4_t{20, 40, 60, 80});
+
+    const sample_t sample{1.5, 3, 0.25f};
+    REQUIRE(tsmp::arith::add(sample, sample) == sample_t{3.0, 6, 0.5f});
+    REQUIRE(tsmp::arith::scale(sample, 0.5) == sample_t{0.75, 1, 0.125f});
+}
+
+TEST_CASE("arith constexpr test", "[core][unit]")
+{
+    constexpr auto sum = tsmp::arith::add(float4_t{1, 2, 3, 4}, float4_t{1, 1, 1, 1});
+    STATIC_REQUIRE(sum.x == 2 && sum.w == 5);
+}
+
+TEST_CASE("arith flat span test", "[core][unit]")
+{
+    std::vector<float4_t> targets;
+    std::vector<float4_t> sources;
+    for (int i = 0; i < 37; ++i) {
+        const auto f = static_cast<float>(i);
+        targets.push_back({f, f + 1, f + 2, f + 3});
+        sources.push_back({1, 2, 3, 4});
+    }
+    auto expected = targets;
+
+    tsmp::arith::add(std::span(targets), std::span<const float4_t>(sources));
+    for (auto& value : expected) {
+        value = tsmp::arith::add(value, sources.front());
+    }
+    REQUIRE(targets == expected);
+
+    tsmp::arith::sub(std::span(targets), std::span<const float4_t>(sources));
+    tsmp::arith::fma(std::span(targets), std::span<const float4_t>(sources), 2.0f);
+    tsmp::arith::scale(std::span(targets), 0.5f);
+    for (auto& value : expected) {
+        value = tsmp::arith::scale(tsmp::arith::fma(tsmp::arith::sub(value, sources.front()), sources.front(), 2.0f),
+                                   0.5f);
+    }
+    REQUIRE(targets == expected);
+
+    const auto sum = tsmp::arith::accumulate(std::span<const float4_t>(sources));
+    REQUIRE(sum == float4_t{37, 74, 111, 148});
+    REQUIRE(tsmp::arith::accumulate(std::span<const float4_t>()) == float4_t{0, 0, 0, 0});
+}
+
+TEST_CASE("arith mixed span test", "[core][unit]")
+{
+    std::vector<sample_t> targets(5, sample_t{1.0, 2, 0.5f});
+    const std::vector<sample_t> sources(5, sample_t{0.5, 1, 0.25f});
+
+    tsmp::arith::fma(std::span(targets), std::span(sources), 2);
+    REQUIRE(targets == std::vector<sample_t>(5, sample_t{2.0, 4, 1.0f}));
+
+    tsmp::arith::scale(std::span(targets), 0.5);
+    REQUIRE(targets == std::vector<sample_t>(5, sample_t{1.0, 2, 0.5f}));
+
+    REQUIRE(tsmp::arith::accumulate(std::span(sources)) == sample_t{2.5, 5, 1.25f});
+}
+
+TEST_CASE("arith span size test", "[core][unit]")
+{
+    std::vector<float4_t> targets(3);
+    const std::vector<float4_t> sources(2);
+    REQUIRE_THROWS_AS(tsmp::arith::add(std::span(targets), std::span(sources)), std::out_of_range);
+}
@@ -0,0 +1,113 @@
+#include "tsmp/arrow.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class level_t
+{
+    debug,
+    info,
+    error = 40
+};
+
+enum class region_t : std::uint8_t
+{
+    eu,
+    us
+};
+
+struct origin_t
+{
+    std::string host;
+    std::uint16_t port;
+    auto operator<=>(const origin_t&) const noexcept = default;
+};
+
+struct event_t
+{
+    std::int64_t timestamp;
+    double latency;
+    float score;
+    bool success;
+    std::uint8_t retries;
+    std::string message;
+    level_t level;
+    std::optional<std::int32_t> code;
+    std::optional<std::string> user;
+    std::optional<region_t> region;
+    origin_t origin;
+    std::optional<origin_t> proxy;
+    auto operator<=>(const event_t&) const noexcept = default;
+};
+
+struct other_t
+{
+    std::int64_t timestamp;
+};
+
+TEST_CASE("arrow roundtrip test", "[core][unit]")
+{
+    std::vector<event_t> events;
+    events.push_back({-5, 0.0, 0.0f, false, 0, "", level_t::info, 0, "user0", region_t::eu, {"host0", 8000}, {}});
+    events.push_back({1700000000001, 0.125, -1.0f, true, 1, "event", level_t::error, {}, {}, {}, {"host1", 81}, {}});
+    events.push_back({2, 0.25, -2.0f, true, 2, "", level_t::debug, -2, {}, region_t::us, {"", 80}, {{"proxy", 3}}});
+    events.push_back({3, 0.375, -3.0f, false, 3, "", level_t::error, {}, "user3", region_t::us, {"host0", 8003}, {}});
+    events.push_back({4, 0.5, -4.0f, true, 0, "event 4", level_t::info, -4, {}, region_t::eu, {"host1", 8004}, {}});
+    const auto buffer = tsmp::to_arrow(events);
+    REQUIRE(tsmp::from_arrow<event_t>(buffer) == events);
+
+    // several record batches share the dictionaries
+    const std::deque<event_t> queue(events.begin(), events.end());
+    const auto batched = tsmp::to_arrow(queue, 2);
+    REQUIRE(tsmp::from_arrow<event_t>(batched) == std::vector<event_t>(queue.begin(), queue.end()));
+
+    const auto empty = tsmp::to_arrow(std::vector<event_t>{});
+    REQUIRE(tsmp::from_arrow<event_t>(empty).empty());
+}
+
+TEST_CASE("arrow layout test", "[core][unit]")
+{
+    const std::vector<other_t> records{{1}, {-2}, {3}};
+    const auto buffer = tsmp::to_arrow(records);
+    const auto text = [&](std::size_t offset, std::size_t size) {
+        return std::string(reinterpret_cast<const char*>(buffer.data() + offset), size);
+    };
+    REQUIRE(text(0, 8) == std::string("ARROW1\0\0", 8));
+    REQUIRE(text(buffer.size() - 6, 6) == "ARROW1");
+
+    // the first message is the schema, prefixed by the continuation marker
+    REQUIRE(std::to_integer<int>(buffer[8]) == 0xff);
+    REQUIRE(std::to_integer<int>(buffer[11]) == 0xff);
+
+    // the int64 column is stored as a plain little endian array in the body of the record batch
+    const std::array<std::int64_t, 3> column{1, -2, 3};
+    const auto column_bytes = std::as_bytes(std::span(column));
+    REQUIRE(std::search(buffer.begin(), buffer.end(), column_bytes.begin(), column_bytes.end()) != buffer.end());
+    const auto decoded = tsmp::from_arrow<other_t>(buffer);
+    REQUIRE(decoded.size() == 3);
+    REQUIRE(decoded[1].timestamp == -2);
+}
+
+TEST_CASE("arrow validation test", "[core][unit]")
+{
+    std::vector<event_t> events;
+    events.push_back({1, 0.5, 1.0f, true, 0, "ok", level_t::info, 1, {}, region_t::eu, {"host", 80}, {}});
+    events.push_back({2, 1.5, 2.0f, false, 3, "retry", level_t::error, {}, "user", {}, {"host", 81}, {{"proxy", 3}}});
+    const auto buffer = tsmp::to_arrow(events);
+    REQUIRE_THROWS_AS(tsmp::from_arrow<other_t>(buffer), std::runtime_error);
+    REQUIRE(!tsmp::try_from_arrow<other_t>(buffer).has_value());
+    REQUIRE(!tsmp::try_from_arrow<event_t>(std::span(buffer).first(buffer.size() - 1)).has_value());
+    REQUIRE(!tsmp::try_from_arrow<event_t>(buffer, [](const event_t& event) { return event.retries < 3; }));
+    REQUIRE(tsmp::try_from_arrow<event_t>(buffer, [](const event_t& event) { return event.latency >= 0.0; }));
+
+    // corrupted files are rejected with an exception instead of undefined behaviour
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+        auto corrupted = buffer;
+        corrupted[i] ^= std::byte{0x5a};
+        (void)tsmp::try_from_arrow<event_t>(corrupted);
+    }
+}
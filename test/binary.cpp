@@ -0,0 +1,166 @@
+#include "tsmp/binary.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+template<class T>
+T roundtrip(const T& value)
+{
+    return tsmp::from_binary<T>(tsmp::to_binary(value));
+}
+
+TEST_CASE("arithmetic binary test", "[core][unit]")
+{
+    REQUIRE(roundtrip(static_cast<std::int32_t>(-42)) == -42);
+    REQUIRE(roundtrip(static_cast<std::uint64_t>(0xdeadbeefcafe)) == 0xdeadbeefcafe);
+    REQUIRE(roundtrip(static_cast<std::int8_t>(-1)) == -1);
+    REQUIRE(roundtrip(std::numeric_limits<std::int64_t>::min()) == std::numeric_limits<std::int64_t>::min());
+    REQUIRE(roundtrip(1337.5f) == 1337.5f);
+    REQUIRE(roundtrip(-0.25) == -0.25);
+    REQUIRE(roundtrip(true) == true);
+    REQUIRE(roundtrip(false) == false);
+
+    // varint and zigzag encoding keep small numbers small
+    REQUIRE(tsmp::to_binary(std::uint32_t{1}).size() == 1);
+    REQUIRE(tsmp::to_binary(std::uint32_t{300}).size() == 2);
+    REQUIRE(tsmp::to_binary(std::int64_t{-1}).size() == 1);
+    REQUIRE(tsmp::to_binary(std::int64_t{-64}).size() == 1);
+    REQUIRE(tsmp::to_binary(std::int64_t{64}).size() == 2);
+
+    REQUIRE_THROWS(tsmp::from_binary<std::uint8_t>(tsmp::to_binary(std::uint32_t{300})));
+    REQUIRE_THROWS(tsmp::from_binary<std::int16_t>(tsmp::to_binary(std::int32_t{70000})));
+    REQUIRE_THROWS(tsmp::from_binary<std::uint32_t>(std::vector<std::byte>{}));
+    REQUIRE_THROWS(tsmp::from_binary<bool>(std::vector<std::byte>{std::byte{2}}));
+    REQUIRE(tsmp::try_from_binary<std::uint32_t>(std::vector<std::byte>{std::byte{0x80}}) == std::nullopt);
+}
+
+enum class color_t
+{
+    red,
+    green,
+    blue
+};
+
+enum class sparse_t : std::int32_t
+{
+    low = -100,
+    mid = 7,
+    high = 100000
+};
+
+TEST_CASE("enum binary test", "[core][unit]")
+{
+    REQUIRE(roundtrip(color_t::green) == color_t::green);
+    REQUIRE(roundtrip(sparse_t::low) == sparse_t::low);
+    REQUIRE(roundtrip(sparse_t::high) == sparse_t::high);
+
+    // enums are encoded by their index into enum_values
+    REQUIRE(tsmp::to_binary(sparse_t::high) == std::vector<std::byte>{std::byte{2}});
+    REQUIRE_THROWS(tsmp::from_binary<color_t>(std::vector<std::byte>{std::byte{3}}));
+    REQUIRE_THROWS(tsmp::to_binary(static_cast<color_t>(42)));
+    REQUIRE_THROWS(tsmp::to_binary(static_cast<sparse_t>(42)));
+}
+
+TEST_CASE("string and range binary test", "[core][unit]")
+{
+    REQUIRE(roundtrip(std::string("Hello World!")) == "Hello World!");
+    REQUIRE(roundtrip(std::string()).empty());
+    REQUIRE(tsmp::to_binary(std::string("abc")).size() == 4);
+    REQUIRE(roundtrip(tsmp::string_literal_t("abcd")) == tsmp::string_literal_t("abcd"));
+
+    REQUIRE(roundtrip(std::vector<int>{1, 2, 3}) == std::vector<int>{1, 2, 3});
+    REQUIRE(roundtrip(std::deque<std::string>{"a", "b"}) == std::deque<std::string>{"a", "b"});
+    REQUIRE(roundtrip(std::list<color_t>{color_t::blue, color_t::red}) ==
+            std::list<color_t>{color_t::blue, color_t::red});
+    REQUIRE(roundtrip(std::array<double, 3>{1.0, 2.0, 3.0}) == std::array<double, 3>{1.0, 2.0, 3.0});
+    REQUIRE(roundtrip(std::vector<bool>{true, false, true}) == std::vector<bool>{true, false, true});
+
+    // a vector of bitwise values is copied as one block after the length prefix
+    REQUIRE(tsmp::to_binary(std::vector<std::uint32_t>(100, 300)).size() == 1 + 400);
+
+    auto truncated = tsmp::to_binary(std::vector<std::uint32_t>{1, 2, 3});
+    truncated.pop_back();
+    REQUIRE_THROWS(tsmp::from_binary<std::vector<std::uint32_t>>(truncated));
+    REQUIRE_THROWS(tsmp::from_binary<std::string>(std::vector<std::byte>{std::byte{0x7f}}));
+}
+
+TEST_CASE("optional and variant binary test", "[core][unit]")
+{
+    using variant = std::variant<int, float, std::string>;
+    REQUIRE(roundtrip(std::optional<int>(42)) == 42);
+    REQUIRE(roundtrip(std::optional<int>()) == std::nullopt);
+    REQUIRE(roundtrip(variant("test")) == variant("test"));
+    REQUIRE(roundtrip(variant(5)) == variant(5));
+    REQUIRE(roundtrip(variant(5.0f)) == variant(5.0f));
+    REQUIRE_THROWS(tsmp::from_binary<variant>(std::vector<std::byte>{std::byte{3}, std::byte{0}}));
+}
+
+struct point_t
+{
+    float x;
+    float y;
+    float z;
+    auto operator<=>(const point_t&) const noexcept = default;
+};
+
+struct padded_t
+{
+    std::uint8_t tag;
+    std::uint32_t value;
+    auto operator<=>(const padded_t&) const noexcept = default;
+};
+
+struct record_t
+{
+    std::uint64_t id;
+    std::string name;
+    color_t color;
+    point_t position;
+    padded_t padded;
+    std::vector<point_t> path;
+    std::optional<std::string> comment;
+    auto operator<=>(const record_t&) const noexcept = default;
+};
+
+TEST_CASE("struct binary test", "[core][unit]")
+{
+    static_assert(tsmp::detail::binary_codec_t<point_t>::bitwise);
+    static_assert(!tsmp::detail::binary_codec_t<padded_t>::bitwise);
+    static_assert(!tsmp::detail::binary_codec_t<record_t>::bitwise);
+
+    const record_t record{
+        42, "record", color_t::blue, {1.0f, 2.0f, 3.0f}, {7, 300}, {{4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}}, "comment"};
+    const auto encoded = tsmp::to_binary(record);
+    REQUIRE(tsmp::from_binary<record_t>(encoded) == record);
+    REQUIRE(tsmp::to_binary(point_t{1.0f, 2.0f, 3.0f}).size() == sizeof(point_t));
+    REQUIRE(tsmp::to_binary(padded_t{7, 300}).size() == 3);
+
+    auto trailing = encoded;
+    trailing.push_back(std::byte{0});
+    REQUIRE_THROWS(tsmp::from_binary<record_t>(trailing));
+    REQUIRE(tsmp::try_from_binary<record_t>(trailing) == std::nullopt);
+
+    for (std::size_t size = 0; size < encoded.size(); ++size) {
+        REQUIRE(tsmp::try_from_binary<record_t>(std::span(encoded).first(size)) == std::nullopt);
+    }
+
+    std::vector<std::byte> buffer;
+    tsmp::to_binary(std::uint8_t{1}, buffer);
+    tsmp::to_binary(std::uint8_t{2}, buffer);
+    REQUIRE(buffer == std::vector<std::byte>{std::byte{1}, std::byte{2}});
+}
+
+TEST_CASE("validator binary test", "[core][unit]")
+{
+    constexpr const auto is_fourtytwo = [](auto number) { return number == 42; };
+    const auto encoded = tsmp::to_binary(42);
+    REQUIRE(tsmp::from_binary<int>(encoded, is_fourtytwo) == 42);
+    REQUIRE_THROWS(tsmp::from_binary<int>(tsmp::to_binary(43), is_fourtytwo));
+    REQUIRE(tsmp::try_from_binary<int>(tsmp::to_binary(43), is_fourtytwo) == std::nullopt);
+}
@@ -0,0 +1,177 @@
+#include "tsmp/json.hpp"
+#include "tsmp/cbor.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+template<class T>
+T roundtrip(const T& value)
+{
+    return tsmp::from_cbor<T>(tsmp::to_cbor(value));
+}
+
+std::vector<std::byte> bytes(std::initializer_list<int> values)
+{
+    std::vector<std::byte> result;
+    for (const auto value : values) {
+        result.push_back(static_cast<std::byte>(value));
+    }
+    return result;
+}
+
+std::vector<std::byte> bytes(const std::vector<std::uint8_t>& values)
+{
+    std::vector<std::byte> result;
+    for (const auto value : values) {
+        result.push_back(static_cast<std::byte>(value));
+    }
+    return result;
+}
+
+TEST_CASE("arithmetic cbor test", "[core][unit]")
+{
+    REQUIRE(roundtrip(static_cast<std::int32_t>(-42)) == -42);
+    REQUIRE(roundtrip(static_cast<std::uint64_t>(0xdeadbeefcafe)) == 0xdeadbeefcafe);
+    REQUIRE(roundtrip(std::numeric_limits<std::int64_t>::min()) == std::numeric_limits<std::int64_t>::min());
+    REQUIRE(roundtrip(std::numeric_limits<std::uint64_t>::max()) == std::numeric_limits<std::uint64_t>::max());
+    REQUIRE(roundtrip(1337.5f) == 1337.5f);
+    REQUIRE(roundtrip(-0.25) == -0.25);
+    REQUIRE(roundtrip(true) == true);
+
+    // integers use the smallest possible representation
+    REQUIRE(tsmp::to_cbor(std::uint64_t{7}) == bytes({0x07}));
+    REQUIRE(tsmp::to_cbor(std::int32_t{-1}) == bytes({0x20}));
+    REQUIRE(tsmp::to_cbor(std::int32_t{-33}) == bytes({0x38, 0x20}));
+    REQUIRE(tsmp::to_cbor(std::uint32_t{300}) == bytes({0x19, 0x01, 0x2c}));
+    REQUIRE(tsmp::to_cbor(1.5f) == bytes({0xfa, 0x3f, 0xc0, 0x00, 0x00}));
+    REQUIRE(tsmp::to_cbor(false) == bytes({0xf4}));
+
+    REQUIRE(tsmp::from_cbor<double>(tsmp::to_cbor(42)) == 42.0);
+    REQUIRE_THROWS(tsmp::from_cbor<std::uint8_t>(tsmp::to_cbor(300)));
+    REQUIRE_THROWS(tsmp::from_cbor<std::uint32_t>(tsmp::to_cbor(-1)));
+    REQUIRE_THROWS(tsmp::from_cbor<int>(tsmp::to_cbor(1.5)));
+    REQUIRE(tsmp::try_from_cbor<int>(bytes({0x19, 0x01})) == std::nullopt);
+}
+
+enum class color_t
+{
+    red,
+    green,
+    blue
+};
+
+TEST_CASE("enum and string cbor test", "[core][unit]")
+{
+    REQUIRE(roundtrip(color_t::green) == color_t::green);
+    REQUIRE(tsmp::to_cbor(color_t::red) == bytes({0x63, 'r', 'e', 'd'}));
+    REQUIRE_THROWS(tsmp::from_cbor<color_t>(tsmp::to_cbor(std::string("purple"))));
+
+    REQUIRE(roundtrip(std::string("Hello World!")) == "Hello World!");
+    REQUIRE(roundtrip(std::string(40, 'x')) == std::string(40, 'x'));
+    REQUIRE(roundtrip(std::string(70000, 'x')) == std::string(70000, 'x'));
+    REQUIRE(tsmp::to_cbor(std::string(40, 'x')).size() == 42);
+    REQUIRE(tsmp::to_cbor(std::string(23, 'x')).size() == 24);
+    REQUIRE(roundtrip(tsmp::string_literal_t("abcd")) == tsmp::string_literal_t("abcd"));
+}
+
+TEST_CASE("container cbor test", "[core][unit]")
+{
+    using variant = std::variant<int, std::string>;
+    REQUIRE(roundtrip(std::vector<int>{1, 2, 3}) == std::vector<int>{1, 2, 3});
+    REQUIRE(roundtrip(std::vector<int>(20, 5)) == std::vector<int>(20, 5));
+    REQUIRE(roundtrip(std::deque<std::string>{"a", "b"}) == std::deque<std::string>{"a", "b"});
+    REQUIRE(roundtrip(std::vector<bool>{true, false}) == std::vector<bool>{true, false});
+    REQUIRE(roundtrip(std::array<double, 2>{1.0, 2.0}) == std::array<double, 2>{1.0, 2.0});
+    REQUIRE_THROWS(tsmp::from_cbor<std::array<double, 3>>(tsmp::to_cbor(std::vector<double>{1.0, 2.0})));
+
+    REQUIRE(roundtrip(std::optional<int>(42)) == 42);
+    REQUIRE(roundtrip(std::optional<int>()) == std::nullopt);
+    REQUIRE(tsmp::to_cbor(std::optional<int>()) == bytes({0xf6}));
+    REQUIRE(roundtrip(variant("test")) == variant("test"));
+    REQUIRE(roundtrip(variant(5)) == variant(5));
+}
+
+struct point_t
+{
+    float x;
+    float y;
+    auto operator<=>(const point_t&) const noexcept = default;
+};
+
+struct record_t
+{
+    std::uint64_t id;
+    std::string name;
+    color_t color;
+    std::vector<point_t> path;
+    std::optional<std::string> comment;
+    auto operator<=>(const record_t&) const noexcept = default;
+};
+
+TEST_CASE("struct cbor test", "[core][unit]")
+{
+    const record_t record{42, "record", color_t::blue, {{1.0f, 2.0f}, {-3.5f, 4.0f}}, "comment"};
+    const auto encoded = tsmp::to_cbor(record);
+    REQUIRE(tsmp::from_cbor<record_t>(encoded) == record);
+
+    // the encoding matches the document model of the json encoding
+    const auto foreign = nlohmann::json::from_cbor(reinterpret_cast<const std::uint8_t*>(encoded.data()),
+                                                      reinterpret_cast<const std::uint8_t*>(encoded.data()) +
+                                                          encoded.size());
+    REQUIRE(foreign == nlohmann::json::parse(tsmp::to_json(record)));
+
+    // foreign encoders may choose other representations and field orders
+    auto document = nlohmann::json::parse(
+        R"({"comment":null,"path":[{"y":2,"x":1.5}],"extra":[{"a":[1,2.5,"s"]},{}],"color":"red","name":"n","id":7})");
+    const auto decoded = tsmp::from_cbor<record_t>(bytes(nlohmann::json::to_cbor(document)));
+    REQUIRE(decoded == record_t{7, "n", color_t::red, {{1.5f, 2.0f}}, std::nullopt});
+
+    document.erase("name");
+    REQUIRE_THROWS(tsmp::from_cbor<record_t>(bytes(nlohmann::json::to_cbor(document))));
+
+    for (std::size_t size = 0; size < encoded.size(); ++size) {
+        REQUIRE(tsmp::try_from_cbor<record_t>(std::span(encoded).first(size)) == std::nullopt);
+    }
+    auto trailing = encoded;
+    trailing.push_back(std::byte{0xf6});
+    REQUIRE_THROWS(tsmp::from_cbor<record_t>(trailing));
+}
+
+TEST_CASE("cbor encoding features test", "[core][unit]")
+{
+    // half precision floats
+    REQUIRE(tsmp::from_cbor<double>(bytes({0xf9, 0x3c, 0x00})) == 1.0);
+    REQUIRE(tsmp::from_cbor<float>(bytes({0xf9, 0xc4, 0x00})) == -4.0f);
+    REQUIRE(tsmp::from_cbor<double>(bytes({0xf9, 0x00, 0x01})) == std::ldexp(1.0, -24));
+    REQUIRE(std::isinf(tsmp::from_cbor<double>(bytes({0xf9, 0x7c, 0x00}))));
+
+    // semantic tags are ignored
+    REQUIRE(tsmp::from_cbor<std::string>(bytes({0xc0, 0x61, 'a'})) == "a");
+    REQUIRE(tsmp::from_cbor<double>(bytes({0xc1, 0xfb, 0x3f, 0xf8, 0, 0, 0, 0, 0, 0})) == 1.5);
+
+    // indefinite length arrays and maps
+    REQUIRE(tsmp::from_cbor<std::vector<int>>(bytes({0x9f, 0x01, 0x02, 0x03, 0xff})) == std::vector<int>{1, 2, 3});
+    REQUIRE(tsmp::from_cbor<point_t>(bytes({0xbf, 0x61, 'x', 0x01, 0x61, 'y', 0x02, 0xff})) == point_t{1.0f, 2.0f});
+
+    // unknown fields are skipped, including indefinite and chunked values
+    REQUIRE(tsmp::from_cbor<point_t>(bytes({0xa3, 0x61, 'x', 0x01, 0x61, 'z', 0x9f, 0x7f, 0x61, 'a', 0x62, 'b', 'c',
+                                            0xff, 0xbf, 0x01, 0x40, 0xff, 0xff, 0x61, 'y', 0x02})) ==
+            point_t{1.0f, 2.0f});
+    REQUIRE_THROWS(tsmp::from_cbor<std::string>(bytes({0x7f, 0x61, 'a', 0xff})));
+    REQUIRE_THROWS(tsmp::from_cbor<int>(bytes({0x1c})));
+}
+
+TEST_CASE("validator cbor test", "[core][unit]")
+{
+    constexpr const auto is_fourtytwo = [](auto number) { return number == 42; };
+    REQUIRE(tsmp::from_cbor<int>(tsmp::to_cbor(42), is_fourtytwo) == 42);
+    REQUIRE_THROWS(tsmp::from_cbor<int>(tsmp::to_cbor(43), is_fourtytwo));
+    REQUIRE(tsmp::try_from_cbor<int>(tsmp::to_cbor(43), is_fourtytwo) == std::nullopt);
+}
@@ -0,0 +1,121 @@
+#include "tsmp/column_block.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class status_t
+{
+    pending,
+    active,
+    suspended,
+    closed,
+    deleted
+};
+
+struct address_t
+{
+    std::string country;
+    std::uint16_t zip;
+    auto operator<=>(const address_t&) const noexcept = default;
+};
+
+struct account_t
+{
+    std::uint32_t day;
+    std::int64_t balance;
+    double rate;
+    bool verified;
+    status_t status;
+    std::string plan;
+    std::optional<std::string> referrer;
+    address_t address;
+    bool operator==(const account_t&) const noexcept = default;
+};
+
+struct other_t
+{
+    std::uint32_t day;
+};
+
+TEST_CASE("column block roundtrip test", "[core][unit]")
+{
+    const std::vector<std::string> plans{"free", "basic", "premium"};
+    const std::vector<std::string> countries{"DE", "FR", "US", "JP"};
+    std::vector<account_t> accounts;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        account_t account{};
+        account.day = static_cast<std::uint32_t>(i / 100);
+        account.balance = static_cast<std::int64_t>(i * 7919 % 10007) - 5000;
+        account.rate = 0.015;
+        account.verified = i % 3 != 0;
+        account.status = static_cast<status_t>(i / 250);
+        account.plan = plans[i % plans.size()];
+        if (i % 10 == 0) {
+            account.referrer = "ref" + std::to_string(i % 30);
+        }
+        account.address = address_t{countries[i / 250], static_cast<std::uint16_t>(i % 97)};
+        accounts.push_back(account);
+    }
+    const auto block = tsmp::to_column_block(accounts);
+    REQUIRE(tsmp::from_column_block<account_t>(block) == accounts);
+
+    // the sorted day, the constant rate and the clustered status and country shrink to a few runs, the plan and the
+    // flags to a few bits per record
+    REQUIRE(block.size() < 1000 * 12);
+
+    REQUIRE(tsmp::from_column_block<account_t>(tsmp::to_column_block(std::vector<account_t>{})).empty());
+    const std::vector<account_t> single{{1, -5, 0.5, true, status_t::closed, "free", "ref", {"DE", 10115}}};
+    REQUIRE(tsmp::from_column_block<account_t>(tsmp::to_column_block(single)) == single);
+}
+
+TEST_CASE("column block encoding test", "[core][unit]")
+{
+    // schema hash, row count, encoding, run count and a single run of value and length
+    std::vector<other_t> sorted(1000, other_t{7});
+    REQUIRE(tsmp::to_column_block(sorted).size() == 8 + 2 + 1 + 1 + 4 + 2);
+
+    std::vector<other_t> distinct;
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        distinct.push_back({i * 2654435761u});
+    }
+    REQUIRE(tsmp::to_column_block(distinct).size() == 8 + 2 + 1 + 4000);
+    REQUIRE(tsmp::from_column_block<other_t>(tsmp::to_column_block(distinct))[999].day == 999 * 2654435761u);
+
+    // five states need three bits
+    std::vector<account_t> accounts(64);
+    for (std::size_t i = 0; i < accounts.size(); ++i) {
+        accounts[i].status = static_cast<status_t>(i % 5);
+    }
+    REQUIRE(tsmp::from_column_block<account_t>(tsmp::to_column_block(accounts)) == accounts);
+
+    const std::vector<double> specials{-0.0, 0.0, std::numeric_limits<double>::quiet_NaN(), 1.5};
+    std::vector<account_t> floats(specials.size());
+    for (std::size_t i = 0; i < specials.size(); ++i) {
+        floats[i].rate = specials[i];
+    }
+    const auto decoded = tsmp::from_column_block<account_t>(tsmp::to_column_block(floats));
+    REQUIRE(std::signbit(decoded[0].rate));
+    REQUIRE(!std::signbit(decoded[1].rate));
+    REQUIRE(std::isnan(decoded[2].rate));
+}
+
+TEST_CASE("column block validation test", "[core][unit]")
+{
+    const std::vector<account_t> accounts{{1, 100, 0.015, true, status_t::active, "basic", {}, {"FR", 7501}},
+                                          {2, -100, 0.015, false, status_t::pending, "free", "ref", {"US", 1001}}};
+    const auto block = tsmp::to_column_block(accounts);
+    REQUIRE_THROWS_AS(tsmp::from_column_block<other_t>(block), std::runtime_error);
+    REQUIRE(!tsmp::try_from_column_block<account_t>(std::span(block).first(block.size() - 1)));
+    REQUIRE(!tsmp::try_from_column_block<account_t>(block, [](const account_t& account) { return account.verified; }));
+
+    for (std::size_t i = 8; i < block.size(); ++i) {
+        auto corrupted = block;
+        corrupted[i] ^= std::byte{0x24};
+        (void)tsmp::try_from_column_block<account_t>(corrupted);
+    }
+}
@@ -0,0 +1,125 @@
+#include "tsmp/compare.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+enum class status_t
+{
+    open,
+    closed
+};
+
+struct order_id_t
+{
+    std::uint32_t high;
+    std::uint32_t low;
+};
+
+struct order_t
+{
+    order_id_t id;
+    std::int32_t quantity;
+    std::int32_t filled;
+    status_t status;
+    double price;
+    std::string owner;
+    std::optional<std::int64_t> parent;
+    std::vector<order_id_t> children;
+};
+
+struct counters_t
+{
+    std::int32_t a;
+    std::int32_t b;
+    std::int64_t c;
+    std::uint8_t d;
+};
+
+TEST_CASE("equal test", "[core][unit]")
+{
+    const order_t order{{1, 2}, 10, 5, status_t::open, 1.5, "alice", std::nullopt, {{3, 4}}};
+    REQUIRE(tsmp::equal(order, order));
+
+    auto other = order;
+    other.id.low = 3;
+    REQUIRE(!tsmp::equal(order, other));
+    other = order;
+    other.filled = 6;
+    REQUIRE(!tsmp::equal(order, other));
+    other = order;
+    other.price = 2;
+    REQUIRE(!tsmp::equal(order, other));
+    other = order;
+    other.owner = "bob";
+    REQUIRE(!tsmp::equal(order, other));
+    other = order;
+    other.parent = 0;
+    REQUIRE(!tsmp::equal(order, other));
+    other = order;
+    other.children.push_back({});
+    REQUIRE(!tsmp::equal(order, other));
+
+    other = order;
+    other.price = std::numeric_limits<double>::quiet_NaN();
+    REQUIRE(!tsmp::equal(other, other));
+}
+
+TEST_CASE("equal bytewise test", "[core][unit]")
+{
+    static_assert(std::has_unique_object_representations_v<order_id_t>);
+    static_assert(!std::has_unique_object_representations_v<counters_t>);
+
+    const counters_t counters{1, 2, 3, 4};
+    auto other = counters;
+    REQUIRE(tsmp::equal(counters, other));
+    other.b = 5;
+    REQUIRE(!tsmp::equal(counters, other));
+    other = counters;
+    other.d = 0;
+    REQUIRE(!tsmp::equal(counters, other));
+
+    std::vector<order_id_t> ids(100, order_id_t{1, 2});
+    auto copy = ids;
+    REQUIRE(tsmp::equal(std::span<const order_id_t>(ids), std::span<const order_id_t>(copy)));
+    copy[99].low = 0;
+    REQUIRE(!tsmp::equal(ids, copy));
+    copy.pop_back();
+    REQUIRE(!tsmp::equal(ids, copy));
+    REQUIRE(tsmp::equal(std::array<order_id_t, 0>{}, std::array<order_id_t, 0>{}));
+}
+
+TEST_CASE("compare test", "[core][unit]")
+{
+    static_assert(std::is_same_v<decltype(tsmp::compare(order_id_t{}, order_id_t{})), std::strong_ordering>);
+    static_assert(std::is_same_v<decltype(tsmp::compare(order_t{}, order_t{})), std::partial_ordering>);
+
+    REQUIRE(tsmp::compare(order_id_t{1, 2}, order_id_t{1, 2}) == std::strong_ordering::equal);
+    REQUIRE(tsmp::compare(order_id_t{1, 9}, order_id_t{2, 0}) == std::strong_ordering::less);
+    REQUIRE(tsmp::compare(order_id_t{2, 0}, order_id_t{1, 9}) == std::strong_ordering::greater);
+
+    const order_t order{{1, 2}, 10, 5, status_t::open, 1.5, "alice", std::nullopt, {}};
+    auto other = order;
+    REQUIRE(tsmp::compare(order, other) == std::partial_ordering::equivalent);
+    other.status = status_t::closed;
+    REQUIRE(tsmp::compare(order, other) == std::partial_ordering::less);
+    other = order;
+    other.owner = "al";
+    REQUIRE(tsmp::compare(order, other) == std::partial_ordering::greater);
+    other = order;
+    other.parent = -1;
+    REQUIRE(tsmp::compare(order, other) == std::partial_ordering::less);
+    other = order;
+    other.children.push_back({});
+    REQUIRE(tsmp::compare(order, other) == std::partial_ordering::less);
+    other = order;
+    other.price = std::numeric_limits<double>::quiet_NaN();
+    REQUIRE(tsmp::compare(order, other) == std::partial_ordering::unordered);
+}
@@ -0,0 +1,142 @@
+#include "tsmp/csv.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+enum class side_t
+{
+    buy,
+    sell
+};
+
+struct trade_t
+{
+    std::uint64_t id;
+    std::string symbol;
+    double price;
+    std::int32_t quantity;
+    side_t side;
+    bool settled;
+    std::optional<std::string> note;
+    std::optional<float> fee;
+    auto operator<=>(const trade_t&) const noexcept = default;
+};
+
+namespace {
+
+std::vector<trade_t> read_all(std::istream& input, tsmp::csv_options_t options = {})
+{
+    tsmp::csv_reader<trade_t> reader(input, options);
+    std::vector<trade_t> result;
+    while (auto trade = reader.next()) {
+        result.push_back(*trade);
+    }
+    return result;
+}
+
+}
+
+TEST_CASE("csv roundtrip test", "[core][unit]")
+{
+    std::vector<trade_t> trades;
+    for (std::uint64_t i = 0; i < 500; ++i) {
+        trade_t trade{i, "SYM" + std::to_string(i % 13), 100.0 / static_cast<double>(i + 3), -static_cast<int>(i),
+                      i % 2 ? side_t::sell : side_t::buy, i % 3 == 0, std::nullopt, std::nullopt};
+        if (i % 4 == 0) {
+            trade.note = i % 8 == 0 ? "" : "said \"hi\",\r\nthen left";
+        }
+        if (i % 5 == 0) {
+            trade.fee = 0.25f * static_cast<float>(i);
+        }
+        trades.push_back(trade);
+    }
+
+    // a tiny chunk size makes records and quoted cells cross chunk borders
+    for (const std::size_t chunk_size : {std::size_t{1} << 16, std::size_t{7}}) {
+        tsmp::csv_options_t options;
+        options.chunk_size = chunk_size;
+        std::stringstream stream;
+        {
+            tsmp::csv_writer<trade_t> writer(stream, options);
+            for (const auto& trade : trades) {
+                writer.write(trade);
+            }
+        }
+        REQUIRE(stream.str().starts_with("id,symbol,price,quantity,side,settled,note,fee\n0,SYM0,"));
+        REQUIRE(read_all(stream, options) == trades);
+    }
+
+    tsmp::csv_options_t options;
+    options.delimiter = ';';
+    options.header = false;
+    std::stringstream stream;
+    tsmp::csv_writer<trade_t>(stream, options).write(trades[4]);
+    REQUIRE(stream.str() == "4;SYM4;14.285714285714286;-4;buy;false;\"said \"\"hi\"\",\r\nthen left\";\n");
+    REQUIRE(read_all(stream, options) == std::vector<trade_t>{trades[4]});
+
+    // write errors are reported by close, the destructor swallows them
+    std::stringstream failing;
+    {
+        tsmp::csv_writer<trade_t> writer(failing, options);
+        writer.write(trades[0]);
+        failing.setstate(std::ios::badbit);
+        REQUIRE_THROWS_AS(writer.close(), std::runtime_error);
+        writer.write(trades[1]);
+    }
+    REQUIRE(failing.bad());
+}
+
+TEST_CASE("csv header mapping test", "[core][unit]")
+{
+    // columns in any order, unknown columns are skipped, missing optional columns keep their value
+    std::istringstream input("\xEF\xBB\xBFside,comment,symbol,id,settled,quantity,price\r\n"
+                             "sell,ignored,\"A,B\",7,1,-3,1e3\r\n"
+                             "\r\n"
+                             "buy,,C,8,false,4,-0.5");
+    const auto trades = read_all(input);
+    REQUIRE(trades.size() == 2);
+    REQUIRE(trades[0] == trade_t{7, "A,B", 1000.0, -3, side_t::sell, true, std::nullopt, std::nullopt});
+    REQUIRE(trades[1] == trade_t{8, "C", -0.5, 4, side_t::buy, false, std::nullopt, std::nullopt});
+
+    std::istringstream missing("id,symbol,price,quantity,side\n");
+    REQUIRE_THROWS_AS(tsmp::csv_reader<trade_t>(missing), std::runtime_error);
+    std::istringstream twice("id,symbol,price,quantity,side,settled,id\n");
+    REQUIRE_THROWS_AS(tsmp::csv_reader<trade_t>(twice), std::runtime_error);
+    std::istringstream empty("");
+    REQUIRE_THROWS_AS(tsmp::csv_reader<trade_t>(empty), std::runtime_error);
+}
+
+TEST_CASE("csv error test", "[core][unit]")
+{
+    const std::string header = "id,symbol,price,quantity,side,settled\n";
+    const auto fails = [&](const std::string& line) {
+        std::istringstream input(header + line);
+        tsmp::csv_reader<trade_t> reader(input);
+        trade_t trade{};
+        try {
+            (void)reader.read(trade);
+        } catch (const std::runtime_error& error) {
+            return std::string(error.what());
+        }
+        return std::string();
+    };
+    REQUIRE(fails("1,A,2.5,3,buy,true\n").empty());
+    REQUIRE(fails("x,A,2.5,3,buy,true\n") == "CSV record 2, column 1: Invalid number.");
+    REQUIRE(fails("1,A,2.5,99999999999,buy,true\n") == "CSV record 2, column 4: Number out of range.");
+    REQUIRE(fails("1,A,2.5,3,hold,true\n") == "CSV record 2, column 5: Name is not part of enumeration.");
+    REQUIRE(fails("1,A,2.5,3,buy,yes\n") == "CSV record 2, column 6: Invalid boolean value.");
+    REQUIRE(fails("1,A,2.5,3,buy\n") == "CSV record 2 has 5 columns instead of 6.");
+    REQUIRE(fails("1,\"A\"x,2.5,3,buy,true\n") == "CSV record 2 has characters after a closing quote.");
+    REQUIRE(fails("1,\"A,2.5,3,buy,true\n") == "CSV record 2 has an unterminated quote.");
+
+    tsmp::csv_options_t options;
+    options.chunk_size = 8;
+    options.max_record_size = 32;
+    std::istringstream input(header + "1," + std::string(100, 'A') + ",2.5,3,buy,true\n");
+    tsmp::csv_reader<trade_t> reader(input, options);
+    REQUIRE_THROWS_AS(reader.next(), std::runtime_error);
+}
@@ -0,0 +1,83 @@
+#include "tsmp/delta.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct position_t
+{
+    double x;
+    double y;
+};
+
+struct stats_t
+{
+    std::int32_t health;
+    std::int32_t mana;
+};
+
+struct unit_t
+{
+    std::uint64_t id;
+    position_t position;
+    std::string name;
+    stats_t stats;
+    std::optional<std::string> target;
+    std::vector<std::int32_t> inventory;
+};
+
+TEST_CASE("delta diff test", "[core][unit]")
+{
+    static_assert(tsmp::delta_mask<unit_t>{}.size() == 8);
+    const unit_t old_value{7, {1.5, -2}, std::string(200, 'n'), {100, 50}, std::nullopt, {1, 2, 3}};
+    auto new_value = old_value;
+    REQUIRE(tsmp::diff(old_value, new_value).none());
+
+    new_value.position.y = 3;
+    new_value.stats.mana = 49;
+    new_value.inventory.push_back(4);
+    const auto mask = tsmp::diff(old_value, new_value);
+    REQUIRE(mask == tsmp::delta_mask<unit_t>("10100100"));
+
+    new_value = old_value;
+    new_value.target = "enemy";
+    REQUIRE(tsmp::diff(old_value, new_value) == tsmp::delta_mask<unit_t>("01000000"));
+}
+
+TEST_CASE("delta round trip test", "[core][unit]")
+{
+    const unit_t old_value{7, {1.5, -2}, std::string(200, 'n'), {100, 50}, std::nullopt, {1, 2, 3}};
+    auto new_value = old_value;
+    new_value.position.x = 2;
+    new_value.target = "enemy";
+
+    const auto encoded = tsmp::delta(old_value, new_value);
+    REQUIRE(encoded.size() < 20);
+    REQUIRE(tsmp::delta(old_value, old_value) == std::vector<std::byte>{std::byte{0}});
+
+    auto receiver = old_value;
+    const auto applied = tsmp::apply(receiver, encoded);
+    REQUIRE(tsmp::equal(receiver, new_value));
+    REQUIRE(applied == tsmp::diff(old_value, new_value));
+
+    std::vector<std::byte> full;
+    tsmp::delta(new_value, tsmp::delta_mask<unit_t>().set(), full);
+    unit_t empty{};
+    tsmp::apply(empty, full);
+    REQUIRE(tsmp::equal(empty, new_value));
+}
+
+TEST_CASE("delta invalid input test", "[core][unit]")
+{
+    unit_t value{7, {1.5, -2}, "unit", {100, 50}, std::nullopt, {1, 2, 3}};
+    REQUIRE_THROWS_AS(tsmp::apply(value, std::vector<std::byte>{std::byte{1}, std::byte{8}}), std::runtime_error);
+    REQUIRE_THROWS_AS(tsmp::apply(value, std::vector<std::byte>{std::byte{1}, std::byte{0}}), std::runtime_error);
+    REQUIRE_THROWS_AS(tsmp::apply(value, std::vector<std::byte>{std::byte{0}, std::byte{0}}), std::runtime_error);
+
+    std::vector<std::byte> repeated{std::byte{2}, std::byte{0}, std::byte{1}, std::byte{0}, std::byte{2}};
+    REQUIRE_THROWS_AS(tsmp::apply(value, repeated), std::runtime_error);
+}
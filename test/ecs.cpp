@@ -0,0 +1,166 @@
+#include "tsmp/ecs.hpp"
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct position_t
+{
+    float x;
+    float y;
+    bool operator==(const position_t&) const noexcept = default;
+};
+
+struct velocity_t
+{
+    float dx;
+    float dy;
+    bool operator==(const velocity_t&) const noexcept = default;
+};
+
+struct name_t
+{
+    std::string value;
+    bool operator==(const name_t&) const noexcept = default;
+};
+
+using world_t = tsmp::ecs<position_t, velocity_t, name_t>;
+
+TEST_CASE("ecs entity lifetime test", "[core][unit]")
+{
+    world_t world;
+    const auto first = world.create(position_t{1, 2}, name_t{"first"});
+    const auto second = world.create(position_t{3, 4}, velocity_t{1, 0});
+    REQUIRE(world.size() == 2);
+    REQUIRE(world.alive(first));
+    REQUIRE(world.has<name_t>(first));
+    REQUIRE(!world.has<velocity_t>(first));
+    REQUIRE(world.get<position_t>(first) == position_t{1, 2});
+    REQUIRE(world.get<name_t, "value">(first) == "first");
+    REQUIRE(world.get<velocity_t>(second) == velocity_t{1, 0});
+    REQUIRE_THROWS_AS(world.get<name_t>(second), std::out_of_range);
+
+    world.destroy(first);
+    REQUIRE(!world.alive(first));
+    REQUIRE_THROWS_AS(world.get<position_t>(first), std::out_of_range);
+    REQUIRE_THROWS_AS(world.destroy(first), std::out_of_range);
+
+    const auto third = world.create(name_t{"third"});
+    REQUIRE(third.index == first.index);
+    REQUIRE(third != first);
+    REQUIRE(!world.alive(first));
+    REQUIRE(world.get<name_t>(third).value == "third");
+    REQUIRE(world.size() == 2);
+}
+
+TEST_CASE("ecs archetype test", "[core][unit]")
+{
+    world_t world;
+    std::vector<tsmp::entity_t> entities;
+    for (int i = 0; i < 100; ++i) {
+        entities.push_back(world.create(position_t{static_cast<float>(i), 0}, name_t{std::to_string(i)}));
+    }
+    for (int i = 0; i < 100; i += 2) {
+        world.add(entities[i], velocity_t{1, static_cast<float>(i)});
+    }
+    for (int i = 0; i < 100; i += 4) {
+        world.remove<name_t>(entities[i]);
+    }
+    world.set(entities[1], position_t{-1, -1});
+    world.get<position_t, "y">(entities[3]) = 5;
+
+    for (int i = 0; i < 100; ++i) {
+        const auto entity = entities[i];
+        REQUIRE(world.has<velocity_t>(entity) == (i % 2 == 0));
+        REQUIRE(world.has<name_t>(entity) == (i % 4 != 0));
+        if (i % 4 != 0) {
+            REQUIRE(world.get<name_t>(entity).value == std::to_string(i));
+        }
+        if (i % 2 == 0) {
+            REQUIRE(world.get<velocity_t>(entity) == velocity_t{1, static_cast<float>(i)});
+        }
+    }
+    REQUIRE(world.get<position_t>(entities[1]) == position_t{-1, -1});
+    REQUIRE(world.get<position_t>(entities[3]) == position_t{3, 5});
+    REQUIRE(world.get<position_t>(entities[50]) == position_t{50, 0});
+}
+
+TEST_CASE("ecs query test", "[core][unit]")
+{
+    world_t world;
+    for (int i = 0; i < 5000; ++i) {
+        if (i % 3 == 0) {
+            world.create(position_t{0, 0}, velocity_t{1, 2});
+        } else if (i % 3 == 1) {
+            world.create(position_t{0, 0}, velocity_t{1, 2}, name_t{"named"});
+        } else {
+            world.create(position_t{0, 0});
+        }
+    }
+
+    const auto chunks = world.query<position_t, velocity_t>();
+    REQUIRE(chunks.size() > 2);
+    std::size_t moving = 0;
+    for (const auto& chunk : chunks) {
+        moving += chunk.size();
+        REQUIRE(chunk.entities().size() == chunk.size());
+        REQUIRE(reinterpret_cast<std::uintptr_t>(chunk.column<velocity_t, "dx">().data()) % tsmp::ecs_cache_line == 0);
+        REQUIRE(chunk.column<velocity_t, 1>().size() == chunk.size());
+    }
+    REQUIRE(moving == 3334);
+
+    world.for_each<position_t, velocity_t>([](const auto& chunk) {
+        const auto x = chunk.template column<position_t, "x">();
+        const auto dx = chunk.template column<velocity_t, "dx">();
+        for (std::size_t i = 0; i < chunk.size(); ++i) {
+            x[i] += dx[i];
+        }
+    });
+    world.parallel_for_each<position_t, velocity_t>(
+        [](const auto& chunk) {
+            const auto y = chunk.template column<position_t, "y">();
+            const auto dy = chunk.template column<velocity_t, "dy">();
+            for (std::size_t i = 0; i < chunk.size(); ++i) {
+                y[i] += dy[i];
+            }
+        },
+        4);
+
+    std::size_t moved = 0;
+    std::size_t total = 0;
+    world.for_each<position_t>([&](const auto& chunk) {
+        const auto x = chunk.template column<position_t, "x">();
+        const auto y = chunk.template column<position_t, "y">();
+        REQUIRE(chunk.template has<velocity_t>() == (x.front() == 1));
+        for (std::size_t i = 0; i < chunk.size(); ++i) {
+            moved += x[i] == 1 && y[i] == 2;
+        }
+        total += chunk.size();
+    });
+    REQUIRE(moved == 3334);
+    REQUIRE(total == 5000);
+}
+
+TEST_CASE("ecs parallel exception test", "[core][unit]")
+{
+    world_t world;
+    for (int i = 0; i < 10000; ++i) {
+        world.create(position_t{0, 0});
+    }
+    std::atomic<std::size_t> visited = 0;
+    REQUIRE_THROWS_AS(world.parallel_for_each<position_t>([&](const auto& chunk) {
+        visited += chunk.size();
+        throw std::runtime_error("failed");
+    }),
+                      std::runtime_error);
+    REQUIRE(visited == 10000);
+
+    world.clear();
+    REQUIRE(world.size() == 0);
+    REQUIRE(world.query<position_t>().empty());
+}
@@ -0,0 +1,83 @@
+#include "tsmp/endian.hpp"
+#include <array>
+#include <bit>
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+enum class kind_t : std::uint16_t
+{
+    trade = 0x0102,
+    quote = 0x0304
+};
+
+struct header_t
+{
+    std::uint16_t length;
+    kind_t kind;
+    bool operator==(const header_t&) const noexcept = default;
+};
+
+struct message_t
+{
+    header_t header;
+    std::uint32_t sequence;
+    std::int64_t timestamp;
+    double price;
+    std::uint8_t flags;
+    bool last;
+    std::array<std::int16_t, 2> levels;
+    bool operator==(const message_t&) const noexcept = default;
+};
+
+TEST_CASE("endian byteswap test", "[core][unit]")
+{
+    message_t message{{0x1234, kind_t::trade}, 0x01020304, 0x0102030405060708, 1.0, 0xab, true, {0x0102, -2}};
+    tsmp::byteswap_fields(message);
+    REQUIRE(message.header.length == 0x3412);
+    REQUIRE(message.header.kind == static_cast<kind_t>(0x0201));
+    REQUIRE(message.sequence == 0x04030201);
+    REQUIRE(message.timestamp == 0x0807060504030201);
+    REQUIRE(message.price == std::bit_cast<double>(std::uint64_t{0x000000000000f03f}));
+    REQUIRE(message.flags == 0xab);
+    REQUIRE(message.last);
+    REQUIRE(message.levels == std::array<std::int16_t, 2>{0x0201, static_cast<std::int16_t>(0xfeff)});
+}
+
+TEST_CASE("endian array test", "[core][unit]")
+{
+    std::vector<message_t> messages;
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        messages.push_back(message_t{{static_cast<std::uint16_t>(i), kind_t::quote},
+                                     i * 7,
+                                     -static_cast<std::int64_t>(i),
+                                     i * 0.5,
+                                     static_cast<std::uint8_t>(i),
+                                     i % 2 == 0,
+                                     {static_cast<std::int16_t>(i), static_cast<std::int16_t>(-i)}});
+    }
+    auto swapped = messages;
+    tsmp::byteswap_fields(std::span(swapped));
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        auto expected = messages[i];
+        tsmp::byteswap_fields(expected);
+        REQUIRE(swapped[i] == expected);
+    }
+    tsmp::byteswap_fields(std::span(swapped));
+    REQUIRE(swapped == messages);
+}
+
+TEST_CASE("endian wire format test", "[core][unit]")
+{
+    header_t header{0x0a0b, kind_t::quote};
+    tsmp::to_big_endian(std::span(&header, 1));
+    std::array<unsigned char, sizeof(header_t)> bytes;
+    std::memcpy(bytes.data(), &header, sizeof(header_t));
+    REQUIRE(bytes == std::array<unsigned char, sizeof(header_t)>{0x0a, 0x0b, 0x03, 0x04});
+
+    tsmp::from_big_endian(std::span(&header, 1));
+    REQUIRE(header == header_t{0x0a0b, kind_t::quote});
+}
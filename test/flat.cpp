@@ -0,0 +1,115 @@
+#include "tsmp/flat.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class route_t
+{
+    north,
+    south
+};
+
+struct vec3_t
+{
+    float x;
+    float y;
+    float z;
+};
+
+struct tag_t
+{
+    std::string key;
+    std::string value;
+};
+
+struct message_t
+{
+    std::uint64_t id;
+    route_t route;
+    bool urgent;
+    std::string sender;
+    vec3_t position;
+    std::vector<std::int32_t> samples;
+    std::list<std::uint16_t> ports;
+    std::vector<tag_t> tags;
+    std::optional<tag_t> primary;
+    std::optional<std::uint32_t> priority;
+    std::vector<std::string> empty;
+};
+
+TEST_CASE("flat view scalar access test", "[core][unit]")
+{
+    const message_t message{
+        1337, route_t::south, true, "sender", {1.0f, 2.0f, 3.0f}, {-1, 2, -3}, {80, 443}, {}, {}, 7, {}};
+    const auto buffer = tsmp::to_flat(message);
+    const tsmp::flat_view<message_t> view(buffer);
+
+    REQUIRE(view.get<"id">() == 1337);
+    REQUIRE(view.get<0>() == 1337);
+    REQUIRE(view.get<"route">() == route_t::south);
+    REQUIRE(view.get<"urgent">() == true);
+    REQUIRE(view.get<"position">().y == 2.0f);
+    REQUIRE(view.get<"priority">() == 7u);
+    REQUIRE_FALSE(view.get<"primary">().has_value());
+}
+
+TEST_CASE("flat view indirect access test", "[core][unit]")
+{
+    const message_t message{42,
+                            route_t::north,
+                            false,
+                            "a longer sender name",
+                            {},
+                            {1, 2, 3, 4},
+                            {80, 443},
+                            {{"k1", "v1"}, {"k2", "v2"}},
+                            tag_t{"main", "tag"},
+                            std::nullopt,
+                            {}};
+    const auto buffer = tsmp::to_flat(message);
+    const tsmp::flat_view<message_t> view(buffer);
+
+    REQUIRE(view.get<"sender">() == "a longer sender name");
+
+    const std::span<const std::int32_t> samples = view.get<"samples">();
+    REQUIRE(std::vector(samples.begin(), samples.end()) == message.samples);
+    // fixed size elements are stored aligned, therefore the span points directly into the buffer
+    REQUIRE(reinterpret_cast<const std::byte*>(samples.data()) > buffer.data());
+    REQUIRE(reinterpret_cast<const std::byte*>(samples.data()) < buffer.data() + buffer.size());
+
+    const auto ports = view.get<"ports">();
+    REQUIRE(ports.size() == 2);
+    REQUIRE(ports[1] == 443);
+
+    const auto tags = view.get<"tags">();
+    REQUIRE(tags.size() == 2);
+    REQUIRE(tags[0].get<"key">() == "k1");
+    REQUIRE(tags[1].get<"value">() == "v2");
+    std::vector<std::string_view> keys;
+    for (const auto tag : tags) {
+        keys.push_back(tag.get<"key">());
+    }
+    REQUIRE(keys == std::vector<std::string_view>{"k1", "k2"});
+
+    REQUIRE(view.get<"primary">()->get<"value">() == "tag");
+    REQUIRE(view.get<"priority">() == std::nullopt);
+    REQUIRE(view.get<"empty">().empty());
+}
+
+TEST_CASE("flat view bounds test", "[core][unit]")
+{
+    const message_t message{42, route_t::north, false, "sender", {}, {1, 2, 3}, {}, {}, {}, {}, {}};
+    const auto buffer = tsmp::to_flat(message);
+
+    REQUIRE_THROWS(tsmp::flat_view<message_t>(std::span(buffer).first(4)));
+
+    // cut off the last vector, the table itself is still valid
+    const tsmp::flat_view<message_t> truncated{std::span(buffer).first(buffer.size() - 4)};
+    REQUIRE(truncated.get<"id">() == 42);
+    REQUIRE(truncated.get<"sender">() == "sender");
+    REQUIRE_THROWS(truncated.get<"empty">());
+}
@@ -0,0 +1,115 @@
+#include "tsmp/hash.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+enum class venue_t
+{
+    xnas,
+    xnys
+};
+
+struct packed_key_t
+{
+    std::uint32_t account;
+    std::uint32_t instrument;
+    std::int64_t sequence;
+};
+
+struct packed_key_equal_t
+{
+    bool operator()(const packed_key_t& lhs, const packed_key_t& rhs) const
+    {
+        return lhs.account == rhs.account && lhs.instrument == rhs.instrument && lhs.sequence == rhs.sequence;
+    }
+};
+
+struct option_key_t
+{
+    std::string symbol;
+    venue_t venue;
+    double strike;
+    std::optional<std::int32_t> expiry;
+    std::vector<packed_key_t> legs;
+};
+
+TEST_CASE("hash unique representation test", "[core][unit]")
+{
+    static_assert(std::has_unique_object_representations_v<packed_key_t>);
+    const tsmp::hash<packed_key_t> hash;
+    REQUIRE(hash({1, 2, 3}) == hash({1, 2, 3}));
+    REQUIRE(hash({1, 2, 3}) != hash({2, 1, 3}));
+
+    std::set<std::size_t> hashes;
+    for (std::uint32_t account = 0; account < 100; ++account) {
+        for (std::uint32_t instrument = 0; instrument < 100; ++instrument) {
+            hashes.insert(hash({account, instrument, 0}));
+        }
+    }
+    REQUIRE(hashes.size() == 10000);
+}
+
+TEST_CASE("hash nested record test", "[core][unit]")
+{
+    const tsmp::hash<option_key_t> hash;
+    const option_key_t key{"ABC", venue_t::xnas, 100.0, 20240621, {{1, 2, 3}}};
+    REQUIRE(hash(key) == hash(option_key_t{key}));
+
+    auto other = key;
+    other.strike = -0.0;
+    auto zero = key;
+    zero.strike = 0.0;
+    REQUIRE(hash(other) == hash(zero));
+
+    std::set<std::size_t> hashes{hash(key)};
+    other = key;
+    other.symbol = "ABD";
+    hashes.insert(hash(other));
+    other = key;
+    other.venue = venue_t::xnys;
+    hashes.insert(hash(other));
+    other = key;
+    other.expiry.reset();
+    hashes.insert(hash(other));
+    other = key;
+    other.legs.push_back({});
+    hashes.insert(hash(other));
+    other = key;
+    other.legs.front().sequence = 4;
+    hashes.insert(hash(other));
+    REQUIRE(hashes.size() == 6);
+}
+
+TEST_CASE("hash unordered container test", "[core][unit]")
+{
+    std::unordered_map<packed_key_t, int, tsmp::hash<packed_key_t>, packed_key_equal_t> map;
+    map[{1, 2, 3}] = 4;
+    map[{1, 2, 3}] += 1;
+    map[{3, 2, 1}] = 1;
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.at({1, 2, 3}) == 5);
+}
+
+TEST_CASE("hash_many test", "[core][unit]")
+{
+    std::vector<packed_key_t> keys;
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        keys.push_back({i, i * 7, -static_cast<std::int64_t>(i)});
+    }
+    const auto hashes = tsmp::hash_many(std::span<const packed_key_t>(keys));
+    REQUIRE(hashes.size() == keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(hashes[i] == tsmp::hash<packed_key_t>{}(keys[i]));
+    }
+
+    std::vector<std::size_t> short_output(3);
+    REQUIRE_THROWS_AS(tsmp::hash_many(std::span<const packed_key_t>(keys), std::span<std::size_t>(short_output)),
+                      std::out_of_range);
+}
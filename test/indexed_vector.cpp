@@ -0,0 +1,107 @@
+#include "tsmp/indexed_vector.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct trade_t
+{
+    std::uint64_t id;
+    std::int64_t ts;
+    std::string symbol;
+    double price;
+};
+
+using trades_t =
+    tsmp::indexed_vector<trade_t, tsmp::hash_index<"id">, tsmp::ordered_index<"ts">, tsmp::hash_index<"symbol">>;
+
+TEST_CASE("indexed_vector lookup test", "[core][unit]")
+{
+    trades_t trades;
+    trades.push_back({1, 100, "ABC", 1.5});
+    trades.push_back({2, 50, "XYZ", 2.5});
+    trades.push_back({3, 100, "ABC", 3.5});
+    trades.push_back({4, 75, "ABC", 4.5});
+
+    REQUIRE(trades.size() == 4);
+    REQUIRE(trades.find<"id">(3) == 2u);
+    REQUIRE(!trades.find<"id">(5));
+    REQUIRE(trades.contains<"symbol">("XYZ"));
+    REQUIRE(trades.find_all<"symbol">("ABC").size() == 3);
+    REQUIRE(trades.find_all<"ts">(100) == std::vector<std::size_t>{0, 2});
+    REQUIRE(trades.range<"ts">(60, 100) == std::vector<std::size_t>{3, 0, 2});
+    REQUIRE(trades.range<"ts">(101, 200).empty());
+}
+
+TEST_CASE("indexed_vector update test", "[core][unit]")
+{
+    trades_t trades;
+    for (std::uint64_t i = 0; i < 10; ++i) {
+        trades.push_back({i, static_cast<std::int64_t>(i * 10), i % 2 == 0 ? "EVEN" : "ODD", 0});
+    }
+
+    trades.update(3, [](trade_t& trade) {
+        trade.id = 33;
+        trade.price = 1;
+    });
+    REQUIRE(!trades.find<"id">(3));
+    REQUIRE(trades.find<"id">(33) == 3u);
+    REQUIRE(trades[3].price == 1);
+
+    trades.replace(4, {44, 5, "ODD", 2});
+    REQUIRE(trades.range<"ts">(0, 9) == std::vector<std::size_t>{0, 4});
+    REQUIRE(trades.find_all<"symbol">("EVEN").size() == 4);
+
+    trades.erase(0);
+    REQUIRE(trades.size() == 9);
+    REQUIRE(trades[0].id == 9);
+    REQUIRE(trades.find<"id">(9) == 0u);
+    REQUIRE(!trades.find<"id">(0));
+    REQUIRE(trades.range<"ts">(0, 100) == std::vector<std::size_t>{4, 1, 2, 3, 5, 6, 7, 8, 0});
+
+    trades.erase(8);
+    REQUIRE(trades.size() == 8);
+    REQUIRE(!trades.find<"id">(8));
+    REQUIRE(trades.find_all<"symbol">("EVEN").size() == 2);
+}
+
+TEST_CASE("indexed_vector batch test", "[core][unit]")
+{
+    std::vector<trade_t> loaded;
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        loaded.push_back({i, static_cast<std::int64_t>(1000 - i), "S" + std::to_string(i % 7), 0});
+    }
+    trades_t trades(loaded);
+    REQUIRE(trades.size() == 1000);
+    REQUIRE(trades.find<"id">(999) == 999u);
+    REQUIRE(trades.range<"ts">(1, 3) == std::vector<std::size_t>{999, 998, 997});
+
+    trades.begin_batch();
+    trades.push_back({1000, 0, "S0", 0});
+    trades.update(0, [](trade_t& trade) { trade.id = 5000; });
+    trades.erase(1);
+    REQUIRE_THROWS_AS(trades.find<"id">(1000), std::logic_error);
+    trades.end_batch();
+
+    REQUIRE(trades.find<"id">(5000) == 0u);
+    REQUIRE(trades.find<"id">(1000) == 1u);
+    REQUIRE(!trades.find<"id">(1));
+    REQUIRE(trades.range<"ts">(0, 0) == std::vector<std::size_t>{1});
+    REQUIRE(trades.find_all<"symbol">("S0").size() == 144);
+
+    // a failing append ends its batch, the records appended before the failure stay indexed
+    const auto failing = std::views::iota(std::uint64_t{0}, std::uint64_t{10}) |
+                         std::views::transform([](std::uint64_t i) -> trade_t {
+                             if (i == 3) {
+                                 throw std::runtime_error("record failed");
+                             }
+                             return {2000 + i, 0, "F", 0};
+                         });
+    REQUIRE_THROWS_AS(trades.append(failing), std::runtime_error);
+    REQUIRE(trades.size() == 1003);
+    REQUIRE(trades.find<"id">(2002) == 1002u);
+    REQUIRE(trades.find_all<"symbol">("F").size() == 3);
+}
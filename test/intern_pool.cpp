@@ -0,0 +1,103 @@
+#include "tsmp/intern_pool.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class level_t
+{
+    debug,
+    info
+};
+
+struct label_t
+{
+    std::string key;
+    std::string value;
+};
+
+struct config_t
+{
+    int version;
+    level_t level;
+    std::optional<double> timeout;
+    std::vector<label_t> labels;
+};
+
+TEST_CASE("intern_pool deduplication test", "[core][unit]")
+{
+    tsmp::intern_pool<config_t> pool;
+    const config_t config{1, level_t::info, 2.5, {{"app", "web"}, {"zone", "eu"}}};
+
+    const auto first = pool.intern(config);
+    const auto second = pool.intern(config_t{config});
+    REQUIRE(first == second);
+    REQUIRE(first.get() == second.get());
+    REQUIRE(pool.size() == 1);
+    REQUIRE(first->labels[1].value == "eu");
+
+    auto changed = config;
+    changed.labels.back().value = "us";
+    const auto third = pool.intern(changed);
+    REQUIRE(third != first);
+    REQUIRE(pool.size() == 2);
+
+    changed.labels.pop_back();
+    REQUIRE(pool.intern(changed) != first);
+    changed.labels.push_back({"zone", "eu"});
+    REQUIRE(pool.intern(changed) == first);
+    changed.timeout.reset();
+    REQUIRE(pool.intern(changed) != first);
+    REQUIRE(pool.contains(changed));
+    REQUIRE(!pool.contains(config_t{}));
+    REQUIRE(pool.size() == 4);
+}
+
+TEST_CASE("intern_pool collect test", "[core][unit]")
+{
+    tsmp::intern_pool<label_t> pool;
+    const auto kept = pool.intern({"a", "1"});
+    (void)pool.intern({"b", "2"});
+    REQUIRE(pool.size() == 2);
+    REQUIRE(pool.collect() == 1);
+    REQUIRE(pool.size() == 1);
+    REQUIRE(pool.intern({"a", "1"}) == kept);
+
+    pool.clear();
+    REQUIRE(pool.size() == 0);
+    REQUIRE(kept->value == "1");
+    REQUIRE(pool.intern({"a", "1"}) != kept);
+}
+
+TEST_CASE("intern_pool handle hash test", "[core][unit]")
+{
+    tsmp::intern_pool<label_t> pool;
+    std::unordered_map<tsmp::interned<label_t>, int> counts;
+    for (int i = 0; i < 100; ++i) {
+        ++counts[pool.intern({"key", std::to_string(i % 10)})];
+    }
+    REQUIRE(counts.size() == 10);
+    REQUIRE(counts[pool.intern({"key", "3"})] == 10);
+}
+
+TEST_CASE("intern_pool concurrency test", "[core][unit]")
+{
+    tsmp::intern_pool<label_t> pool;
+    std::vector<std::vector<tsmp::interned<label_t>>> handles(4);
+    std::vector<std::thread> threads;
+    for (auto& result : handles) {
+        threads.emplace_back([&pool, &result] {
+            for (int i = 0; i < 1000; ++i) {
+                result.push_back(pool.intern({"key", std::to_string(i % 50)}));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(pool.size() == 50);
+    REQUIRE(handles[0] == handles[3]);
+}
@@ -0,0 +1,68 @@
+#include "tsmp/kernels.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+struct request_t
+{
+    std::uint32_t id;
+    double latency;
+    std::int16_t status;
+    std::string path;
+};
+
+TEST_CASE("column kernel aggregation test", "[core][unit]")
+{
+    // 1000 is not a multiple of the lane count, so the tail loop is covered as well
+    tsmp::soa_vector<request_t> requests;
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        requests.push_back(request_t{i, (i % 10) * 0.25, static_cast<std::int16_t>(i % 7 == 0 ? 500 : 200), "/"});
+    }
+    REQUIRE(tsmp::kernels::sum<"latency">(requests) ==
+            100 * (0.0 + 0.25 + 0.5 + 0.75 + 1.0 + 1.25 + 1.5 + 1.75 + 2.0 + 2.25));
+    REQUIRE(tsmp::kernels::sum<"id">(requests) == 999 * 1000 / 2);
+    STATIC_REQUIRE(std::is_same_v<decltype(tsmp::kernels::sum<"id">(requests)), std::uint64_t>);
+    STATIC_REQUIRE(std::is_same_v<decltype(tsmp::kernels::sum<"status">(requests)), std::int64_t>);
+
+    REQUIRE(tsmp::kernels::min<"latency">(requests) == 0.0);
+    REQUIRE(tsmp::kernels::max<"latency">(requests) == 2.25);
+    REQUIRE(tsmp::kernels::max<"id">(requests) == 999);
+    REQUIRE(tsmp::kernels::min<"status">(requests) == 200);
+
+    const tsmp::soa_vector<request_t> empty;
+    REQUIRE(tsmp::kernels::sum<"latency">(empty) == 0.0);
+    REQUIRE(!tsmp::kernels::min<"latency">(empty).has_value());
+    REQUIRE(!tsmp::kernels::max<"id">(empty).has_value());
+}
+
+TEST_CASE("column kernel filter test", "[core][unit]")
+{
+    tsmp::soa_vector<request_t> requests;
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        requests.push_back(request_t{i, (i % 10) * 0.25, static_cast<std::int16_t>(i % 7 == 0 ? 500 : 200), "/"});
+    }
+    REQUIRE(tsmp::kernels::count_if<"status">(requests, tsmp::kernels::equal_to<std::int16_t>{500}) == 143);
+    REQUIRE(tsmp::kernels::count_if<"latency">(requests, tsmp::kernels::greater{2.0}) == 100);
+    REQUIRE(tsmp::kernels::count_if<"id">(requests, tsmp::kernels::between<std::uint32_t>{10, 19}) == 10);
+    REQUIRE(tsmp::kernels::count_if<"id">(requests, [](std::uint32_t id) { return id % 2 == 1; }) == 500);
+
+    const auto failed = tsmp::kernels::select<"status">(requests, tsmp::kernels::not_equal_to<std::int16_t>{200});
+    REQUIRE(failed.size() == 143);
+    REQUIRE(std::ranges::is_sorted(failed));
+    REQUIRE(std::ranges::all_of(failed, [](std::size_t index) { return index % 7 == 0; }));
+
+    // refining a selection keeps the rows matching both predicates
+    const auto slow_failures = tsmp::kernels::select<"latency">(requests, failed, tsmp::kernels::greater_equal{2.0});
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        if (i % 7 == 0 && i % 10 >= 8) {
+            expected.push_back(i);
+        }
+    }
+    REQUIRE(slow_failures == expected);
+    REQUIRE(tsmp::kernels::select<"id">(requests, tsmp::kernels::less{0u}).empty());
+}
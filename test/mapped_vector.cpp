@@ -0,0 +1,109 @@
+#include "tsmp/mapped_vector.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+enum class state_t
+{
+    idle,
+    running
+};
+
+struct vec2_t
+{
+    float x;
+    float y;
+    auto operator<=>(const vec2_t&) const noexcept = default;
+};
+
+struct entity_t
+{
+    std::uint64_t id;
+    std::string name;
+    state_t state;
+    vec2_t position;
+    std::vector<std::uint16_t> ports;
+    bool active;
+    std::vector<double> samples;
+    auto operator<=>(const entity_t&) const noexcept = default;
+};
+
+struct other_t
+{
+    std::uint64_t id;
+};
+
+struct temporary_file_t
+{
+    std::filesystem::path path;
+
+    explicit temporary_file_t(std::string_view name)
+        : path(std::filesystem::temp_directory_path() / name)
+    {
+    }
+
+    ~temporary_file_t() { std::filesystem::remove(path); }
+};
+
+TEST_CASE("mapped vector roundtrip test", "[core][unit]")
+{
+    const temporary_file_t file("tsmp_mapped_vector_roundtrip.bin");
+    std::vector<entity_t> entities;
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        entities.push_back(entity_t{i,
+                                    "entity " + std::to_string(i),
+                                    i % 2 ? state_t::running : state_t::idle,
+                                    {static_cast<float>(i), -1.0f},
+                                    std::vector<std::uint16_t>(i % 5, static_cast<std::uint16_t>(i)),
+                                    i % 3 == 0,
+                                    std::vector<double>(i % 7, 0.5)});
+    }
+    tsmp::mapped_vector<entity_t>::write(file.path, entities);
+
+    const tsmp::mapped_vector<entity_t> mapped(file.path);
+    REQUIRE(mapped.size() == entities.size());
+    REQUIRE(!mapped.empty());
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        REQUIRE(mapped[i] == entities[i]);
+    }
+
+    REQUIRE(mapped.get<"id">(42) == 42);
+    REQUIRE(mapped.get<"name">(42) == "entity 42");
+    REQUIRE(mapped.get<"state">(43) == state_t::running);
+    REQUIRE(mapped.get<"position">(7) == vec2_t{7.0f, -1.0f});
+    REQUIRE(mapped.get<"ports">(4).size() == 4);
+    REQUIRE(mapped.get<"ports">(4)[3] == 4);
+    REQUIRE(mapped.get<"samples">(6).size() == 6);
+    REQUIRE(mapped.get<1>(0) == "entity 0");
+    REQUIRE_THROWS_AS(mapped.get<"id">(100), std::out_of_range);
+
+    // the spans point into the mapping and keep the natural alignment of their elements
+    const auto samples = mapped.get<"samples">(13);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(samples.data()) % alignof(double) == 0);
+
+    auto moved = tsmp::mapped_vector<entity_t>(file.path);
+    const auto target = std::move(moved);
+    REQUIRE(target.size() == 100);
+    REQUIRE(moved.empty());
+}
+
+TEST_CASE("mapped vector validation test", "[core][unit]")
+{
+    const temporary_file_t file("tsmp_mapped_vector_validation.bin");
+    tsmp::mapped_vector<entity_t>::write(file.path, std::deque<entity_t>{});
+    REQUIRE(tsmp::mapped_vector<entity_t>(file.path).empty());
+
+    tsmp::mapped_vector<other_t>::write(file.path, std::vector<other_t>{{1}, {2}});
+    REQUIRE(tsmp::mapped_vector<other_t>(file.path)[1].id == 2);
+    REQUIRE_THROWS(tsmp::mapped_vector<entity_t>(file.path));
+
+    std::filesystem::resize_file(file.path, 64 + 8);
+    REQUIRE_THROWS(tsmp::mapped_vector<other_t>(file.path));
+    std::filesystem::resize_file(file.path, 10);
+    REQUIRE_THROWS(tsmp::mapped_vector<other_t>(file.path));
+    REQUIRE_THROWS(tsmp::mapped_vector<other_t>(file.path.string() + ".missing"));
+}
@@ -0,0 +1,117 @@
+#include "tsmp/memory_footprint.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct point_t
+{
+    double x;
+    double y;
+};
+
+struct shape_t
+{
+    std::string name;
+    std::vector<point_t> points;
+    std::optional<std::string> label;
+    point_t origin;
+};
+
+struct scene_t
+{
+    std::uint32_t id;
+    std::vector<shape_t> shapes;
+    std::array<std::int32_t, 4> flags;
+    std::map<std::int32_t, std::string> tags;
+    std::list<std::int64_t> history;
+};
+
+TEST_CASE("memory_footprint heap memory test", "[core][unit]")
+{
+    REQUIRE(tsmp::memory_footprint(point_t{1, 2}) == sizeof(point_t));
+    REQUIRE(tsmp::memory_footprint(std::string("short")) == sizeof(std::string));
+
+    const std::string long_name(100, 'x');
+    REQUIRE(tsmp::memory_footprint(long_name) == sizeof(std::string) + long_name.capacity() + 1);
+
+    std::vector<point_t> points;
+    points.reserve(10);
+    points.push_back({1, 2});
+    REQUIRE(tsmp::memory_footprint(points) == sizeof(points) + 10 * sizeof(point_t));
+
+    shape_t shape{long_name, points, std::nullopt, {0, 0}};
+    const auto shape_bytes = sizeof(shape_t) + shape.name.capacity() + 1 + shape.points.capacity() * sizeof(point_t);
+    REQUIRE(tsmp::memory_footprint(shape) == shape_bytes);
+    shape.label = long_name;
+    REQUIRE(tsmp::memory_footprint(shape) == shape_bytes + shape.label->capacity() + 1);
+
+    // views own no heap memory
+    const std::list<std::string> names{long_name, long_name};
+    REQUIRE(tsmp::memory_footprint(std::ranges::ref_view(names)) == sizeof(std::ranges::ref_view<decltype(names)>));
+    REQUIRE(tsmp::memory_footprint(std::string_view(long_name)) == sizeof(std::string_view));
+}
+
+TEST_CASE("memory_footprint nested container test", "[core][unit]")
+{
+    scene_t scene{1, {}, {}, {{1, "a"}, {2, std::string(50, 'b')}}, {1, 2, 3}};
+    scene.shapes.push_back({std::string(40, 'n'), {{1, 2}}, std::nullopt, {0, 0}});
+    scene.shapes.shrink_to_fit();
+
+    const auto& shape = scene.shapes.front();
+    const auto shape_heap = shape.name.capacity() + 1 + shape.points.capacity() * sizeof(point_t);
+    const auto node = 2 * sizeof(void*);
+    const auto tags_heap = 2 * (sizeof(std::pair<const std::int32_t, std::string>) + node) + 51;
+    const auto history_heap = 3 * (sizeof(std::int64_t) + node);
+    REQUIRE(tsmp::memory_footprint(scene) == sizeof(scene_t) + sizeof(shape_t) + shape_heap + tags_heap + history_heap);
+}
+
+TEST_CASE("memory_footprint_report test", "[core][unit]")
+{
+    const shape_t shape{std::string(30, 'n'), std::vector<point_t>(4), std::nullopt, {1, 1}};
+    const auto report = tsmp::memory_footprint_report(shape);
+    REQUIRE(report.size() == 6);
+    REQUIRE(report[0] == tsmp::memory_footprint_entry_t{"name", sizeof(std::string), shape.name.capacity() + 1});
+    REQUIRE(report[1] == tsmp::memory_footprint_entry_t{"points", sizeof(std::vector<point_t>), 4 * sizeof(point_t)});
+    REQUIRE(report[2].field == "label");
+    REQUIRE(report[2].heap_bytes == 0);
+    REQUIRE(report[3] == tsmp::memory_footprint_entry_t{"origin", sizeof(point_t), 0});
+    REQUIRE(report[4] == tsmp::memory_footprint_entry_t{"origin.x", sizeof(double), 0});
+    REQUIRE(report[5].field == "origin.y");
+}
+
+TEST_CASE("memory_footprint parallel span test", "[core][unit]")
+{
+    std::vector<shape_t> shapes(20000);
+    std::size_t expected = shapes.size() * sizeof(shape_t);
+    for (std::size_t i = 0; i < shapes.size(); ++i) {
+        shapes[i].name = std::string(i % 64, 'n');
+        shapes[i].points.resize(i % 5);
+        expected += tsmp::memory_footprint(shapes[i]) - sizeof(shape_t);
+    }
+    const auto span = std::span<const shape_t>(shapes);
+    REQUIRE(tsmp::memory_footprint(span, 1) == expected);
+    REQUIRE(tsmp::memory_footprint(span, 4) == expected);
+    REQUIRE(tsmp::memory_footprint(std::span(shapes), 4) == expected);
+
+    const auto serial = tsmp::memory_footprint_report(span, 1);
+    const auto parallel = tsmp::memory_footprint_report(span, 4);
+    REQUIRE(serial == parallel);
+    REQUIRE(tsmp::memory_footprint_report(std::span(shapes), 4) == serial);
+    REQUIRE(serial[0].inline_bytes == shapes.size() * sizeof(std::string));
+    std::size_t total = 0;
+    for (const auto& entry : serial) {
+        if (entry.field.find('.') == std::string::npos) {
+            total += entry.total_bytes();
+        }
+    }
+    REQUIRE(total == expected);
+}
@@ -0,0 +1,154 @@
+#include "tsmp/json.hpp"
+#include "tsmp/msgpack.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <deque>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+template<class T>
+T roundtrip(const T& value)
+{
+    return tsmp::from_msgpack<T>(tsmp::to_msgpack(value));
+}
+
+std::vector<std::byte> bytes(std::initializer_list<int> values)
+{
+    std::vector<std::byte> result;
+    for (const auto value : values) {
+        result.push_back(static_cast<std::byte>(value));
+    }
+    return result;
+}
+
+std::vector<std::byte> bytes(const std::vector<std::uint8_t>& values)
+{
+    std::vector<std::byte> result;
+    for (const auto value : values) {
+        result.push_back(static_cast<std::byte>(value));
+    }
+    return result;
+}
+
+TEST_CASE("arithmetic msgpack test", "[core][unit]")
+{
+    REQUIRE(roundtrip(static_cast<std::int32_t>(-42)) == -42);
+    REQUIRE(roundtrip(static_cast<std::uint64_t>(0xdeadbeefcafe)) == 0xdeadbeefcafe);
+    REQUIRE(roundtrip(std::numeric_limits<std::int64_t>::min()) == std::numeric_limits<std::int64_t>::min());
+    REQUIRE(roundtrip(std::numeric_limits<std::uint64_t>::max()) == std::numeric_limits<std::uint64_t>::max());
+    REQUIRE(roundtrip(1337.5f) == 1337.5f);
+    REQUIRE(roundtrip(-0.25) == -0.25);
+    REQUIRE(roundtrip(true) == true);
+
+    // integers use the smallest possible representation
+    REQUIRE(tsmp::to_msgpack(std::uint64_t{7}) == bytes({0x07}));
+    REQUIRE(tsmp::to_msgpack(std::int32_t{-1}) == bytes({0xff}));
+    REQUIRE(tsmp::to_msgpack(std::int32_t{-33}) == bytes({0xd0, 0xdf}));
+    REQUIRE(tsmp::to_msgpack(std::uint32_t{300}) == bytes({0xcd, 0x01, 0x2c}));
+    REQUIRE(tsmp::to_msgpack(1.5f) == bytes({0xca, 0x3f, 0xc0, 0x00, 0x00}));
+    REQUIRE(tsmp::to_msgpack(false) == bytes({0xc2}));
+
+    REQUIRE(tsmp::from_msgpack<double>(tsmp::to_msgpack(42)) == 42.0);
+    REQUIRE_THROWS(tsmp::from_msgpack<std::uint8_t>(tsmp::to_msgpack(300)));
+    REQUIRE_THROWS(tsmp::from_msgpack<std::uint32_t>(tsmp::to_msgpack(-1)));
+    REQUIRE_THROWS(tsmp::from_msgpack<int>(tsmp::to_msgpack(1.5)));
+    REQUIRE(tsmp::try_from_msgpack<int>(bytes({0xcd, 0x01})) == std::nullopt);
+}
+
+enum class color_t
+{
+    red,
+    green,
+    blue
+};
+
+TEST_CASE("enum and string msgpack test", "[core][unit]")
+{
+    REQUIRE(roundtrip(color_t::green) == color_t::green);
+    REQUIRE(tsmp::to_msgpack(color_t::red) == bytes({0xa3, 'r', 'e', 'd'}));
+    REQUIRE_THROWS(tsmp::from_msgpack<color_t>(tsmp::to_msgpack(std::string("purple"))));
+
+    REQUIRE(roundtrip(std::string("Hello World!")) == "Hello World!");
+    REQUIRE(roundtrip(std::string(40, 'x')) == std::string(40, 'x'));
+    REQUIRE(roundtrip(std::string(70000, 'x')) == std::string(70000, 'x'));
+    REQUIRE(tsmp::to_msgpack(std::string(40, 'x')).size() == 42);
+    REQUIRE(roundtrip(tsmp::string_literal_t("abcd")) == tsmp::string_literal_t("abcd"));
+}
+
+TEST_CASE("container msgpack test", "[core][unit]")
+{
+    using variant = std::variant<int, std::string>;
+    REQUIRE(roundtrip(std::vector<int>{1, 2, 3}) == std::vector<int>{1, 2, 3});
+    REQUIRE(roundtrip(std::vector<int>(20, 5)) == std::vector<int>(20, 5));
+    REQUIRE(roundtrip(std::deque<std::string>{"a", "b"}) == std::deque<std::string>{"a", "b"});
+    REQUIRE(roundtrip(std::vector<bool>{true, false}) == std::vector<bool>{true, false});
+    REQUIRE(roundtrip(std::array<double, 2>{1.0, 2.0}) == std::array<double, 2>{1.0, 2.0});
+    REQUIRE_THROWS(tsmp::from_msgpack<std::array<double, 3>>(tsmp::to_msgpack(std::vector<double>{1.0, 2.0})));
+
+    REQUIRE(roundtrip(std::optional<int>(42)) == 42);
+    REQUIRE(roundtrip(std::optional<int>()) == std::nullopt);
+    REQUIRE(tsmp::to_msgpack(std::optional<int>()) == bytes({0xc0}));
+    REQUIRE(roundtrip(variant("test")) == variant("test"));
+    REQUIRE(roundtrip(variant(5)) == variant(5));
+}
+
+struct point_t
+{
+    float x;
+    float y;
+    auto operator<=>(const point_t&) const noexcept = default;
+};
+
+struct record_t
+{
+    std::uint64_t id;
+    std::string name;
+    color_t color;
+    std::vector<point_t> path;
+    std::optional<std::string> comment;
+    auto operator<=>(const record_t&) const noexcept = default;
+};
+
+TEST_CASE("struct msgpack test", "[core][unit]")
+{
+    const record_t record{42, "record", color_t::blue, {{1.0f, 2.0f}, {-3.5f, 4.0f}}, "comment"};
+    const auto encoded = tsmp::to_msgpack(record);
+    REQUIRE(tsmp::from_msgpack<record_t>(encoded) == record);
+
+    // the encoding matches the document model of the json encoding
+    const auto foreign = nlohmann::json::from_msgpack(reinterpret_cast<const std::uint8_t*>(encoded.data()),
+                                                      reinterpret_cast<const std::uint8_t*>(encoded.data()) +
+                                                          encoded.size());
+    REQUIRE(foreign == nlohmann::json::parse(tsmp::to_json(record)));
+
+    // foreign encoders may choose other representations and field orders
+    auto document = nlohmann::json::parse(
+        R"({"comment":null,"path":[{"y":2,"x":1.5}],"extra":[{"a":[1,2.5,"s"]},{}],"color":"red","name":"n","id":7})");
+    const auto decoded = tsmp::from_msgpack<record_t>(bytes(nlohmann::json::to_msgpack(document)));
+    REQUIRE(decoded == record_t{7, "n", color_t::red, {{1.5f, 2.0f}}, std::nullopt});
+
+    document.erase("name");
+    REQUIRE_THROWS(tsmp::from_msgpack<record_t>(bytes(nlohmann::json::to_msgpack(document))));
+
+    for (std::size_t size = 0; size < encoded.size(); ++size) {
+        REQUIRE(tsmp::try_from_msgpack<record_t>(std::span(encoded).first(size)) == std::nullopt);
+    }
+    auto trailing = encoded;
+    trailing.push_back(std::byte{0xc0});
+    REQUIRE_THROWS(tsmp::from_msgpack<record_t>(trailing));
+}
+
+TEST_CASE("validator msgpack test", "[core][unit]")
+{
+    constexpr const auto is_fourtytwo = [](auto number) { return number == 42; };
+    REQUIRE(tsmp::from_msgpack<int>(tsmp::to_msgpack(42), is_fourtytwo) == 42);
+    REQUIRE_THROWS(tsmp::from_msgpack<int>(tsmp::to_msgpack(43), is_fourtytwo));
+    REQUIRE(tsmp::try_from_msgpack<int>(tsmp::to_msgpack(43), is_fourtytwo) == std::nullopt);
+    const auto throwing = [](int) -> bool { throw std::runtime_error("invalid"); };
+    REQUIRE(tsmp::try_from_msgpack<int>(tsmp::to_msgpack(42), throwing) == std::nullopt);
+}
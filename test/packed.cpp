@@ -0,0 +1,127 @@
+#include "tsmp/packed.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+enum class direction_t
+{
+    north,
+    east,
+    south,
+    west
+};
+
+enum class level_t : std::uint8_t
+{
+    low = 10,
+    mid = 20,
+    high = 40
+};
+
+struct position_t
+{
+    std::uint16_t x;
+    std::uint16_t y;
+    bool operator==(const position_t&) const noexcept = default;
+};
+
+struct unit_t
+{
+    direction_t direction;
+    level_t level;
+    bool alive;
+    std::int32_t health;
+    std::optional<std::uint8_t> team;
+    position_t position;
+    bool operator==(const unit_t&) const noexcept = default;
+};
+
+struct wide_t
+{
+    std::uint64_t id;
+    double weight;
+    std::int8_t offset;
+    float ratio;
+    bool operator==(const wide_t&) const noexcept = default;
+};
+
+template<>
+struct tsmp::field_bounds_t<unit_t, "health">
+{
+    static constexpr std::int64_t min = -100;
+    static constexpr std::int64_t max = 400;
+};
+
+template<>
+struct tsmp::field_bounds_t<unit_t, "team">
+{
+    static constexpr std::int64_t min = 0;
+    static constexpr std::int64_t max = 15;
+};
+
+template<>
+struct tsmp::field_bounds_t<position_t, "x">
+{
+    static constexpr std::int64_t min = 0;
+    static constexpr std::int64_t max = 1023;
+};
+
+TEST_CASE("packed bit width test", "[core][unit]")
+{
+    // direction 2, level 2, alive 1, health 9, team 1 + 4, position 10 + 16
+    STATIC_REQUIRE(tsmp::packed<unit_t>::bits == 45);
+    STATIC_REQUIRE(sizeof(tsmp::packed<unit_t>) == 6);
+    STATIC_REQUIRE(tsmp::packed<wide_t>::bits == 64 + 64 + 8 + 32);
+    STATIC_REQUIRE(sizeof(tsmp::packed<wide_t>) == 21);
+}
+
+TEST_CASE("packed round trip test", "[core][unit]")
+{
+    const unit_t unit{direction_t::west, level_t::high, true, -100, 15, {1023, 65535}};
+    REQUIRE(tsmp::packed(unit).unpack() == unit);
+
+    const unit_t other{direction_t::north, level_t::low, false, 400, std::nullopt, {0, 0}};
+    REQUIRE(tsmp::packed(other).unpack() == other);
+    REQUIRE(tsmp::packed(other) != tsmp::packed(unit));
+
+    const wide_t wide{std::numeric_limits<std::uint64_t>::max(), -1.5, -128, 0.25f};
+    REQUIRE(tsmp::packed(wide).unpack() == wide);
+}
+
+TEST_CASE("packed domain test", "[core][unit]")
+{
+    unit_t unit{direction_t::east, level_t::mid, true, 0, std::nullopt, {0, 0}};
+    unit.health = 401;
+    REQUIRE_THROWS_AS(tsmp::packed(unit), std::out_of_range);
+    unit.health = -101;
+    REQUIRE_THROWS_AS(tsmp::packed(unit), std::out_of_range);
+    unit.health = 0;
+    unit.team = 16;
+    REQUIRE_THROWS_AS(tsmp::packed(unit), std::out_of_range);
+    unit.team = std::nullopt;
+    unit.level = static_cast<level_t>(30);
+    REQUIRE_THROWS_AS(tsmp::packed(unit), std::out_of_range);
+    unit.level = level_t::mid;
+    unit.direction = static_cast<direction_t>(4);
+    REQUIRE_THROWS_AS(tsmp::packed(unit), std::out_of_range);
+}
+
+TEST_CASE("packed array test", "[core][unit]")
+{
+    std::vector<unit_t> units;
+    for (std::uint16_t i = 0; i < 1000; ++i) {
+        units.push_back(unit_t{static_cast<direction_t>(i % 4),
+                               i % 3 == 0 ? level_t::low : level_t::high,
+                               i % 2 == 0,
+                               static_cast<std::int32_t>(i % 501) - 100,
+                               i % 5 == 0 ? std::nullopt : std::optional<std::uint8_t>(i % 16),
+                               {static_cast<std::uint16_t>(i % 1024), static_cast<std::uint16_t>(i * 61)}});
+    }
+    const auto packed = tsmp::pack(units);
+    REQUIRE(packed.size() == units.size());
+    REQUIRE(tsmp::unpack(packed) == units);
+}
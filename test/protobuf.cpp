@@ -0,0 +1,234 @@
+#include "tsmp/protobuf.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+
+std::vector<std::byte> bytes(std::initializer_list<int> values)
+{
+    std::vector<std::byte> result;
+    for (const auto value : values) {
+        result.push_back(static_cast<std::byte>(value));
+    }
+    return result;
+}
+
+enum class kind_t
+{
+    none,
+    simple,
+    negative = -2
+};
+
+struct scalar_t
+{
+    std::uint32_t a;
+    std::int64_t b;
+    bool flag;
+    float f;
+    double d;
+    kind_t kind;
+    std::string name;
+    auto operator<=>(const scalar_t&) const noexcept = default;
+};
+
+TEST_CASE("scalar protobuf test", "[core][unit]")
+{
+    // the well known example from the protobuf encoding documentation
+    REQUIRE(tsmp::to_protobuf(scalar_t{150, 0, false, 0.0f, 0.0, kind_t::none, ""}) == bytes({0x08, 0x96, 0x01}));
+    REQUIRE(tsmp::to_protobuf(scalar_t{0, -1, true, 0.0f, 0.0, kind_t::none, ""}) ==
+            bytes({0x10, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01, 0x18, 0x01}));
+    REQUIRE(tsmp::to_protobuf(scalar_t{0, 0, false, 1.0f, 0.0, kind_t::none, "testing"}) ==
+            bytes({0x25, 0x00, 0x00, 0x80, 0x3f, 0x3a, 0x07, 't', 'e', 's', 't', 'i', 'n', 'g'}));
+    // negative enum values are sign extended to ten bytes
+    REQUIRE(tsmp::to_protobuf(scalar_t{0, 0, false, 0.0f, 0.0, kind_t::negative, ""}).size() == 11);
+
+    const scalar_t value{42, -1337, true, 1.5f, -0.0, kind_t::negative, "name"};
+    REQUIRE(tsmp::from_protobuf<scalar_t>(tsmp::to_protobuf(value)) == value);
+    REQUIRE(tsmp::to_protobuf(scalar_t{}).empty());
+    REQUIRE(tsmp::from_protobuf<scalar_t>(std::vector<std::byte>{}) == scalar_t{});
+
+    // last value wins for repeated scalars
+    REQUIRE(tsmp::from_protobuf<scalar_t>(bytes({0x08, 0x01, 0x08, 0x02})).a == 2);
+
+    REQUIRE_THROWS(tsmp::from_protobuf<scalar_t>(bytes({0x08, 0x96})));
+    REQUIRE_THROWS(tsmp::from_protobuf<scalar_t>(bytes({0x0d, 0x00, 0x00, 0x00, 0x00})));
+    REQUIRE_THROWS(tsmp::from_protobuf<scalar_t>(bytes({0x08, 0x80, 0x80, 0x80, 0x80, 0x10})));
+    REQUIRE_THROWS(tsmp::from_protobuf<scalar_t>(bytes({0x00, 0x01})));
+    REQUIRE(tsmp::try_from_protobuf<scalar_t>(bytes({0x3a, 0x07, 't'})) == std::nullopt);
+}
+
+struct point_t
+{
+    float x;
+    float y;
+    auto operator<=>(const point_t&) const noexcept = default;
+};
+
+struct message_t
+{
+    std::vector<std::int32_t> values;
+    std::vector<double> weights;
+    std::deque<std::string> names;
+    std::vector<point_t> points;
+    std::optional<std::uint32_t> count;
+    point_t origin;
+    std::array<std::uint8_t, 3> rgb;
+    std::list<bool> flags;
+    auto operator<=>(const message_t&) const noexcept = default;
+};
+
+TEST_CASE("message protobuf test", "[core][unit]")
+{
+    const message_t message{{1, -2, 300},
+                            {0.5, 1.5},
+                            {"a", "bc"},
+                            {{1.0f, 2.0f}, {0.0f, -1.0f}},
+                            0,
+                            {3.0f, 4.0f},
+                            {1, 2, 3},
+                            {true, false}};
+    const auto encoded = tsmp::to_protobuf(message);
+    REQUIRE(tsmp::from_protobuf<message_t>(encoded) == message);
+
+    // packed repeated numbers, explicit presence of optional values, nested messages are always present
+    message_t sparse{};
+    sparse.values = {3, 270};
+    REQUIRE(tsmp::to_protobuf(sparse) ==
+            bytes({0x0a, 0x03, 0x03, 0x8e, 0x02, 0x32, 0x00, 0x3a, 0x03, 0x00, 0x00, 0x00}));
+    sparse.values.clear();
+    sparse.count = 0;
+    REQUIRE(tsmp::to_protobuf(sparse) == bytes({0x28, 0x00, 0x32, 0x00, 0x3a, 0x03, 0x00, 0x00, 0x00}));
+
+    // unpacked encodings of packable fields are accepted as well
+    REQUIRE(tsmp::from_protobuf<message_t>(bytes({0x08, 0x03, 0x08, 0x8e, 0x02})).values ==
+            std::vector<std::int32_t>{3, 270});
+    REQUIRE_THROWS(tsmp::from_protobuf<message_t>(bytes({0x3a, 0x02, 0x01, 0x02})));
+    REQUIRE_THROWS(tsmp::from_protobuf<message_t>(bytes({0x12, 0x03, 0x00, 0x00, 0x00})));
+
+    for (std::size_t size = 1; size < encoded.size(); ++size) {
+        const auto truncated = tsmp::try_from_protobuf<message_t>(std::span(encoded).first(size));
+        REQUIRE((!truncated || *truncated != message));
+    }
+}
+
+struct renumbered_t
+{
+    std::string name;
+    std::uint32_t id;
+    auto operator<=>(const renumbered_t&) const noexcept = default;
+};
+
+template<>
+struct tsmp::protobuf_field_numbers_t<renumbered_t>
+{
+    static constexpr std::array<std::uint32_t, 2> value{7, 1000};
+};
+
+TEST_CASE("unknown fields and field numbers protobuf test", "[core][unit]")
+{
+    REQUIRE(tsmp::to_protobuf(renumbered_t{"x", 1}) == bytes({0x3a, 0x01, 'x', 0xc0, 0x3e, 0x01}));
+
+    // varint, fixed64, length delimited, group and fixed32 fields of unknown numbers are skipped
+    const auto decoded = tsmp::from_protobuf<renumbered_t>(
+        bytes({0x08, 0xff, 0xff, 0x01, 0x3a, 0x01, 'x', 0x11, 0, 0, 0, 0, 0, 0, 0, 0, 0x1a, 0x02, 0x01, 0x02,
+               0x23, 0x08, 0x01, 0x2b, 0x2c, 0x24, 0x2d, 0, 0, 0, 0, 0xc0, 0x3e, 0x05}));
+    REQUIRE(decoded == renumbered_t{"x", 5});
+
+    REQUIRE_THROWS(tsmp::from_protobuf<renumbered_t>(bytes({0x23, 0x08, 0x01, 0x2c})));
+    REQUIRE_THROWS(tsmp::from_protobuf<renumbered_t>(bytes({0x0e, 0x01})));
+    REQUIRE_THROWS(tsmp::from_protobuf<renumbered_t>(bytes({0x1a, 0x05, 0x01})));
+
+    // messages with compatible numbering can read each other
+    const auto foreign = tsmp::to_protobuf(scalar_t{3, 0, false, 0.0f, 0.0, kind_t::none, "shared"});
+    REQUIRE(tsmp::from_protobuf<renumbered_t>(foreign) == renumbered_t{"shared", 0});
+}
+
+struct encoded_t
+{
+    std::int32_t plain;
+    std::int32_t zigzag;
+    std::int32_t sfixed;
+    std::uint64_t fixed;
+    std::vector<std::int32_t> zigzag_values;
+    std::optional<std::int64_t> sfixed_value;
+    auto operator<=>(const encoded_t&) const noexcept = default;
+};
+
+template<>
+struct tsmp::protobuf_field_encodings_t<encoded_t>
+{
+    static constexpr std::array<protobuf_encoding_t, 6> value{protobuf_encoding_t::standard,
+                                                              protobuf_encoding_t::zigzag,
+                                                              protobuf_encoding_t::fixed,
+                                                              protobuf_encoding_t::fixed,
+                                                              protobuf_encoding_t::zigzag,
+                                                              protobuf_encoding_t::fixed};
+};
+
+TEST_CASE("field encodings protobuf test", "[core][unit]")
+{
+    // int32 = -2 as encoded by the protobuf reference implementation
+    REQUIRE(tsmp::to_protobuf(encoded_t{-2, 0, 0, 0, {}, std::nullopt}) ==
+            bytes({0x08, 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01}));
+    REQUIRE(tsmp::from_protobuf<encoded_t>(bytes({0x08, 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01}))
+                .plain == -2);
+    REQUIRE(tsmp::from_protobuf<encoded_t>(bytes({0x08, 0x96, 0x01})).plain == 150);
+    REQUIRE_THROWS(tsmp::from_protobuf<encoded_t>(bytes({0x08, 0x80, 0x80, 0x80, 0x80, 0x10})));
+
+    // sint32, sfixed32, fixed64, packed sint32 and sfixed64
+    REQUIRE(tsmp::to_protobuf(encoded_t{0, -2, -2, 1, {-1, 1}, -1}) ==
+            bytes({0x10, 0x03, 0x1d, 0xfe, 0xff, 0xff, 0xff, 0x21, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                   0x2a, 0x02, 0x01, 0x02, 0x31, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}));
+
+    const encoded_t value{std::numeric_limits<std::int32_t>::min(),
+                          std::numeric_limits<std::int32_t>::max(),
+                          std::numeric_limits<std::int32_t>::min(),
+                          std::numeric_limits<std::uint64_t>::max(),
+                          {3, -300, 0},
+                          0};
+    REQUIRE(tsmp::from_protobuf<encoded_t>(tsmp::to_protobuf(value)) == value);
+    REQUIRE_THROWS(tsmp::from_protobuf<encoded_t>(bytes({0x1d, 0xfe, 0xff})));
+}
+
+struct tree_t
+{
+    std::vector<point_t> points;
+    std::optional<message_t> message;
+    renumbered_t leaf;
+    auto operator<=>(const tree_t&) const noexcept = default;
+};
+
+struct forest_t
+{
+    std::vector<tree_t> trees;
+    tree_t root;
+    auto operator<=>(const forest_t&) const noexcept = default;
+};
+
+TEST_CASE("nested messages protobuf test", "[core][unit]")
+{
+    message_t message{};
+    message.points = {{1.0f, 2.0f}};
+    message.names = {"a"};
+    const tree_t tree{{{1.0f, 0.0f}, {0.0f, 1.0f}}, message, {"leaf", 3}};
+    const forest_t forest{{tree, tree_t{}, tree}, tree};
+    REQUIRE(tsmp::from_protobuf<forest_t>(tsmp::to_protobuf(forest)) == forest);
+
+    // the size prefixes of the nested messages are taken from the precomputed sizes in order
+    REQUIRE(tsmp::to_protobuf(forest_t{{tree_t{{{1.0f, 0.0f}}, std::nullopt, {"", 0}}}, tree_t{}}) ==
+            bytes({0x0a, 0x09, 0x0a, 0x05, 0x0d, 0x00, 0x00, 0x80, 0x3f, 0x1a, 0x00, 0x12, 0x02, 0x1a, 0x00}));
+}
+
+TEST_CASE("validator protobuf test", "[core][unit]")
+{
+    constexpr const auto has_name = [](const renumbered_t& value) { return !value.name.empty(); };
+    REQUIRE(tsmp::from_protobuf<renumbered_t>(tsmp::to_protobuf(renumbered_t{"x", 1}), has_name).name == "x");
+    REQUIRE_THROWS(tsmp::from_protobuf<renumbered_t>(tsmp::to_protobuf(renumbered_t{"", 1}), has_name));
+    REQUIRE(tsmp::try_from_protobuf<renumbered_t>(tsmp::to_protobuf(renumbered_t{"", 1}), has_name) == std::nullopt);
+}
@@ -0,0 +1,147 @@
+#include "tsmp/query.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+enum class job_status_t
+{
+    succeeded,
+    failed,
+    cancelled
+};
+
+struct job_t
+{
+    std::uint32_t id;
+    std::string region;
+    job_status_t status;
+    double latency;
+    std::int32_t retries;
+};
+
+namespace {
+
+// large enough inputs to be split into morsels for several threads
+std::vector<job_t> make_jobs(std::uint32_t size)
+{
+    const std::string regions[] = {"eu", "us", "ap"};
+    std::vector<job_t> jobs;
+    for (std::uint32_t i = 0; i < size; ++i) {
+        jobs.push_back(job_t{i,
+                             regions[i % 3],
+                             i % 5 == 0 ? job_status_t::failed : job_status_t::succeeded,
+                             static_cast<double>(i % 100),
+                             static_cast<std::int32_t>(i % 4)});
+    }
+    return jobs;
+}
+
+}
+
+TEST_CASE("query select test", "[core][unit]")
+{
+    const std::vector<job_t> jobs{{1, "eu", job_status_t::failed, 20.0, 0},
+                                  {2, "us", job_status_t::succeeded, 80.0, 1},
+                                  {3, "us", job_status_t::failed, 60.0, 2},
+                                  {4, "ap", job_status_t::failed, 90.0, 0},
+                                  {5, "us", job_status_t::failed, 10.0, 3},
+                                  {6, "eu", job_status_t::cancelled, 70.0, 1}};
+    const auto failed = tsmp::query<job_t>().where<"status">(tsmp::kernels::equal_to{job_status_t::failed});
+    REQUIRE(failed.count(jobs) == 4);
+
+    const auto selected = failed.where<"latency">(tsmp::kernels::greater{50.0}).select(jobs);
+    REQUIRE(selected.size() == 2);
+    REQUIRE(selected.front().id == 3);
+    REQUIRE(selected.back().id == 4);
+
+    const auto in_us = failed.where([](const job_t& job) { return job.region == "us"; });
+    const auto projected = in_us.project<"id", "retries">(jobs);
+    REQUIRE(projected.size() == 2);
+    REQUIRE(projected[0] == std::tuple<std::uint32_t, std::int32_t>{3, 2});
+    REQUIRE(projected[1] == std::tuple<std::uint32_t, std::int32_t>{5, 3});
+}
+
+TEST_CASE("query aggregate test", "[core][unit]")
+{
+    const std::vector<job_t> jobs{{1, "eu", job_status_t::failed, 20.0, 0},
+                                  {2, "us", job_status_t::succeeded, 80.0, 1},
+                                  {3, "us", job_status_t::failed, 60.0, 2},
+                                  {4, "ap", job_status_t::failed, 90.0, 0},
+                                  {5, "us", job_status_t::failed, 10.0, 3},
+                                  {6, "eu", job_status_t::cancelled, 70.0, 1}};
+    const auto [count, sum, average, minimum, maximum] =
+        tsmp::query<job_t>()
+            .where<"retries">(tsmp::kernels::equal_to{0})
+            .aggregate(jobs,
+                       tsmp::count_of{},
+                       tsmp::sum_of<"id">{},
+                       tsmp::avg_of<"latency">{},
+                       tsmp::min_of<"id">{},
+                       tsmp::max_of<"region">{});
+    REQUIRE(count == 2);
+    REQUIRE(sum == 5);
+    REQUIRE(average == 55);
+    REQUIRE(minimum == 1u);
+    REQUIRE(maximum == std::string("eu"));
+
+    const auto [empty_count, empty_average, empty_minimum] =
+        tsmp::query<job_t>()
+            .where<"retries">(tsmp::kernels::greater{10})
+            .aggregate(jobs, tsmp::count_of{}, tsmp::avg_of<"latency">{}, tsmp::min_of<"latency">{});
+    REQUIRE(empty_count == 0);
+    REQUIRE(std::isnan(empty_average));
+    REQUIRE(!empty_minimum);
+}
+
+TEST_CASE("query group_by test", "[core][unit]")
+{
+    const auto jobs = make_jobs(90000);
+    for (const std::size_t threads : {1, 4}) {
+        const auto groups = tsmp::query<job_t>()
+                                .where<"status">(tsmp::kernels::equal_to{job_status_t::failed})
+                                .threads(threads)
+                                .group_by<"region">()
+                                .aggregate(jobs, tsmp::count_of{}, tsmp::avg_of<"latency">{}, tsmp::max_of<"id">{});
+        REQUIRE(groups.size() == 3);
+        REQUIRE(std::get<0>(groups[0]) == "ap");
+        REQUIRE(std::get<0>(groups[1]) == "eu");
+        REQUIRE(std::get<0>(groups[2]) == "us");
+        REQUIRE(std::get<1>(groups[0]) + std::get<1>(groups[1]) + std::get<1>(groups[2]) == 18000);
+        REQUIRE(std::get<1>(groups[1]) == 6000);
+        REQUIRE(std::get<2>(groups[1]) == 47.5);
+        REQUIRE(std::get<3>(groups[1]) == 89985u);
+
+        const auto retries = tsmp::query<job_t>()
+                                 .threads(threads)
+                                 .group_by<"region", "retries">()
+                                 .aggregate(jobs, tsmp::count_of{}, tsmp::sum_of<"latency">{});
+        REQUIRE(retries.size() == 12);
+        REQUIRE(std::get<0>(retries[4]) == "eu");
+        REQUIRE(std::get<1>(retries[4]) == 0);
+        REQUIRE(std::get<2>(retries[4]) == 7500);
+
+        const auto selected =
+            tsmp::query<job_t>().threads(threads).where<"latency">(tsmp::kernels::equal_to{7.0}).select(jobs);
+        REQUIRE(selected.size() == 900);
+        REQUIRE(std::is_sorted(selected.begin(), selected.end(), [](const job_t& lhs, const job_t& rhs) {
+            return lhs.id < rhs.id;
+        }));
+    }
+}
+
+TEST_CASE("query exception test", "[core][unit]")
+{
+    const auto jobs = make_jobs(50000);
+    const auto failing = tsmp::query<job_t>().threads(4).where([](const job_t& job) {
+        if (job.id == 40000) {
+            throw std::runtime_error("predicate failed");
+        }
+        return true;
+    });
+    REQUIRE_THROWS_AS(failing.count(jobs), std::runtime_error);
+}
@@ -0,0 +1,94 @@
+#include "tsmp/schema_hash.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+enum class color_t
+{
+    red,
+    green,
+    blue
+};
+
+enum class shade_t
+{
+    red,
+    green,
+    blue
+};
+
+enum class reordered_t
+{
+    green,
+    red,
+    blue
+};
+
+struct point_t
+{
+    float x;
+    float y;
+};
+
+struct line_t
+{
+    point_t from;
+    point_t to;
+    color_t color;
+};
+
+struct node_t
+{
+    int value;
+    std::vector<node_t> children;
+};
+
+TEST_CASE("scalar schema hash test", "[core][unit]")
+{
+    STATIC_REQUIRE(tsmp::schema_hash<std::int32_t> != tsmp::schema_hash<std::uint32_t>);
+    STATIC_REQUIRE(tsmp::schema_hash<std::int32_t> != tsmp::schema_hash<std::int64_t>);
+    STATIC_REQUIRE(tsmp::schema_hash<std::uint32_t> != tsmp::schema_hash<float>);
+    STATIC_REQUIRE(tsmp::schema_hash<bool> != tsmp::schema_hash<std::uint8_t>);
+    STATIC_REQUIRE(tsmp::schema_hash<std::string> != tsmp::schema_hash<tsmp::string_literal_t<4>>);
+    STATIC_REQUIRE(tsmp::schema_hash<tsmp::string_literal_t<4>> != tsmp::schema_hash<tsmp::string_literal_t<5>>);
+    STATIC_REQUIRE(tsmp::schema_hash<std::optional<int>> != tsmp::schema_hash<int>);
+    STATIC_REQUIRE(tsmp::schema_hash<std::variant<int, float>> != tsmp::schema_hash<std::variant<float, int>>);
+}
+
+TEST_CASE("enum schema hash test", "[core][unit]")
+{
+    // enumerations are described by their entries, so identical enumerations are compatible
+    STATIC_REQUIRE(tsmp::schema_hash<color_t> == tsmp::schema_hash<shade_t>);
+    STATIC_REQUIRE(tsmp::schema_hash<color_t> != tsmp::schema_hash<reordered_t>);
+    STATIC_REQUIRE(tsmp::schema_hash<color_t> != tsmp::schema_hash<int>);
+}
+
+TEST_CASE("range schema hash test", "[core][unit]")
+{
+    STATIC_REQUIRE(tsmp::schema_hash<std::vector<int>> == tsmp::schema_hash<std::deque<int>>);
+    STATIC_REQUIRE(tsmp::schema_hash<std::vector<int>> == tsmp::schema_hash<std::list<int>>);
+    STATIC_REQUIRE(tsmp::schema_hash<std::vector<int>> != tsmp::schema_hash<std::vector<unsigned>>);
+    STATIC_REQUIRE(tsmp::schema_hash<std::vector<int>> != tsmp::schema_hash<std::array<int, 2>>);
+    STATIC_REQUIRE(tsmp::schema_hash<std::array<int, 2>> != tsmp::schema_hash<std::array<int, 3>>);
+}
+
+TEST_CASE("record schema hash test", "[core][unit]")
+{
+    constexpr auto hash = tsmp::schema_hash<line_t>;
+    STATIC_REQUIRE(hash == tsmp::schema_hash<const line_t>);
+    STATIC_REQUIRE(hash != tsmp::schema_hash<point_t>);
+    STATIC_REQUIRE(tsmp::schema_hash<point_t> != tsmp::schema_hash<std::vector<point_t>>);
+    STATIC_REQUIRE(tsmp::schema_hash<node_t> != tsmp::schema_hash<std::vector<node_t>>);
+    STATIC_REQUIRE(tsmp::schema_hash<node_t> != tsmp::schema_hash<int>);
+
+    // the hash is usable at runtime as well, e.g. as a file header
+    const std::uint64_t header = tsmp::schema_hash<line_t>;
+    REQUIRE(header == hash);
+}
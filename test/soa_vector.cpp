@@ -0,0 +1,151 @@
+#include "tsmp/soa_vector.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct sample_t
+{
+    std::uint32_t id;
+    double latency;
+    bool failed;
+    std::string host;
+    auto operator<=>(const sample_t&) const noexcept = default;
+};
+
+TEST_CASE("soa_vector element access test", "[core][unit]")
+{
+    tsmp::soa_vector<sample_t> samples;
+    REQUIRE(samples.empty());
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        samples.push_back(sample_t{i, i * 0.5, i % 3 == 0, "host" + std::to_string(i % 4)});
+    }
+    REQUIRE(samples.size() == 100);
+    REQUIRE(samples.capacity() >= 100);
+
+    REQUIRE(static_cast<sample_t>(samples[3]) == sample_t{3, 1.5, true, "host3"});
+    REQUIRE(samples[7].get<"host">() == "host3");
+    REQUIRE(samples.back().get<"id">() == 99);
+
+    // references behave like T&, writes go through to the columns
+    samples[5].get<"latency">() = 42.0;
+    REQUIRE(samples.column<"latency">()[5] == 42.0);
+    samples[6] = sample_t{1000, 1.0, false, "replaced"};
+    REQUIRE(samples.column<"host">()[6] == "replaced");
+    samples[7] = samples[6];
+    REQUIRE(static_cast<sample_t>(samples[7]) == sample_t{1000, 1.0, false, "replaced"});
+    swap(samples[0], samples[1]);
+    REQUIRE(samples[0].get<"id">() == 1);
+    REQUIRE(samples[1].get<"id">() == 0);
+
+    REQUIRE_THROWS_AS(samples.at(100), std::out_of_range);
+    samples.pop_back();
+    REQUIRE(samples.size() == 99);
+
+    const auto& view = samples;
+    const sample_t copy = view.front();
+    REQUIRE(copy.id == 1);
+    REQUIRE(view.column<"failed">().size() == 99);
+}
+
+TEST_CASE("soa_vector column test", "[core][unit]")
+{
+    tsmp::soa_vector<sample_t> samples;
+    samples.reserve(10);
+    for (std::uint32_t i = 0; i < 10; ++i) {
+        samples.push_back(sample_t{i, 1.0, i % 2 == 0, ""});
+    }
+
+    // columns are contiguous spans, even for bool
+    const auto latency = samples.column<"latency">();
+    REQUIRE(std::accumulate(latency.begin(), latency.end(), 0.0) == 10.0);
+    const std::span<bool> failed = samples.column<"failed">();
+    REQUIRE(std::ranges::count(failed, true) == 5);
+    REQUIRE(samples.column<0>().data() + 9 == &samples[9].get<"id">());
+
+    std::size_t visited = 0;
+    for (const sample_t sample : samples) {
+        REQUIRE(sample.id == visited++);
+    }
+    REQUIRE(visited == 10);
+    REQUIRE(samples.end() - samples.begin() == 10);
+    REQUIRE((*(samples.begin() + 4)).get<"id">() == 4);
+}
+
+TEST_CASE("soa_vector copy and move test", "[core][unit]")
+{
+    tsmp::soa_vector<sample_t> samples;
+    for (std::uint32_t i = 0; i < 20; ++i) {
+        samples.push_back(sample_t{i, 0.0, false, std::string(30, static_cast<char>('a' + i))});
+    }
+    auto copy = samples;
+    REQUIRE(copy.size() == 20);
+    REQUIRE(copy[19].get<"host">() == samples[19].get<"host">());
+    copy[0].get<"host">() = "changed";
+    REQUIRE(samples[0].get<"host">() == std::string(30, 'a'));
+
+    auto moved = std::move(copy);
+    REQUIRE(moved.size() == 20);
+    REQUIRE(moved[0].get<"host">() == "changed");
+    samples = moved;
+    REQUIRE(samples[0].get<"host">() == "changed");
+    samples.clear();
+    REQUIRE(samples.empty());
+}
+
+struct fragile_t
+{
+    static inline int alive = 0;
+    static inline int copies_left = -1;
+
+    fragile_t() { ++alive; }
+    fragile_t(const fragile_t&)
+    {
+        if (copies_left-- == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        ++alive;
+    }
+    fragile_t(fragile_t&& other)
+        : fragile_t(other)
+    {
+    }
+    fragile_t& operator=(const fragile_t&) = default;
+    ~fragile_t() { --alive; }
+};
+
+struct guarded_t
+{
+    std::string name;
+    fragile_t fragile;
+};
+
+TEST_CASE("soa_vector exception safety test", "[core][unit]")
+{
+    {
+        tsmp::soa_vector<guarded_t> guarded;
+        for (int i = 0; i < 8; ++i) {
+            guarded.push_back(guarded_t{std::string(40, 'x'), {}});
+        }
+        REQUIRE(fragile_t::alive == 8);
+
+        // the names copied before the failing fragile column are destroyed again, which the sanitizers check
+        fragile_t::copies_left = 3;
+        REQUIRE_THROWS_AS(tsmp::soa_vector<guarded_t>(guarded), std::runtime_error);
+        REQUIRE(fragile_t::alive == 8);
+
+        // elements with a throwing move constructor are copied when growing, so a failure leaves the vector intact
+        fragile_t::copies_left = 5;
+        REQUIRE_THROWS_AS(guarded.reserve(100), std::runtime_error);
+        fragile_t::copies_left = -1;
+        REQUIRE(guarded.size() == 8);
+        REQUIRE(guarded.capacity() == 8);
+        REQUIRE(guarded[7].get<"name">() == std::string(40, 'x'));
+        REQUIRE(fragile_t::alive == 8);
+    }
+    REQUIRE(fragile_t::alive == 0);
+}
@@ -0,0 +1,128 @@
+#include "tsmp/sort.hpp"
+#include <algorithm>
+#include <array>
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+enum class side_t
+{
+    sell = 2,
+    buy = 1,
+    unknown = 7
+};
+
+struct order_t
+{
+    std::int64_t ts;
+    std::uint32_t id;
+    double price;
+    side_t side;
+    std::int16_t quantity;
+    std::string trader;
+    bool operator==(const order_t&) const noexcept = default;
+};
+
+namespace {
+
+std::size_t side_position(side_t side)
+{
+    return static_cast<std::size_t>(std::ranges::find(tsmp::enum_values<side_t>, side) -
+                                    tsmp::enum_values<side_t>.begin());
+}
+
+// the radix sort only kicks in for a few hundred records, so the tests need generated input
+std::vector<order_t> make_orders(std::size_t size)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::int64_t> ts(-50, 50);
+    std::uniform_int_distribution<std::uint32_t> id(0, 100000);
+    std::uniform_real_distribution<double> price(-1000, 1000);
+    std::uniform_int_distribution<int> small(0, 2);
+    std::uniform_int_distribution<int> quantity(-3000, 3000);
+    std::vector<order_t> orders;
+    for (std::size_t i = 0; i < size; ++i) {
+        orders.push_back(order_t{ts(random),
+                                 id(random),
+                                 price(random),
+                                 tsmp::enum_values<side_t>[static_cast<std::size_t>(small(random))],
+                                 static_cast<std::int16_t>(quantity(random)),
+                                 std::string(1, static_cast<char>('a' + small(random)))});
+    }
+    return orders;
+}
+
+}
+
+TEST_CASE("sort_by single field test", "[core][unit]")
+{
+    for (const auto size : {std::size_t{10}, std::size_t{5000}}) {
+        auto orders = make_orders(size);
+        orders.front().price = std::numeric_limits<double>::lowest();
+        orders.back().price = -0.5;
+
+        auto expected = orders;
+        std::ranges::stable_sort(expected, {}, &order_t::price);
+        tsmp::sort_by<"price">(orders);
+        REQUIRE(orders == expected);
+
+        std::ranges::stable_sort(expected, {}, &order_t::quantity);
+        tsmp::sort_by<"quantity">(orders);
+        REQUIRE(orders == expected);
+
+        std::ranges::stable_sort(expected, {}, [](const order_t& order) { return side_position(order.side); });
+        tsmp::sort_by<"side">(orders);
+        REQUIRE(orders == expected);
+    }
+}
+
+TEST_CASE("sort_by multiple fields test", "[core][unit]")
+{
+    for (const auto size : {std::size_t{100}, std::size_t{10000}}) {
+        auto orders = make_orders(size);
+        auto expected = orders;
+        std::ranges::stable_sort(expected, {}, [](const order_t& order) { return std::tuple(order.ts, order.id); });
+        tsmp::sort_by<"ts", "id">(orders);
+        REQUIRE(orders == expected);
+
+        std::ranges::stable_sort(expected, {}, [](const order_t& order) {
+            return std::tuple(side_position(order.side), order.ts);
+        });
+        tsmp::sort_by<"side", "ts">(orders);
+        REQUIRE(orders == expected);
+
+        // both keys fit into one radix key
+        std::ranges::stable_sort(expected, {}, [](const order_t& order) {
+            return std::tuple(side_position(order.side), order.quantity);
+        });
+        tsmp::sort_by<"side", "quantity">(orders);
+        REQUIRE(orders == expected);
+    }
+}
+
+TEST_CASE("sort_by string field test", "[core][unit]")
+{
+    std::vector<order_t> orders{{3, 1, 1.5, side_t::buy, 10, "bob"},
+                                {-1, 2, 2.5, side_t::sell, -10, "alice"},
+                                {2, 3, 0.5, side_t::buy, 5, "bob"},
+                                {2, 4, 0.5, side_t::unknown, 5, ""},
+                                {-1, 5, 3.5, side_t::sell, 0, "alice"}};
+    tsmp::sort_by<"trader", "ts">(orders);
+    REQUIRE(std::ranges::equal(orders, std::vector<std::uint32_t>{4, 2, 5, 3, 1}, {}, &order_t::id));
+}
+
+TEST_CASE("sort_by range test", "[core][unit]")
+{
+    auto orders = make_orders(1000);
+    auto expected = orders;
+    std::stable_sort(expected.begin() + 100, expected.end(), [](const order_t& lhs, const order_t& rhs) {
+        return lhs.id < rhs.id;
+    });
+    tsmp::sort_by<"id">(std::ranges::subrange(orders.begin() + 100, orders.end()));
+    REQUIRE(orders == expected);
+}
@@ -0,0 +1,107 @@
+#include "tsmp/sqlite.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+enum class side_t
+{
+    buy,
+    sell
+};
+
+struct fill_t
+{
+    std::int64_t id;
+    std::uint32_t quantity;
+    double price;
+    bool settled;
+    side_t side;
+    std::string venue;
+    std::optional<std::string> note;
+
+    bool operator==(const fill_t&) const = default;
+};
+
+struct wide_t
+{
+    std::uint64_t value;
+};
+
+TEST_CASE("sqlite statement test", "[core][unit]")
+{
+    REQUIRE(tsmp::sqlite_create_table_sql<fill_t>("fills") ==
+            "CREATE TABLE IF NOT EXISTS \"fills\" (\"id\" INTEGER NOT NULL, \"quantity\" INTEGER NOT NULL, \"price\" "
+            "REAL NOT NULL, \"settled\" INTEGER NOT NULL, \"side\" TEXT NOT NULL, \"venue\" TEXT NOT NULL, \"note\" "
+            "TEXT)");
+    REQUIRE(tsmp::sqlite_insert_sql<fill_t>("fills") ==
+            "INSERT INTO \"fills\" (\"id\", \"quantity\", \"price\", \"settled\", \"side\", \"venue\", \"note\") "
+            "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)");
+    REQUIRE(tsmp::sqlite_select_sql<fill_t>("my \"fills\"") ==
+            "SELECT \"id\", \"quantity\", \"price\", \"settled\", \"side\", \"venue\", \"note\" FROM "
+            "\"my \"\"fills\"\"\"");
+}
+
+TEST_CASE("sqlite round trip test", "[core][unit]")
+{
+    tsmp::sqlite_database database(":memory:");
+    tsmp::sqlite_table<fill_t> fills(database, "fills");
+    fills.create();
+
+    const fill_t first{1, 100, 9.5, true, side_t::sell, "XNAS", "partial"};
+    fills.insert(first);
+    REQUIRE(fills.select() == std::vector<fill_t>{first});
+
+    std::vector<fill_t> input;
+    for (std::int64_t i = 2; i < 1000; ++i) {
+        input.push_back({i,
+                         static_cast<std::uint32_t>(i * 3),
+                         static_cast<double>(i) / 4,
+                         i % 2 == 0,
+                         i % 3 == 0 ? side_t::buy : side_t::sell,
+                         "V" + std::to_string(i % 5),
+                         i % 7 == 0 ? std::optional<std::string>() : std::to_string(i)});
+    }
+    fills.insert(input, 100);
+    REQUIRE(!database.in_transaction());
+
+    const auto output = fills.select();
+    REQUIRE(output.size() == 999);
+    REQUIRE(output.front() == first);
+    REQUIRE(std::vector<fill_t>(output.begin() + 1, output.end()) == input);
+}
+
+TEST_CASE("sqlite transaction test", "[core][unit]")
+{
+    tsmp::sqlite_database database(":memory:");
+    tsmp::sqlite_table<fill_t> fills(database, "fills");
+    fills.create();
+
+    database.execute("BEGIN");
+    fills.insert(std::vector<fill_t>(10, fill_t{1, 2, 3, false, side_t::buy, "X", std::nullopt}));
+    REQUIRE(database.in_transaction());
+    database.execute("ROLLBACK");
+    REQUIRE(fills.select().empty());
+}
+
+TEST_CASE("sqlite rollback test", "[core][unit]")
+{
+    tsmp::sqlite_database database(":memory:");
+    tsmp::sqlite_table<wide_t> table(database, "wide");
+    table.create();
+
+    const std::vector<wide_t> input{{1}, {2}, {std::numeric_limits<std::uint64_t>::max()}};
+    REQUIRE_THROWS_AS(table.insert(input), std::out_of_range);
+    REQUIRE(!database.in_transaction());
+    REQUIRE(table.select().empty());
+
+    database.execute("INSERT INTO wide VALUES (-1)");
+    REQUIRE_THROWS_AS(table.select(), std::runtime_error);
+
+    tsmp::sqlite_table<wide_t> missing(database, "missing");
+    REQUIRE_THROWS_AS(missing.insert(wide_t{1}), std::runtime_error);
+}
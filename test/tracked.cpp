@@ -0,0 +1,91 @@
+#include "tsmp/binary.hpp"
+#include "tsmp/tracked.hpp"
+#include "tsmp/tracked_json.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct account_t
+{
+    std::uint64_t id;
+    std::string owner;
+    double balance;
+    std::vector<std::int32_t> history;
+};
+
+struct counters_t
+{
+    std::uint32_t sent;
+    std::uint32_t received;
+};
+
+TEST_CASE("tracked dirty field test", "[core][unit]")
+{
+    tsmp::tracked<account_t> account(account_t{1, "alice", 10.5, {1, 2}});
+    REQUIRE(account.dirty().all());
+    account.clear_dirty();
+    REQUIRE(account.dirty().none());
+
+    REQUIRE(std::as_const(account).get<"owner">() == "alice");
+    REQUIRE(account->balance == 10.5);
+    REQUIRE(account.dirty().none());
+
+    account.set<"balance">(20.0);
+    account.get<"history">().push_back(3);
+    REQUIRE(account.is_dirty<"balance">());
+    REQUIRE(account.is_dirty<"history">());
+    REQUIRE(!account.is_dirty<"owner">());
+    REQUIRE(account.dirty().count() == 2);
+    REQUIRE(account.value().history.size() == 3);
+
+    account.clear_dirty();
+    account.update([](account_t& value) { value.id = 2; });
+    REQUIRE(account.dirty().all());
+    REQUIRE(account->id == 2);
+}
+
+TEST_CASE("tracked incremental serialization test", "[core][unit]")
+{
+    tsmp::tracked<account_t> account(account_t{1, "alice", 10.5, {1, 2}});
+    std::size_t encoded = 0;
+    const auto encode = [&](std::size_t, std::string_view name, const auto&) {
+        ++encoded;
+        return std::string(name);
+    };
+    REQUIRE(account.encoded<std::string>(encode)[1] == "owner");
+    REQUIRE(encoded == 4);
+    (void)account.encoded<std::string>(encode);
+    REQUIRE(encoded == 4);
+    account.set<"owner">("bob");
+    (void)account.encoded<std::string>(encode);
+    REQUIRE(encoded == 5);
+}
+
+TEST_CASE("tracked serialization test", "[core][unit]")
+{
+    tsmp::tracked<account_t> account(account_t{1, "alice", 10.5, {1, 2}});
+    REQUIRE(tsmp::to_json(account) == tsmp::to_json(account.value()));
+    REQUIRE(tsmp::to_binary(account) == tsmp::to_binary(account.value()));
+
+    account.set<"owner">("bob");
+    account.get<"history">().clear();
+    REQUIRE(tsmp::to_json(account) == tsmp::to_json(account.value()));
+    REQUIRE(tsmp::to_json(account) == R"({"id":1,"owner":"bob","balance":10.5,"history":[]})");
+
+    const auto binary = tsmp::to_binary(account);
+    REQUIRE(binary == tsmp::to_binary(account.value()));
+    const auto decoded = tsmp::from_binary<account_t>(binary);
+    REQUIRE(decoded.owner == "bob");
+    REQUIRE(decoded.history.empty());
+
+    // records without padding are copied byte by byte by to_binary
+    tsmp::tracked<counters_t> counters(counters_t{300, 7});
+    REQUIRE(tsmp::to_binary(counters) == tsmp::to_binary(counters.value()));
+    REQUIRE(tsmp::to_binary(counters).size() == sizeof(counters_t));
+    counters.set<"received">(8);
+    REQUIRE(tsmp::from_binary<counters_t>(tsmp::to_binary(counters)).received == 8);
+}